@@ -0,0 +1,69 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+#ifndef __BOARD_DB_H__
+#define __BOARD_DB_H__
+
+#include <stddef.h>
+#include <string.h>
+
+struct board_db_entry {
+	unsigned int board_id;	/* socinfo board_id & 0xfff */
+	const char *soc;	/* matched against socinfo soc_name */
+	const char *pin_table;	/* board name in pins.json */
+	const char *type;	/* srpi-config board type, NULL if unsupported */
+	const char *dtb;
+	const char *config;	/* peripheral list for srpi-config */
+};
+
+static const struct board_db_entry board_db[] = {
+	{ 0x304, "x3", "X3SDBV3", NULL, NULL, NULL },
+	{ 0x404, "x3", "X3SDB", NULL, NULL, NULL },
+	{ 0x504, "x3", "X3PI", NULL, NULL, NULL },
+	{ 0x604, "x3", "X3PI", NULL, NULL, NULL },
+	{ 0x804, "x3", "X3PI_V2_1", NULL, NULL, NULL },
+	{ 0xb04, "x3", "X3CM", NULL, NULL, NULL },
+	{ 0x201, "x5", "EVB_X5", NULL, NULL, NULL },
+	{ 0x202, "x5", "EVB_X5", NULL, NULL, NULL },
+	{ 0x203, "x5", "EVB_X5", NULL, NULL, NULL },
+	{ 0x204, "x5", "EVB_X5", NULL, NULL, NULL },
+	{ 0x301, "x5", "RDK_X5", "x5_rdk", "x5-rdk.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x302, "x5", "RDK_X5", "x5_rdk", "x5-rdk-v1p0.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x501, "x5", "RDK_X5", "x5_md", "x5-md-v0p1.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x502, "x5", "RDK_X5", "x5_md", "x5-md-v0p2.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x503, "x5", "RDK_X5", "x5_md", "x5-md-v0p2.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x504, "x5", "RDK_X5", "x5_md", "x5-md-v0p2.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x505, "x5", "RDK_X5", "x5_md", "x5-md-v0p2.dtb", "/etc/hobot.conf/x5rdk.conf" },
+	{ 0x506, "x5", "RDK_X5", "x5_md", "x5-md-v1p2.dtb", "/etc/hobot.conf/x5rdk.conf" },
+};
+
+#define BOARD_DB_NUM (sizeof(board_db) / sizeof(board_db[0]))
+
+/* board ids are only unique within a soc, e.g. 0x504 is both X3PI and RDK_X5 */
+static inline const struct board_db_entry *board_db_find(const char *soc,
+							   unsigned int board_id)
+{
+	size_t i;
+
+	for (i = 0; i < BOARD_DB_NUM; i++) {
+		if (board_db[i].board_id == board_id &&
+		    strcmp(board_db[i].soc, soc) == 0)
+			return &board_db[i];
+	}
+	return NULL;
+}
+
+#endif /* __BOARD_DB_H__ */
@@ -0,0 +1,234 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "board_id.h"
+
+static const char *io_root(void)
+{
+	const char *root = getenv("HOBOT_IO_ROOT");
+
+	return root ? root : "";
+}
+
+static char *trim(char *s)
+{
+	char *end;
+
+	while (isspace((unsigned char)*s))
+		s++;
+	end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+		*--end = '\0';
+	return s;
+}
+
+static int read_line(const char *path, char *buf, size_t len)
+{
+	char full[PATH_MAX];
+	char *s;
+	FILE *fp;
+	int ret = 0;
+
+	snprintf(full, sizeof(full), "%s%s", io_root(), path);
+	fp = fopen(full, "r");
+	if (!fp)
+		return -errno;
+	if (!fgets(buf, len, fp))
+		ret = -EIO;
+	fclose(fp);
+	if (ret == 0) {
+		s = trim(buf);
+		memmove(buf, s, strlen(s) + 1);
+	}
+	return ret;
+}
+
+static void lookup(struct board_id *id)
+{
+	id->entry = board_db_find(id->soc, id->board_id);
+}
+
+static int read_socinfo(struct board_id *id)
+{
+	char buf[64];
+	int ret;
+
+	ret = read_line(BOARD_ID_SOCINFO_PATH "/board_id", buf, sizeof(buf));
+	if (ret < 0)
+		return ret;
+	id->board_id = strtoul(buf, NULL, 16) & 0xfff;
+
+	ret = read_line(BOARD_ID_SOCINFO_PATH "/soc_name", buf, sizeof(buf));
+	if (ret < 0)
+		return ret;
+	/* same rule as Hobot.GPIO: anything but an x5 is an x3 */
+	for (ret = 0; buf[ret]; ret++)
+		buf[ret] = tolower((unsigned char)buf[ret]);
+	snprintf(id->soc, sizeof(id->soc), "%s", strstr(buf, "x5") ? "x5" : "x3");
+	lookup(id);
+	return 0;
+}
+
+static int read_cache(struct board_id *id)
+{
+	char path[PATH_MAX], line[256];
+	char boot_id[BOARD_ID_BOOT_ID_LEN] = "";
+	char *value;
+	int have_id = 0, fd;
+	struct stat st;
+	FILE *fp;
+
+	snprintf(path, sizeof(path), "%s%s", io_root(), BOARD_ID_CACHE_PATH);
+	fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+	/*
+	 * srpi-config picks the dtb it flashes from this, only believe a file
+	 * that root (or whoever runs us) wrote and nobody else can change
+	 */
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+	    (st.st_uid != 0 && st.st_uid != geteuid()) ||
+	    (st.st_mode & (S_IWGRP | S_IWOTH))) {
+		close(fd);
+		return -EPERM;
+	}
+	fp = fdopen(fd, "r");
+	if (!fp) {
+		close(fd);
+		return -errno;
+	}
+	id->soc[0] = '\0';
+	while (fgets(line, sizeof(line), fp)) {
+		value = strchr(line, '=');
+		if (!value)
+			continue;
+		*value++ = '\0';
+		value = trim(value);
+		if (strcmp(line, "BOARD_BOOT_ID") == 0) {
+			snprintf(boot_id, sizeof(boot_id), "%s", value);
+		} else if (strcmp(line, "BOARD_ID") == 0) {
+			id->board_id = strtoul(value, NULL, 0);
+			have_id = 1;
+		} else if (strcmp(line, "BOARD_SOC") == 0) {
+			snprintf(id->soc, sizeof(id->soc), "%s", value);
+		}
+	}
+	fclose(fp);
+	if (!have_id || !id->soc[0] || strcmp(boot_id, id->boot_id) != 0)
+		return -ESTALE;
+	lookup(id);
+	return 0;
+}
+
+static void write_cache(const struct board_id *id)
+{
+	char path[PATH_MAX], tmp_path[PATH_MAX + 16];
+	FILE *fp;
+	int fd;
+
+	/*
+	 * a private file renamed into place, readers never see half of it.
+	 * mkstemp() creates it with O_EXCL, a planted symlink is not followed.
+	 */
+	snprintf(path, sizeof(path), "%s%s", io_root(), BOARD_ID_CACHE_PATH);
+	snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path);
+	fd = mkstemp(tmp_path);
+	if (fd < 0)
+		return;
+	fp = fdopen(fd, "w");
+	if (!fp || fchmod(fd, 0644) != 0) {
+		if (fp)
+			fclose(fp);
+		else
+			close(fd);
+		unlink(tmp_path);
+		return;
+	}
+	board_id_print_env(fp, id);
+	if (fclose(fp) != 0 || rename(tmp_path, path) != 0)
+		unlink(tmp_path);
+}
+
+int board_id_get(struct board_id *id, int refresh)
+{
+	int ret;
+
+	memset(id, 0, sizeof(*id));
+	/* without a boot id nothing tells a stale cache apart, skip it */
+	if (read_line(BOARD_ID_BOOT_ID_PATH, id->boot_id, sizeof(id->boot_id)) < 0)
+		id->boot_id[0] = '\0';
+	if (!refresh && id->boot_id[0] && read_cache(id) == 0)
+		return 0;
+
+	ret = read_socinfo(id);
+	if (ret < 0)
+		return ret;
+	if (id->boot_id[0])
+		write_cache(id);
+	return 0;
+}
+
+static const char *const fields[] = {
+	"id", "soc", "pin_table", "type", "dtb", "config",
+};
+
+const char *board_id_field(const struct board_id *id, const char *name,
+			   char *buf, size_t len)
+{
+	const struct board_db_entry *entry = id->entry;
+	const char *value = NULL;
+
+	if (strcmp(name, "id") == 0) {
+		snprintf(buf, len, "0x%x", id->board_id);
+		return buf;
+	}
+	if (strcmp(name, "soc") == 0)
+		return id->soc;
+	if (strcmp(name, "pin_table") == 0)
+		value = entry ? entry->pin_table : NULL;
+	else if (strcmp(name, "type") == 0)
+		value = entry ? entry->type : NULL;
+	else if (strcmp(name, "dtb") == 0)
+		value = entry ? entry->dtb : NULL;
+	else if (strcmp(name, "config") == 0)
+		value = entry ? entry->config : NULL;
+	else
+		return NULL;
+	return value ? value : "";
+}
+
+void board_id_print_env(FILE *fp, const struct board_id *id)
+{
+	char buf[16], upper[16];
+	size_t i, j;
+
+	fprintf(fp, "BOARD_BOOT_ID=%s\n", id->boot_id);
+	for (i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+		for (j = 0; fields[i][j] && j < sizeof(upper) - 1; j++)
+			upper[j] = toupper((unsigned char)fields[i][j]);
+		upper[j] = '\0';
+		fprintf(fp, "BOARD_%s=%s\n", upper,
+			board_id_field(id, fields[i], buf, sizeof(buf)));
+	}
+}
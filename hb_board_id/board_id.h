@@ -0,0 +1,57 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __BOARD_ID_H__
+#define __BOARD_ID_H__
+
+#include <stdio.h>
+
+#include "board_db.h"
+
+/*
+ * Board identity: socinfo is read once per boot, the result is kept in
+ * BOARD_ID_CACHE_PATH as KEY=value lines that srpi-config and Hobot.GPIO
+ * parse. The cache is trusted only for the boot that wrote it.
+ * Every path is relative to $HOBOT_IO_ROOT when that is set.
+ */
+
+#define BOARD_ID_SOCINFO_PATH	"/sys/class/socinfo"
+#define BOARD_ID_BOOT_ID_PATH	"/proc/sys/kernel/random/boot_id"
+#define BOARD_ID_CACHE_PATH	"/run/hobot-gpio/board.env"
+
+#define BOARD_ID_SOC_LEN	8
+#define BOARD_ID_BOOT_ID_LEN	40
+
+struct board_id {
+	unsigned int board_id;		/* socinfo board_id & 0xfff */
+	char soc[BOARD_ID_SOC_LEN];	/* "x3" or "x5" */
+	char boot_id[BOARD_ID_BOOT_ID_LEN];
+	const struct board_db_entry *entry;	/* NULL if not in board_db */
+};
+
+/*
+ * Fills id from the cache, or from socinfo when the cache is missing,
+ * stale or refresh is set, and then rewrites the cache. Returns 0, or a
+ * negative errno when socinfo cannot be read.
+ */
+int board_id_get(struct board_id *id, int refresh);
+
+/* Writes id as BOARD_*= shell assignments, the format of the cache */
+void board_id_print_env(FILE *fp, const struct board_id *id);
+
+/* Value of one BOARD_* field by its lower case name, e.g. "dtb" */
+const char *board_id_field(const struct board_id *id, const char *name,
+			   char *buf, size_t len);
+
+#endif /* __BOARD_ID_H__ */
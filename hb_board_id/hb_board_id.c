@@ -0,0 +1,85 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board_id.h"
+
+static const char *progname = "hb_board_id";
+
+static void usage(void)
+{
+	printf("Usage: %s [-r] [-f FIELD]\n", progname);
+	printf("Print the board identity as BOARD_*= shell assignments.\n\n");
+	printf("  -f, --field FIELD  print only FIELD: id, soc, pin_table, type,\n"
+	       "                     dtb or config, fail if it is empty\n");
+	printf("  -r, --refresh      reread socinfo instead of %s\n",
+	       BOARD_ID_CACHE_PATH);
+	printf("  -h, --help         display this message and exit\n");
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option longopts[] = {
+		{ "field",	required_argument,	NULL,	'f' },
+		{ "refresh",	no_argument,		NULL,	'r' },
+		{ "help",	no_argument,		NULL,	'h' },
+		{ NULL,		0,			NULL,	0 },
+	};
+	struct board_id id;
+	const char *field = NULL, *value;
+	char buf[16];
+	int refresh = 0, ret, opt;
+
+	while ((opt = getopt_long(argc, argv, "f:rh", longopts, NULL)) != -1) {
+		switch (opt) {
+		case 'f':
+			field = optarg;
+			break;
+		case 'r':
+			refresh = 1;
+			break;
+		case 'h':
+			usage();
+			return EXIT_SUCCESS;
+		default:
+			usage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	ret = board_id_get(&id, refresh);
+	if (ret < 0) {
+		fprintf(stderr, "%s: cannot read %s: %s\n", progname,
+			BOARD_ID_SOCINFO_PATH, strerror(-ret));
+		return EXIT_FAILURE;
+	}
+
+	if (!field) {
+		board_id_print_env(stdout, &id);
+		return EXIT_SUCCESS;
+	}
+	value = board_id_field(&id, field, buf, sizeof(buf));
+	if (!value) {
+		fprintf(stderr, "%s: unknown field %s\n", progname, field);
+		return EXIT_FAILURE;
+	}
+	if (!value[0])
+		return EXIT_FAILURE;
+	printf("%s\n", value);
+	return EXIT_SUCCESS;
+}
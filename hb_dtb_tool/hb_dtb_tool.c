@@ -20,12 +20,15 @@
 #include <fcntl.h>
 #include <ctype.h>
 #include <string.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 #include "hb_dtb_tool.h"
 
 int main(int argc, char *argv[])
 {
     char *imgfile = NULL;
     char *dtb_file = NULL;
+    char *profile = NULL;
     unsigned int board_id = 0xffff;
     struct stat fstat;
     struct andr_img_hdr *boot_hdr;
@@ -33,8 +36,9 @@ int main(int argc, char *argv[])
     struct hb_dtb_hdr *hbdtb_hdr;
     int set_dtb_flg = 0;
     int get_dtb_flg = 0;
+    int dry_run = 0;
     int ch, ret;
-    while ((ch = getopt(argc, argv, "i:b:gs:h")) != -1)
+    while ((ch = getopt(argc, argv, "i:b:gs:d:a:c:p:nh")) != -1)
     {
         // printf("optind: %d\n", optind);
         switch (ch)
@@ -59,6 +63,23 @@ int main(int argc, char *argv[])
             dtb_file = optarg;
             set_dtb_flg = 1;
             break;
+        case 'd':
+            dtb_file = optarg;
+            break;
+        case 'a':
+            profile = optarg;
+            break;
+        case 'c':
+            if (load_peri_conflicts(optarg) < 0)
+                return -1;
+            break;
+        case 'p':
+            if (load_peri_pins(optarg) < 0)
+                return -1;
+            break;
+        case 'n':
+            dry_run = 1;
+            break;
         case 'h':
             usage(argv[0]);
             return -1;
@@ -67,6 +88,16 @@ int main(int argc, char *argv[])
             return -1;
         }
     }
+    if (profile && dtb_file && !set_dtb_flg)
+    {
+        ret = apply_dtb_profile(dtb_file, profile, dry_run);
+        if (ret < 0)
+        {
+            printf("apply_dtb_profile failed!\n");
+            return -1;
+        }
+        return ret;
+    }
     if (imgfile == NULL || board_id == 0xffff)
     {
         usage(argv[0]);
@@ -247,6 +278,83 @@ int readwrite(int wfd, int rfd, int size)
     return read_ret;
 }
 
+// Logical sector size when fd is a block device, else SECTOR_SIZE
+int get_sector_size(int fd)
+{
+    struct stat st;
+    int size;
+    if (fstat(fd, &st) == 0 && S_ISBLK(st.st_mode) &&
+        ioctl(fd, BLKSSZGET, &size) == 0 && size > 0)
+    {
+        return size;
+    }
+    return SECTOR_SIZE;
+}
+
+// Writes buf at offset, but only the sectors whose content changes, so
+// patching a dtb on the boot partition costs a few sectors of eMMC wear.
+// Returns the number of sectors written.
+int write_changed_sectors(int fd, off_t offset, const char *buf, int size)
+{
+    int sector = get_sector_size(fd);
+    off_t start = offset - offset % sector;
+    int len = (offset + size - start + sector - 1) / sector * sector;
+    char *old, *new;
+    int i, run, done, ret, written = 0;
+
+    old = malloc(len);
+    new = malloc(len);
+    if (!old || !new)
+    {
+        perror("malloc sectors");
+        free(old);
+        free(new);
+        return -1;
+    }
+    for (done = 0; done < len; done += ret)
+    {
+        ret = pread(fd, old + done, len - done, start + done);
+        if (ret <= 0)
+        {
+            // past the end of an image file, nothing to keep there
+            if (ret == 0)
+            {
+                memset(old + done, 0, len - done);
+                break;
+            }
+            perror("pread sectors");
+            goto out;
+        }
+    }
+    memcpy(new, old, len);
+    memcpy(new + (offset - start), buf, size);
+
+    for (i = 0; i < len; i += run)
+    {
+        run = sector;
+        if (memcmp(old + i, new + i, sector) == 0)
+            continue;
+        // coalesce neighbouring dirty sectors into one write
+        while (i + run < len && memcmp(old + i + run, new + i + run, sector))
+            run += sector;
+        for (done = 0; done < run; done += ret)
+        {
+            ret = pwrite(fd, new + i + done, run - done, start + i + done);
+            if (ret < 0)
+            {
+                perror("pwrite sectors");
+                written = -1;
+                goto out;
+            }
+        }
+        written += run / sector;
+    }
+out:
+    free(old);
+    free(new);
+    return written;
+}
+
 int htoi(char s[])
 {
     int i;
@@ -276,6 +384,9 @@ int htoi(char s[])
 void usage(char *argv0)
 {
     printf("Get a dtb from bootimg.\nUsage: %s -i [imgfile] -b [board_id] [option gs:] [dtb_file]\n", argv0);
+    printf("Set the status of peripherals in a dtb.\nUsage: %s -d [dtb_file] -a [profile] [-p pin_table] [-c conflict_conf]... [-n]\n"
+           "  -p takes the conflicts from the pins of a board of hb_pin_db, e.g. RDK_X5\n"
+           "  exits with %d when the dtb already matches the profile\n", argv0, DTB_UNCHANGED);
 }
 
 int parse_dtb_from_img(char *imgfile, unsigned int board_id)
@@ -417,9 +528,28 @@ int parse_dtb_from_img(char *imgfile, unsigned int board_id)
     return 0;
 }
 
+// Bytes the dtb may take without running into the next dtb of the header.
+// Nothing is known to be free after the last one, it may not grow.
+static unsigned int dtb_room(struct hb_kernel_hdr *hbk_hdr,
+                             struct hb_dtb_hdr *hbdtb_hdr)
+{
+    unsigned int i, room = hbdtb_hdr->dtb_size;
+    unsigned int next = 0;
+
+    for (i = 0; i < hbk_hdr->dtb_number && i < DTB_MAX_NUM; i++)
+    {
+        if (hbk_hdr->dtb[i].dtb_addr > hbdtb_hdr->dtb_addr &&
+            (!next || hbk_hdr->dtb[i].dtb_addr < next))
+            next = hbk_hdr->dtb[i].dtb_addr;
+    }
+    if (next && next - hbdtb_hdr->dtb_addr > room)
+        room = next - hbdtb_hdr->dtb_addr;
+    return room;
+}
+
 int flash_dtb_to_img(char *imgfile, char *dtb_file, unsigned int board_id)
 {
-    int ret, dtb_fd, img_fd;
+    int ret, dtb_fd, img_fd, sectors;
     unsigned char *buffer, *hbdtb_buf;
     struct stat fstat;
     unsigned int dtb_addr;
@@ -532,39 +662,45 @@ int flash_dtb_to_img(char *imgfile, char *dtb_file, unsigned int board_id)
         printf("get dtb err! \n");
         return -1;
     }
-    //update hb_kernel_hdr
-    hbdtb_hdr->dtb_size = fdt_totalsize(hbdtb_buf);
-    ret = lseek(img_fd, k_off, SEEK_SET);
-    if (ret < 0)
+    if (fstat.st_size > dtb_room(hbk_hdr, hbdtb_hdr))
     {
-        perror("lseek k_off");
+        printf("%s is %ld bytes, only %u fit before the next dtb\n",
+               dtb_file, (long)fstat.st_size, dtb_room(hbk_hdr, hbdtb_hdr));
         return -1;
     }
 
-    ret = writeall(img_fd, buffer, sizeof(struct hb_kernel_hdr));
-    if (ret < 0 && ret != sizeof(struct hb_kernel_hdr))
+    dtb_addr = sizeof(struct hb_kernel_hdr) + k_off + hbdtb_hdr->dtb_addr;
+    strcpy(dtb_name, hbdtb_hdr->dtb_name);
+
+    // the dtb goes first, an interrupted flash leaves the header pointing
+    // at the old size rather than announcing data that is not there
+    ret = write_changed_sectors(img_fd, dtb_addr, (char *)hbdtb_buf, fstat.st_size);
+    if (ret < 0)
     {
-        perror("writeall buffer");
+        return -1;
+    }
+    sectors = ret;
+    if (sectors && fsync(img_fd) < 0)
+    {
+        perror("fsync imgfile");
         return -1;
     }
 
-    dtb_addr = sizeof(struct hb_kernel_hdr) + k_off + hbdtb_hdr->dtb_addr;
-    strcpy(dtb_name, hbdtb_hdr->dtb_name);
-
-    ret = lseek(img_fd, dtb_addr, SEEK_SET);
+    //update hb_kernel_hdr
+    hbdtb_hdr->dtb_size = fdt_totalsize(hbdtb_buf);
+    ret = write_changed_sectors(img_fd, k_off, (char *)buffer, sizeof(struct hb_kernel_hdr));
     if (ret < 0)
     {
-        perror("lseek buffer");
         return -1;
     }
-    ret = writeall(img_fd, hbdtb_buf, fstat.st_size);
-    if (ret < 0 && ret != hbdtb_hdr->dtb_size)
+    if (ret && fsync(img_fd) < 0)
     {
-        perror("writeall buffer");
+        perror("fsync imgfile");
         return -1;
     }
-    
-    printf("FLASH DONE\n");
+    sectors += ret;
+
+    printf("FLASH DONE, %d sectors written\n", sectors);
     free(buffer);
     free(hbdtb_buf);
     close(dtb_fd);
@@ -51,6 +51,15 @@
 #define ANDR_BOOT_ARGS_SIZE 512
 #define ANDR_BOOT_EXTRA_ARGS_SIZE 1024
 #define PAGE_SIZE 0x800
+#define SECTOR_SIZE 512
+
+#define PERI_MAX_NUM 64 /* bits of peri_set_t */
+#define PERI_NAME_MAX_LEN 32
+#define PERI_STATUS_MAX_LEN 16
+#define PERI_LINE_MAX_LEN 256
+#define DTB_UNCHANGED 2 /* apply_dtb_profile: the dtb already matches */
+#define PERI_BIT(peri) (1ULL << (peri))
+typedef unsigned long long peri_set_t; /* peripherals of the conflict graph */
 typedef unsigned int fdt32_t;
 struct fdt_header
 {
@@ -134,10 +143,21 @@ void show_dtb_info(struct hb_dtb_hdr *hbdtb_hdr);
 struct hb_dtb_hdr *get_hb_dtb(unsigned int board_type, struct hb_kernel_hdr *config);
 int readall(int fd, char *buf, int size);
 int writeall(int fd, char *buf, int size);
+int get_sector_size(int fd);
+int write_changed_sectors(int fd, off_t offset, const char *buf, int size);
 int readwrite(int wfd, int rfd, int size);
 int htoi(char s[]);
 void usage(char *argv0);
 int parse_dtb_from_img(char *imgfile, unsigned int board_id);
 int flash_dtb_to_img(char *imgfile, char *dtb_file, unsigned int board_id);
+int load_peri_conflicts(char *conf_file);
+int load_peri_pins(char *pin_table);
+int peri_graph_find(const char *name);
+int peri_graph_size(void);
+int peri_graph_configurable(const char *name);
+const char *peri_graph_name(int peri);
+peri_set_t peri_graph_neighbours(int peri);
+int peri_graph_pin(int a, int b);
+int apply_dtb_profile(char *dtb_file, char *profile, int dry_run);
 
 #endif
@@ -0,0 +1,558 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Batch "status" editor for srpi-config. The profile lists the wanted
+// state of each peripheral, one "name=okay|disabled" per line. Enabling a
+// peripheral disables its neighbours in the conflict graph (hb_peri_graph.c)
+// that are enabled, which is the smallest change leaving no two enabled
+// peripherals on one pin. All changes are applied to a copy of the
+// structure block, so the dtb is read and written once, and not at all when
+// it already matches the profile.
+
+#include <limits.h>
+#include "hb_dtb_tool.h"
+
+#define FDT_BEGIN_NODE 0x1
+#define FDT_END_NODE 0x2
+#define FDT_PROP 0x3
+#define FDT_NOP 0x4
+#define FDT_END 0x9
+#define FDT_TAGSIZE 4
+#define FDT_ALIGN(x) (((x) + 3) & ~3u)
+
+struct peri_state
+{
+    char name[PERI_NAME_MAX_LEN];
+    char status[PERI_STATUS_MAX_LEN];
+    char cause[PERI_NAME_MAX_LEN]; /* peripheral whose enabling implies this */
+    int pin;                       /* header pin shared with cause, 0 if none */
+    int node;                      /* structure offset of its BEGIN_NODE */
+    int changed;
+};
+
+static struct peri_state wanted[PERI_MAX_NUM];
+static int wanted_num;
+
+static unsigned int fdt_cell(const unsigned char *fdt, unsigned int offset)
+{
+    return big2lit(*(const unsigned int *)(fdt + offset));
+}
+
+static char *trim(char *s)
+{
+    char *end;
+    while (isspace((unsigned char)*s))
+        s++;
+    end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+    return s;
+}
+
+// Token at offset of the structure block, and the offset of the next one
+static unsigned int fdt_next_tag(const unsigned char *fdt, unsigned int offset,
+                                 unsigned int *next)
+{
+    const unsigned char *dt_struct = fdt + fdt_off_dt_struct(fdt);
+    unsigned int tag = big2lit(*(const unsigned int *)(dt_struct + offset));
+    unsigned int len;
+
+    offset += FDT_TAGSIZE;
+    switch (tag)
+    {
+    case FDT_BEGIN_NODE:
+        offset = FDT_ALIGN(offset + strlen((const char *)dt_struct + offset) + 1);
+        break;
+    case FDT_PROP:
+        len = big2lit(*(const unsigned int *)(dt_struct + offset));
+        offset = FDT_ALIGN(offset + 8 + len);
+        break;
+    }
+    *next = offset;
+    return tag;
+}
+
+static const char *fdt_string(const unsigned char *fdt, unsigned int offset)
+{
+    return (const char *)fdt + fdt_off_dt_strings(fdt) + offset;
+}
+
+// Property of the node starting at node, NULL if it has none of that name
+static const char *fdt_node_prop(const unsigned char *fdt, int node,
+                                 const char *name, unsigned int *len)
+{
+    const unsigned char *dt_struct = fdt + fdt_off_dt_struct(fdt);
+    unsigned int offset, next, tag;
+
+    fdt_next_tag(fdt, node, &offset);
+    while ((tag = fdt_next_tag(fdt, offset, &next)) == FDT_PROP ||
+           tag == FDT_NOP)
+    {
+        if (tag == FDT_PROP &&
+            strcmp(fdt_string(fdt, fdt_cell(dt_struct, offset + 8)), name) == 0)
+        {
+            *len = fdt_cell(dt_struct, offset + 4);
+            return (const char *)dt_struct + offset + 12;
+        }
+        offset = next;
+    }
+    return NULL;
+}
+
+// Subnode of parent named name, "name" alone matches "name@unit"
+static int fdt_subnode(const unsigned char *fdt, int parent, const char *name,
+                       int namelen)
+{
+    const char *dt_struct = (const char *)fdt + fdt_off_dt_struct(fdt);
+    unsigned int offset, next, tag;
+    const char *node_name;
+    int depth = 0;
+
+    fdt_next_tag(fdt, parent, &offset);
+    while ((tag = fdt_next_tag(fdt, offset, &next)) != FDT_END)
+    {
+        if (tag == FDT_BEGIN_NODE)
+        {
+            node_name = dt_struct + offset + FDT_TAGSIZE;
+            if (depth++ == 0 && strncmp(node_name, name, namelen) == 0 &&
+                (node_name[namelen] == '\0' ||
+                 (node_name[namelen] == '@' && !memchr(name, '@', namelen))))
+                return offset;
+        }
+        else if (tag == FDT_END_NODE)
+        {
+            if (depth-- == 0)
+                break;
+        }
+        offset = next;
+    }
+    return -1;
+}
+
+static int fdt_path_node(const unsigned char *fdt, const char *path)
+{
+    const char *end;
+    int node = 0;
+
+    while (*path && node >= 0)
+    {
+        while (*path == '/')
+            path++;
+        if (!*path)
+            break;
+        end = strchr(path, '/');
+        if (!end)
+            end = path + strlen(path);
+        node = fdt_subnode(fdt, node, path, end - path);
+        path = end;
+    }
+    return node;
+}
+
+// A path, or an alias like fdtget accepts
+static int fdt_find_node(const unsigned char *fdt, const char *name)
+{
+    unsigned int len;
+    const char *path;
+    int aliases;
+
+    if (name[0] == '/')
+        return fdt_path_node(fdt, name);
+    aliases = fdt_path_node(fdt, "/aliases");
+    if (aliases < 0)
+        return -1;
+    path = fdt_node_prop(fdt, aliases, name, &len);
+    if (!path || len == 0 || path[len - 1] != '\0')
+        return -1;
+    return fdt_path_node(fdt, path);
+}
+
+static struct peri_state *find_wanted(const char *name)
+{
+    int i;
+    for (i = 0; i < wanted_num; i++)
+    {
+        if (strcmp(wanted[i].name, name) == 0)
+            return &wanted[i];
+    }
+    return NULL;
+}
+
+static int add_wanted(const char *name, const char *status, const char *cause,
+                      int pin)
+{
+    struct peri_state *peri = find_wanted(name);
+
+    if (peri)
+    {
+        if (strcmp(peri->status, status) == 0)
+            return 0;
+        if (cause || peri->cause[0])
+            printf("error: enabling %s needs %s disabled\n",
+                   cause ? cause : peri->cause, name);
+        else
+            printf("error: %s is set twice in the profile\n", name);
+        return -1;
+    }
+    if (wanted_num == PERI_MAX_NUM || strlen(name) >= PERI_NAME_MAX_LEN ||
+        strlen(status) >= PERI_STATUS_MAX_LEN)
+    {
+        printf("error: too many or too long peripherals at %s\n", name);
+        return -1;
+    }
+    peri = &wanted[wanted_num++];
+    strcpy(peri->name, name);
+    strcpy(peri->status, status);
+    if (cause)
+        strcpy(peri->cause, cause);
+    peri->pin = pin;
+    return 0;
+}
+
+static int load_profile(char *profile)
+{
+    char line[PERI_LINE_MAX_LEN];
+    char *name, *status;
+    FILE *fp;
+    int ret = 0;
+
+    fp = fopen(profile, "r");
+    if (!fp)
+    {
+        perror(profile);
+        return -1;
+    }
+    while (ret == 0 && fgets(line, sizeof(line), fp))
+    {
+        name = trim(line);
+        if (name[0] == '\0' || name[0] == '#')
+            continue;
+        status = strchr(name, '=');
+        if (!status)
+        {
+            printf("error: %s: expected name=okay|disabled, got %s\n", profile, name);
+            ret = -1;
+            break;
+        }
+        *status++ = '\0';
+        name = trim(name);
+        status = trim(status);
+        if (strcmp(status, "okay") != 0 && strcmp(status, "disabled") != 0)
+        {
+            printf("error: %s: status of %s must be okay or disabled\n", profile, name);
+            ret = -1;
+            break;
+        }
+        if (!peri_graph_configurable(name))
+        {
+            printf("error: %s: %s is not a configurable peripheral\n", profile, name);
+            ret = -1;
+            break;
+        }
+        ret = add_wanted(name, status, NULL, 0);
+    }
+    fclose(fp);
+    return ret;
+}
+
+// Every neighbour of a peripheral the profile enables goes to disabled.
+// Enabled peripherals off those edges are left alone, so nothing changes
+// that the profile does not force.
+static int resolve_conflicts(void)
+{
+    peri_set_t enabling = 0, others;
+    int i, peri, other, num = wanted_num;
+
+    for (i = 0; i < num; i++)
+    {
+        peri = peri_graph_find(wanted[i].name);
+        if (peri >= 0 && strcmp(wanted[i].status, "okay") == 0)
+            enabling |= PERI_BIT(peri);
+    }
+    for (peri = 0; peri < peri_graph_size(); peri++)
+    {
+        if (!(enabling & PERI_BIT(peri)))
+            continue;
+        others = peri_graph_neighbours(peri);
+        for (other = 0; other < peri_graph_size(); other++)
+        {
+            if (!(others & PERI_BIT(other)))
+                continue;
+            if (add_wanted(peri_graph_name(other), "disabled",
+                           peri_graph_name(peri), peri_graph_pin(peri, other)) < 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+static const char *node_status(const unsigned char *fdt, int node)
+{
+    unsigned int len;
+    const char *status = fdt_node_prop(fdt, node, "status", &len);
+
+    // no status property means okay
+    if (!status || len == 0 || status[len - 1] != '\0')
+        return "okay";
+    return status;
+}
+
+// Conflicts the profile does not touch are only reported, they are in the
+// dtb already
+static void warn_conflicts(const unsigned char *fdt)
+{
+    peri_set_t enabled = 0;
+    struct peri_state *peri;
+    const char *status;
+    int i, j, node;
+
+    for (i = 0; i < peri_graph_size(); i++)
+    {
+        peri = find_wanted(peri_graph_name(i));
+        if (peri)
+        {
+            status = peri->status;
+        }
+        else
+        {
+            node = fdt_find_node(fdt, peri_graph_name(i));
+            status = node < 0 ? "disabled" : node_status(fdt, node);
+        }
+        if (strcmp(status, "okay") == 0)
+            enabled |= PERI_BIT(i);
+    }
+    for (i = 0; i < peri_graph_size(); i++)
+    {
+        for (j = i + 1; j < peri_graph_size(); j++)
+        {
+            if (!(enabled & PERI_BIT(i)) || !(enabled & PERI_BIT(j)) ||
+                !(peri_graph_neighbours(i) & PERI_BIT(j)))
+                continue;
+            if (peri_graph_pin(i, j))
+                printf("warning: %s and %s are both enabled on pin %d\n",
+                       peri_graph_name(i), peri_graph_name(j), peri_graph_pin(i, j));
+            else
+                printf("warning: %s and %s are both enabled\n",
+                       peri_graph_name(i), peri_graph_name(j));
+        }
+    }
+}
+
+// New structure block, with the status of every changed node replaced
+static unsigned char *build_dt_struct(const unsigned char *fdt, unsigned int status_name,
+                                      int changes, unsigned int *size)
+{
+    const unsigned char *dt_struct = fdt + fdt_off_dt_struct(fdt);
+    unsigned char *out, *p;
+    struct peri_state *peri = NULL;
+    unsigned int offset = 0, next, tag, len;
+    int i;
+
+    out = malloc(fdt_size_dt_struct(fdt) + changes * (12 + FDT_ALIGN(PERI_STATUS_MAX_LEN)));
+    if (!out)
+    {
+        perror("malloc dt_struct");
+        return NULL;
+    }
+    p = out;
+    do
+    {
+        tag = fdt_next_tag(fdt, offset, &next);
+        // by name, dtc shares string tails so two offsets may both be "status"
+        if (tag == FDT_PROP && peri &&
+            strcmp(fdt_string(fdt, fdt_cell(dt_struct, offset + 8)), "status") == 0)
+        {
+            // replaced by the one written after BEGIN_NODE
+            offset = next;
+            continue;
+        }
+        if (tag != FDT_PROP && tag != FDT_NOP)
+            peri = NULL;
+        memcpy(p, dt_struct + offset, next - offset);
+        p += next - offset;
+        if (tag == FDT_BEGIN_NODE)
+        {
+            for (i = 0; i < wanted_num; i++)
+            {
+                if (wanted[i].changed && wanted[i].node == (int)offset)
+                    peri = &wanted[i];
+            }
+            if (peri)
+            {
+                len = strlen(peri->status) + 1;
+                *(unsigned int *)p = big2lit(FDT_PROP);
+                *(unsigned int *)(p + 4) = big2lit(len);
+                *(unsigned int *)(p + 8) = big2lit(status_name);
+                memset(p + 12, 0, FDT_ALIGN(len));
+                memcpy(p + 12, peri->status, len);
+                p += 12 + FDT_ALIGN(len);
+            }
+        }
+        offset = next;
+    } while (tag != FDT_END);
+    *size = p - out;
+    return out;
+}
+
+static int write_dtb(char *dtb_file, const unsigned char *fdt, int changes)
+{
+    char tmp_file[PATH_MAX];
+    const char *strings = fdt_string(fdt, 0);
+    unsigned int strings_size = big2lit(((const struct fdt_header *)fdt)->size_dt_strings);
+    unsigned int status_name, struct_size, total, len;
+    unsigned char *dt_struct, *out;
+    struct fdt_header *hdr;
+    int fd, ret;
+
+    // reuse "status" from the strings block, also as the tail of a longer
+    // name the way dtc stores it, or append it
+    for (status_name = 0; status_name < strings_size; status_name += len + 1)
+    {
+        len = strlen(strings + status_name);
+        if (len >= 6 && strcmp(strings + status_name + len - 6, "status") == 0)
+        {
+            status_name += len - 6;
+            break;
+        }
+    }
+    dt_struct = build_dt_struct(fdt, status_name, changes, &struct_size);
+    if (!dt_struct)
+        return -1;
+
+    total = fdt_off_dt_struct(fdt) + struct_size + strings_size;
+    if (status_name == strings_size)
+        total += sizeof("status");
+    out = calloc(1, total);
+    if (!out)
+    {
+        perror("malloc dtb");
+        free(dt_struct);
+        return -1;
+    }
+    memcpy(out, fdt, fdt_off_dt_struct(fdt));
+    memcpy(out + fdt_off_dt_struct(fdt), dt_struct, struct_size);
+    memcpy(out + fdt_off_dt_struct(fdt) + struct_size, strings, strings_size);
+    if (status_name == strings_size)
+    {
+        strcpy((char *)out + fdt_off_dt_struct(fdt) + struct_size + strings_size, "status");
+        strings_size += sizeof("status");
+    }
+    hdr = (struct fdt_header *)out;
+    hdr->totalsize = big2lit(total);
+    hdr->off_dt_strings = big2lit(fdt_off_dt_struct(fdt) + struct_size);
+    hdr->size_dt_strings = big2lit(strings_size);
+    hdr->size_dt_struct = big2lit(struct_size);
+    free(dt_struct);
+
+    // never leave a half written dtb behind
+    snprintf(tmp_file, sizeof(tmp_file), "%s.%d", dtb_file, (int)getpid());
+    fd = open(tmp_file, O_CREAT | O_WRONLY | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+    {
+        perror(tmp_file);
+        free(out);
+        return -1;
+    }
+    ret = writeall(fd, (char *)out, total);
+    free(out);
+    if (close(fd) < 0 || ret != (int)total || rename(tmp_file, dtb_file) < 0)
+    {
+        perror(dtb_file);
+        unlink(tmp_file);
+        return -1;
+    }
+    return 0;
+}
+
+int apply_dtb_profile(char *dtb_file, char *profile, int dry_run)
+{
+    struct stat fstat;
+    unsigned char *fdt;
+    const char *status;
+    int i, fd, ret, changes = 0;
+
+    ret = load_profile(profile);
+    if (ret == 0)
+        ret = resolve_conflicts();
+    if (ret < 0)
+        return -1;
+
+    fd = open(dtb_file, O_RDONLY);
+    if (fd < 0 || stat(dtb_file, &fstat) < 0)
+    {
+        perror(dtb_file);
+        return -1;
+    }
+    fdt = malloc(fstat.st_size);
+    if (!fdt)
+    {
+        perror("malloc dtb");
+        close(fd);
+        return -1;
+    }
+    ret = readall(fd, (char *)fdt, fstat.st_size);
+    close(fd);
+    if (ret != fstat.st_size || fdt_check_header(fdt) < 0 ||
+        fdt_totalsize(fdt) > fstat.st_size || fdt_version(fdt) < 17 ||
+        fdt_off_dt_struct(fdt) > fdt_off_dt_strings(fdt))
+    {
+        printf("%s is not a supported dtb\n", dtb_file);
+        free(fdt);
+        return -1;
+    }
+
+    for (i = 0; i < wanted_num; i++)
+    {
+        wanted[i].node = fdt_find_node(fdt, wanted[i].name);
+        // a pin may be muxed to a peripheral this dtb does not describe
+        if (wanted[i].node < 0 && wanted[i].cause[0])
+            continue;
+        if (wanted[i].node < 0)
+        {
+            printf("error: no node or alias %s in %s\n", wanted[i].name, dtb_file);
+            free(fdt);
+            return -1;
+        }
+        status = node_status(fdt, wanted[i].node);
+        if (strcmp(status, wanted[i].status) == 0)
+            continue;
+        wanted[i].changed = 1;
+        changes++;
+        if (wanted[i].pin)
+            printf("%s\t%s -> %s (conflicts with %s on pin %d)\n", wanted[i].name,
+                   status, wanted[i].status, wanted[i].cause, wanted[i].pin);
+        else if (wanted[i].cause[0])
+            printf("%s\t%s -> %s (conflicts with %s)\n", wanted[i].name,
+                   status, wanted[i].status, wanted[i].cause);
+        else
+            printf("%s\t%s -> %s\n", wanted[i].name, status, wanted[i].status);
+    }
+
+    warn_conflicts(fdt);
+    if (changes == 0)
+    {
+        printf("%s already matches %s\n", dtb_file, profile);
+        ret = DTB_UNCHANGED;
+    }
+    else if (dry_run)
+    {
+        ret = 0;
+    }
+    else
+    {
+        ret = write_dtb(dtb_file, fdt, changes);
+    }
+    free(fdt);
+    return ret;
+}
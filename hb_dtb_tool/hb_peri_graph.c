@@ -0,0 +1,185 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Peripheral conflict graph. A node is a peripheral named by its dtb alias,
+// an edge joins two peripherals that cannot be enabled together. Edges come
+// from the pins of the board, two peripherals muxed to the same header pin
+// conflict (peri_db.h, generated from hb_pin_db/pins.json), and from the
+// hobot.conf files, "name:other,other", for boards without pin data.
+// Neighbours are kept as bitmasks, so a whole set is resolved in one pass.
+
+#include "hb_dtb_tool.h"
+#include "peri_db.h"
+
+static char peri_names[PERI_MAX_NUM][PERI_NAME_MAX_LEN];
+static peri_set_t peri_adj[PERI_MAX_NUM];
+static unsigned char peri_pin[PERI_MAX_NUM][PERI_MAX_NUM]; /* 0: hobot.conf */
+static peri_set_t peri_listed;                              /* in a hobot.conf */
+static int peri_num;
+static int conf_loaded;
+
+static char *trim(char *s)
+{
+    char *end;
+    while (isspace((unsigned char)*s))
+        s++;
+    end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+    return s;
+}
+
+int peri_graph_find(const char *name)
+{
+    int i;
+    for (i = 0; i < peri_num; i++)
+    {
+        if (strcmp(peri_names[i], name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static int peri_graph_add(const char *name)
+{
+    int peri = peri_graph_find(name);
+
+    if (peri >= 0)
+        return peri;
+    if (peri_num == PERI_MAX_NUM || strlen(name) >= PERI_NAME_MAX_LEN)
+    {
+        printf("error: too many or too long peripherals at %s\n", name);
+        return -1;
+    }
+    strcpy(peri_names[peri_num], name);
+    return peri_num++;
+}
+
+static void peri_graph_connect(int a, int b, int pin)
+{
+    if (a == b)
+        return;
+    peri_adj[a] |= PERI_BIT(b);
+    peri_adj[b] |= PERI_BIT(a);
+    // keep the first pin found, any one explains the conflict
+    if (!peri_pin[a][b])
+        peri_pin[a][b] = peri_pin[b][a] = pin;
+}
+
+const char *peri_graph_name(int peri)
+{
+    return peri_names[peri];
+}
+
+int peri_graph_size(void)
+{
+    return peri_num;
+}
+
+peri_set_t peri_graph_neighbours(int peri)
+{
+    return peri_adj[peri];
+}
+
+int peri_graph_pin(int a, int b)
+{
+    return peri_pin[a][b];
+}
+
+// Without a hobot.conf every node of the dtb may be set
+int peri_graph_configurable(const char *name)
+{
+    int peri;
+
+    if (!conf_loaded)
+        return 1;
+    peri = peri_graph_find(name);
+    return peri >= 0 && (peri_listed & PERI_BIT(peri));
+}
+
+int load_peri_pins(char *pin_table)
+{
+    size_t i, j;
+    int a, b, found = 0;
+
+    for (i = 0; i < PERI_DB_NUM; i++)
+    {
+        if (strcmp(peri_db[i].pin_table, pin_table) != 0)
+            continue;
+        found++;
+        a = peri_graph_add(peri_db[i].peri);
+        if (a < 0)
+            return -1;
+        for (j = i + 1; j < PERI_DB_NUM; j++)
+        {
+            if (peri_db[j].pin != peri_db[i].pin ||
+                strcmp(peri_db[j].pin_table, pin_table) != 0)
+                continue;
+            b = peri_graph_add(peri_db[j].peri);
+            if (b < 0)
+                return -1;
+            peri_graph_connect(a, b, peri_db[i].pin);
+        }
+    }
+    if (!found)
+        printf("warning: no pin data for %s, conflicts come from hobot.conf only\n",
+               pin_table);
+    return 0;
+}
+
+int load_peri_conflicts(char *conf_file)
+{
+    char line[PERI_LINE_MAX_LEN];
+    char *name, *others, *other;
+    int peri, peer;
+    FILE *fp;
+
+    fp = fopen(conf_file, "r");
+    if (!fp)
+    {
+        perror(conf_file);
+        return -1;
+    }
+    conf_loaded = 1;
+    while (fgets(line, sizeof(line), fp))
+    {
+        name = trim(line);
+        if (name[0] == '\0' || name[0] == '#')
+            continue;
+        others = strchr(name, ':');
+        if (others)
+            *others++ = '\0';
+        peri = peri_graph_add(trim(name));
+        if (peri < 0)
+        {
+            fclose(fp);
+            return -1;
+        }
+        peri_listed |= PERI_BIT(peri);
+        if (!others)
+            continue;
+        for (other = strtok(others, ", \t\n"); other; other = strtok(NULL, ", \t\n"))
+        {
+            peer = peri_graph_add(other);
+            if (peer < 0)
+            {
+                fclose(fp);
+                return -1;
+            }
+            peri_graph_connect(peri, peer, 0);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
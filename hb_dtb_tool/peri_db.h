@@ -0,0 +1,105 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+#ifndef __PERI_DB_H__
+#define __PERI_DB_H__
+
+/*
+ * Every peripheral a header pin can be muxed to, from the "functions" of
+ * the pins in pins.json. Peripherals are named by their dtb alias, two of
+ * them listed on the same pin cannot be enabled together.
+ */
+struct peri_db_entry {
+	const char *pin_table;	/* board name in pins.json */
+	unsigned char pin;	/* BOARD mode number */
+	const char *peri;	/* dtb alias, e.g. "serial3" */
+};
+
+static const struct peri_db_entry peri_db[] = {
+	{ "RDK_X5", 3, "i2c5" },
+	{ "RDK_X5", 3, "serial3" },
+	{ "RDK_X5", 5, "i2c5" },
+	{ "RDK_X5", 5, "serial3" },
+	{ "RDK_X5", 7, "i2s1" },
+	{ "RDK_X5", 8, "serial1" },
+	{ "RDK_X5", 10, "serial1" },
+	{ "RDK_X5", 11, "serial7" },
+	{ "RDK_X5", 12, "i2s1" },
+	{ "RDK_X5", 13, "serial7" },
+	{ "RDK_X5", 15, "serial2" },
+	{ "RDK_X5", 16, "serial6" },
+	{ "RDK_X5", 18, "spi2" },
+	{ "RDK_X5", 18, "pwm1" },
+	{ "RDK_X5", 19, "spi1" },
+	{ "RDK_X5", 21, "spi1" },
+	{ "RDK_X5", 22, "serial2" },
+	{ "RDK_X5", 23, "spi1" },
+	{ "RDK_X5", 24, "spi1" },
+	{ "RDK_X5", 26, "spi1" },
+	{ "RDK_X5", 27, "i2c0" },
+	{ "RDK_X5", 27, "pwm2" },
+	{ "RDK_X5", 28, "i2c0" },
+	{ "RDK_X5", 28, "pwm2" },
+	{ "RDK_X5", 29, "spi2" },
+	{ "RDK_X5", 29, "pwm0" },
+	{ "RDK_X5", 31, "i2c1" },
+	{ "RDK_X5", 31, "pwm0" },
+	{ "RDK_X5", 32, "pwm3" },
+	{ "RDK_X5", 32, "i2c1" },
+	{ "RDK_X5", 33, "pwm3" },
+	{ "RDK_X5", 33, "i2c1" },
+	{ "RDK_X5", 35, "i2s1" },
+	{ "RDK_X5", 36, "serial6" },
+	{ "RDK_X5", 37, "spi2" },
+	{ "RDK_X5", 38, "i2s1" },
+	{ "RDK_X5", 40, "i2s1" },
+	{ "EVB_X5", 3, "i2c5" },
+	{ "EVB_X5", 3, "serial3" },
+	{ "EVB_X5", 5, "i2c5" },
+	{ "EVB_X5", 5, "serial3" },
+	{ "EVB_X5", 7, "i2s1" },
+	{ "EVB_X5", 8, "serial2" },
+	{ "EVB_X5", 10, "serial2" },
+	{ "EVB_X5", 11, "serial6" },
+	{ "EVB_X5", 12, "i2s1" },
+	{ "EVB_X5", 13, "serial6" },
+	{ "EVB_X5", 16, "serial1" },
+	{ "EVB_X5", 18, "serial1" },
+	{ "EVB_X5", 19, "spi2" },
+	{ "EVB_X5", 19, "pwm1" },
+	{ "EVB_X5", 21, "spi2" },
+	{ "EVB_X5", 23, "spi2" },
+	{ "EVB_X5", 23, "pwm0" },
+	{ "EVB_X5", 24, "i2c1" },
+	{ "EVB_X5", 24, "pwm0" },
+	{ "EVB_X5", 27, "pwm3" },
+	{ "EVB_X5", 27, "i2c1" },
+	{ "EVB_X5", 28, "pwm3" },
+	{ "EVB_X5", 28, "i2c1" },
+	{ "EVB_X5", 29, "serial7" },
+	{ "EVB_X5", 31, "serial7" },
+	{ "EVB_X5", 32, "i2c0" },
+	{ "EVB_X5", 32, "pwm2" },
+	{ "EVB_X5", 33, "i2c0" },
+	{ "EVB_X5", 33, "pwm2" },
+	{ "EVB_X5", 35, "i2s1" },
+	{ "EVB_X5", 38, "i2s1" },
+	{ "EVB_X5", 40, "i2s1" },
+};
+
+#define PERI_DB_NUM (sizeof(peri_db) / sizeof(peri_db[0]))
+
+#endif /* __PERI_DB_H__ */
@@ -0,0 +1,455 @@
+#!/usr/bin/env python3
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Micro-benchmarks of the Hobot.GPIO hot paths, one JSON document per run.
+#
+# Without hardware the sysfs paths, edges included, run against an RDK X5
+# simulated by hb_gpio_sim in a temporary directory. Native (character
+# device) benchmarks need a chip: point --chip at a gpio-sim or gpio-mockup
+# chip, or at a board's controller. On real sysfs, edge to callback latency
+# needs a gpio whose level can be forced from user space, e.g. a gpio-sim
+# line exported through /sys/class/gpio with
+# --edge-gpio <number> --edge-trigger /sys/.../sim_gpio<offset>/pull
+#
+# Every result reports ops/sec, latency percentiles and read/write syscalls
+# per operation from /proc/self/io. With --strace, each benchmark is also
+# rerun under strace -c to count every syscall.
+
+import os
+import sys
+import json
+import time
+import shutil
+import argparse
+import platform
+import tempfile
+import threading
+import subprocess
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PKG_PATH = os.path.join(HERE, '..', 'hb_gpio_py', 'hobot-gpio', 'lib',
+                        'python')
+SIM_PATH = os.path.join(HERE, '..', 'hb_gpio_sim')
+
+FORMAT_VERSION = 1
+
+# simulated board, and the BOARD pins used on it
+TREE_BOARD_ID = 0x301
+TREE_OUTPUT_PIN = 11
+TREE_INPUT_PIN = 13
+TREE_EDGE_PIN = 15
+TREE_PWM_PIN = 32
+
+SYSFS_BENCHES = ('sysfs.output', 'sysfs.input', 'sysfs.pwm_duty')
+NATIVE_BENCHES = ('native.output', 'native.output_group')
+EDGE_BENCHES = ('sysfs.edge_to_callback',)
+
+PERCENTILES = (('p50', 50.0), ('p90', 90.0), ('p99', 99.0), ('p999', 99.9))
+
+
+def _write(path, data=''):
+    d = os.path.dirname(path)
+    if not os.path.isdir(d):
+        os.makedirs(d)
+    with open(path, 'w') as f:
+        f.write(data)
+
+
+def start_simulator(root):
+    sys.path.insert(0, SIM_PATH)
+    import hb_gpio_sim
+    sim = hb_gpio_sim.Simulator(root, board_id=TREE_BOARD_ID)
+    sim.build()
+    sim.start()
+    # must be set before Hobot.GPIO is imported
+    os.environ['HOBOT_IO_ROOT'] = sim.root
+    return sim
+
+
+def load_gpio(installed):
+    if not installed:
+        sys.path.insert(0, PKG_PATH)
+    import Hobot.GPIO.gpio as GPIO
+    return GPIO
+
+
+def _proc_io():
+    counters = {}
+    try:
+        with open('/proc/self/io', 'r') as f:
+            for line in f:
+                key, value = line.split(':')
+                counters[key] = int(value)
+    except (IOError, OSError, ValueError):
+        pass
+    return counters.get('syscr', 0), counters.get('syscw', 0)
+
+
+def _percentile(samples, percent):
+    index = int(round(percent / 100.0 * (len(samples) - 1)))
+    return samples[index]
+
+
+def summarize(name, backend, op, latencies, elapsed_ns, io_before, io_after,
+              extra=None):
+    count = len(latencies)
+    latencies.sort()
+    result = {
+        'name': name,
+        'backend': backend,
+        'op': op,
+        'iterations': count,
+        'ops_per_sec': round(count * 1e9 / elapsed_ns, 1) if elapsed_ns else 0,
+        'latency_ns': {
+            'min': latencies[0],
+            'mean': sum(latencies) // count,
+            'max': latencies[-1],
+        },
+        'syscalls_per_op': {
+            'read': round(float(io_after[0] - io_before[0]) / count, 3),
+            'write': round(float(io_after[1] - io_before[1]) / count, 3),
+        },
+    }
+    for key, percent in PERCENTILES:
+        result['latency_ns'][key] = _percentile(latencies, percent)
+    if extra:
+        result.update(extra)
+    return result
+
+
+def measure(name, backend, op, func, iterations, warmup):
+    for i in range(warmup):
+        func(i)
+    latencies = [0] * iterations
+    clock = time.perf_counter_ns
+    io_before = _proc_io()
+    start = clock()
+    for i in range(iterations):
+        t0 = clock()
+        func(i)
+        latencies[i] = clock() - t0
+    elapsed = clock() - start
+    io_after = _proc_io()
+    return summarize(name, backend, op, latencies, elapsed, io_before,
+                     io_after)
+
+
+def skipped(name, reason):
+    return {'name': name, 'skipped': reason}
+
+
+# sysfs backend, through the public Hobot.GPIO API
+def bench_sysfs(GPIO, args):
+    results = []
+    pwm = None
+    GPIO.setwarnings(False)
+    GPIO.setmode(GPIO.BOARD)
+
+    GPIO.setup(args.output_pin, GPIO.OUT)
+    results.append(measure('sysfs.output', 'sysfs', 'output',
+                           lambda i: GPIO.output(args.output_pin, i & 1),
+                           args.iterations, args.warmup))
+
+    GPIO.setup(args.input_pin, GPIO.IN)
+    results.append(measure('sysfs.input', 'sysfs', 'input',
+                           lambda i: GPIO.input(args.input_pin),
+                           args.iterations, args.warmup))
+
+    try:
+        pwm = GPIO.PWM(args.pwm_pin, 1000)
+        pwm.start(50)
+    except (RuntimeError, ValueError) as exc:
+        results.append(skipped('sysfs.pwm_duty', str(exc)))
+    else:
+        results.append(measure('sysfs.pwm_duty', 'sysfs', 'pwm_duty',
+                               lambda i: pwm.ChangeDutyCycle(25 + (i & 1) * 50),
+                               args.iterations, args.warmup))
+        pwm.stop()
+
+    del pwm
+    GPIO.cleanup()
+    return results
+
+
+# native backend, the libgpiod character device through Hobot.GPIO._native
+def bench_native(args):
+    name = 'native.output'
+    try:
+        from Hobot.GPIO import _native
+    except ImportError:
+        return [skipped(name, 'Hobot.GPIO._native is not built')]
+    lines = [(args.chip, offset) for offset in args.lines]
+    try:
+        wave = _native.Wave(lines)
+    except (OSError, RuntimeError, ValueError) as exc:
+        return [skipped(name, str(exc))]
+    everything = (1 << len(lines)) - 1
+    try:
+        results = [
+            measure(name, 'native', 'output',
+                    lambda i: wave.set(1, i & 1),
+                    args.iterations, args.warmup),
+            measure('native.output_group', 'native', 'output_group',
+                    lambda i: wave.set(everything, everything * (i & 1)),
+                    args.iterations, args.warmup),
+        ]
+    finally:
+        wave.close()
+    return results
+
+
+# edge to callback, through gpio_event._poll_thread on a real sysfs gpio
+def _edge_loop(name, args, trigger, level):
+    # toggles the level through trigger() and times each edge until the
+    # callback returned by this function runs
+    fired = threading.Event()
+    stamp = [0]
+
+    def callback(*unused):
+        stamp[0] = time.perf_counter_ns()
+        fired.set()
+
+    def run():
+        lvl = level
+        latencies = []
+        missed = 0
+        time.sleep(0.1)
+        io_before = _proc_io()
+        start = time.perf_counter_ns()
+        for i in range(args.edges):
+            lvl ^= 1
+            fired.clear()
+            t0 = time.perf_counter_ns()
+            trigger(lvl)
+            if fired.wait(args.edge_timeout):
+                latencies.append(stamp[0] - t0)
+            else:
+                missed += 1
+        elapsed = time.perf_counter_ns() - start
+        io_after = _proc_io()
+        if not latencies:
+            return [skipped(name, 'no edge reached the callback')]
+        return [summarize(name, 'sysfs', 'edge_to_callback', latencies,
+                          elapsed, io_before, io_after, {'missed': missed})]
+
+    return callback, run
+
+
+def bench_edge(args):
+    name = 'sysfs.edge_to_callback'
+    from Hobot.GPIO import gpio_event as event
+
+    class Node(object):
+        pass
+
+    gpio_dir = '/sys/class/gpio/gpio%d' % args.edge_gpio
+    exported = not os.path.exists(gpio_dir)
+    if exported:
+        _write('/sys/class/gpio/export', str(args.edge_gpio))
+    node = Node()
+    node.gpio_value = gpio_dir + '/value'
+    node.gpio_edge = gpio_dir + '/edge'
+    pin_info = {name: node}
+
+    callback, run = _edge_loop(
+        name, args, lambda level: _write(args.edge_trigger, str(level)), 0)
+    try:
+        _write(gpio_dir + '/direction', 'in')
+        _write(args.edge_trigger, '0')
+        if event._add_event_detect(pin_info, name, 'BOTH', None) < 0:
+            return [skipped(name, 'cannot poll ' + node.gpio_value)]
+        event._add_callback(name, callback)
+        return run()
+    finally:
+        event._event_cleanup(pin_info, name)
+        if exported:
+            _write('/sys/class/gpio/unexport', str(args.edge_gpio))
+
+
+def bench_edge_tree(GPIO, sim, args):
+    # the simulator rewrites the value file, Hobot.GPIO sees it through its
+    # inotify fallback since regular files cannot be polled for priority data
+    name = 'sysfs.edge_to_callback'
+    GPIO.setmode(GPIO.BOARD)
+    GPIO.setup(args.edge_pin, GPIO.IN)
+    gpio = int(GPIO.pin_info[args.edge_pin].gpio_id)
+    sim.set_level(gpio, 0)
+    callback, run = _edge_loop(
+        name, args, lambda level: sim.set_level(gpio, level), 0)
+    try:
+        GPIO.add_event_detect(args.edge_pin, GPIO.BOTH, callback=callback)
+        return run()
+    finally:
+        GPIO.cleanup(args.edge_pin)
+
+
+def _strace_calls(argv):
+    # total syscall count of a child run, from the last line of strace -c
+    with tempfile.NamedTemporaryFile(suffix='.strace') as out:
+        subprocess.check_call(['strace', '-f', '-c', '-o', out.name] + argv,
+                              stdout=subprocess.DEVNULL)
+        lines = [x.split() for x in out.read().decode().splitlines()]
+    for fields in reversed(lines):
+        if fields and fields[-1] == 'total':
+            return int(fields[3])
+    raise RuntimeError('unexpected strace output')
+
+
+def add_strace_counts(results, argv):
+    # the baseline run does the same setup with zero iterations, so the
+    # difference is what the measured loop itself costs
+    for result in results:
+        if 'skipped' in result:
+            continue
+        child = [sys.executable, os.path.abspath(__file__), '--no-strace',
+                 '--only', result['name'], '--output', os.devnull] + argv
+        try:
+            base = _strace_calls(child + ['--iterations', '0', '--warmup', '0',
+                                          '--edges', '0'])
+            total = _strace_calls(child)
+        except (OSError, subprocess.CalledProcessError, RuntimeError):
+            continue
+        result['syscalls_per_op']['total'] = round(
+            float(total - base) / result['iterations'], 3)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description='Benchmark the Hobot.GPIO backends and print JSON')
+    parser.add_argument('--target', choices=('tree', 'board'), default='tree',
+                        help='simulated board (default) or the real board')
+    parser.add_argument('--tree', metavar='DIR',
+                        help='build the simulated tree in DIR and keep it')
+    parser.add_argument('--installed', action='store_true',
+                        help='benchmark the installed Hobot.GPIO')
+    parser.add_argument('--chip', metavar='PATH',
+                        help='gpio chip for the native benchmarks, '
+                             'e.g. a gpio-sim /dev/gpiochipN')
+    parser.add_argument('--lines', default='0,1',
+                        help='line offsets on --chip (default 0,1)')
+    parser.add_argument('--edge-gpio', type=int, metavar='N',
+                        help='sysfs gpio number for the edge benchmark')
+    parser.add_argument('--edge-trigger', metavar='PATH',
+                        help='file forcing the level of --edge-gpio')
+    parser.add_argument('--edge-timeout', type=float, default=1.0)
+    parser.add_argument('--edge-pin', type=int, default=TREE_EDGE_PIN,
+                        help='BOARD pin for the edge benchmark on the tree')
+    parser.add_argument('--output-pin', type=int, default=TREE_OUTPUT_PIN)
+    parser.add_argument('--input-pin', type=int, default=TREE_INPUT_PIN)
+    parser.add_argument('--pwm-pin', type=int, default=TREE_PWM_PIN)
+    parser.add_argument('-n', '--iterations', type=int, default=20000)
+    parser.add_argument('--warmup', type=int, default=1000)
+    parser.add_argument('--edges', type=int, default=1000)
+    parser.add_argument('--only', action='append', metavar='NAME',
+                        help='run only the named benchmark, repeatable')
+    parser.add_argument('--strace', action='store_true',
+                        help='count all syscalls per op with strace')
+    parser.add_argument('--no-strace', action='store_true',
+                        help=argparse.SUPPRESS)
+    parser.add_argument('-o', '--output', metavar='FILE',
+                        help='write the JSON here instead of stdout')
+    args = parser.parse_args()
+    args.lines = [int(x) for x in args.lines.split(',') if x]
+    return args
+
+
+def _wanted(args, names):
+    return not args.only or any(x in names for x in args.only)
+
+
+def main():
+    args = parse_args()
+    root = None
+    sim = None
+    cleanup_tree = False
+    if args.target == 'tree':
+        root = args.tree
+        if root is None:
+            root = tempfile.mkdtemp(prefix='hb_gpio_bench.')
+            cleanup_tree = True
+        sim = start_simulator(root)
+        root = sim.root
+
+    results = []
+    try:
+        GPIO = load_gpio(args.installed)
+        if _wanted(args, SYSFS_BENCHES):
+            results += bench_sysfs(GPIO, args)
+        if _wanted(args, NATIVE_BENCHES):
+            if args.chip:
+                results += bench_native(args)
+            else:
+                results.append(skipped('native.output', 'no --chip given'))
+        if _wanted(args, EDGE_BENCHES):
+            if args.edge_gpio is not None and args.edge_trigger:
+                results += bench_edge(args)
+            elif sim is not None:
+                results += bench_edge_tree(GPIO, sim, args)
+            else:
+                results.append(skipped('sysfs.edge_to_callback',
+                                       'no --edge-gpio/--edge-trigger given'))
+    finally:
+        if sim is not None:
+            sim.stop()
+        if cleanup_tree:
+            shutil.rmtree(root, ignore_errors=True)
+
+    if args.only:
+        results = [x for x in results if x['name'] in args.only]
+    if args.strace and not args.no_strace:
+        if shutil.which('strace'):
+            add_strace_counts(results, _strip_output(sys.argv[1:]))
+        else:
+            sys.stderr.write('strace not found, syscalls_per_op.total '
+                             'is not reported\n')
+
+    report = {
+        'version': FORMAT_VERSION,
+        'timestamp': int(time.time()),
+        'host': {
+            'machine': platform.machine(),
+            'kernel': platform.release(),
+            'python': platform.python_version(),
+        },
+        'target': args.target,
+        'results': results,
+    }
+    text = json.dumps(report, indent=2, sort_keys=True) + '\n'
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+def _strip_output(argv):
+    stripped = []
+    skip = False
+    for arg in argv:
+        if skip:
+            skip = False
+        elif arg in ('-o', '--output', '--only'):
+            skip = True
+        elif arg != '--strace' and not arg.startswith('--output=') and \
+                not arg.startswith('--only='):
+            stripped.append(arg)
+    return stripped
+
+
+if __name__ == '__main__':
+    sys.exit(main())
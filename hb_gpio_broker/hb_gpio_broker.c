@@ -0,0 +1,965 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <gpiod.h>
+#include <grp.h>
+#include <poll.h>
+#include <pwd.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hb_gpio_broker.h"
+
+/*
+ * Single threaded: one poll() loop serves the listening socket, the clients
+ * and the edge event fds of every requested input, so no locking is needed
+ * on the broker side and the shared table has exactly one writer.
+ */
+
+#define BROKER_CONSUMER		"hobot-gpio-broker"
+#define BROKER_GROUP		"gpio"
+#define BROKER_CONFIG		"/etc/hobot-gpio/lines.conf"
+#define ACL_MAX_IDS		8
+#define CLIENT_MAX_GROUPS	32
+#define MAX_CLIENTS		32
+#define EVENT_BUFFER_SIZE	64
+#define MAX_POLL_FDS		(1 + MAX_CLIENTS + HB_BROKER_MAX_LINES)
+
+/*
+ * Lines listed in the config file are requested at startup and held for
+ * the broker's lifetime, so nobody can take them from /dev/gpiochipN behind
+ * its back. Clients get them only if they match one of the ids, root always
+ * does, an empty list keeps the line away from everybody else.
+ */
+struct line_acl_id {
+	bool group;
+	unsigned int id;
+};
+
+struct broker_line {
+	struct gpiod_line_request *request;
+	unsigned int chip;
+	unsigned int offset;
+	int direction;
+	unsigned int users;
+	/* kernel seqno of the last edge, 0 until the first one */
+	unsigned long last_seqno;
+	bool held;
+	unsigned int num_acl;
+	struct line_acl_id acl[ACL_MAX_IDS];
+};
+
+struct broker_client {
+	int fd;
+	uid_t uid;
+	unsigned int num_groups;
+	gid_t groups[CLIENT_MAX_GROUPS];
+	uint8_t refs[HB_BROKER_MAX_LINES];
+	uint8_t edges[HB_BROKER_MAX_LINES];
+	/* events are batched per poll round and flushed in one datagram */
+	struct hb_broker_msg pending;
+	uint32_t dropped;
+};
+
+static const char *progname = "hb_gpio_broker";
+static struct hb_broker_table *table;
+static struct broker_line lines[HB_BROKER_MAX_LINES];
+static unsigned int num_lines;
+static struct broker_client clients[MAX_CLIENTS];
+static struct gpiod_edge_event_buffer *event_buffer;
+static volatile sig_atomic_t stop;
+
+static void print_error(const char *fmt, ...)
+{
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "%s: ", progname);
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, "\n");
+	va_end(va);
+}
+
+static void die_perror(const char *fmt, ...)
+{
+	int err = errno;
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "%s: ", progname);
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, ": %s\n", strerror(err));
+	va_end(va);
+
+	exit(EXIT_FAILURE);
+}
+
+static void print_help(void)
+{
+	printf("Usage: %s [OPTIONS]\n", progname);
+	printf("\n");
+	printf("Own the GPIO line requests on behalf of several processes.\n");
+	printf("\n");
+	printf("Line states are published in shared memory for lock-free reads,\n");
+	printf("writes and edge subscriptions are accepted over a UNIX socket.\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  -s, --socket <path>\tlisten on path (default: %s)\n",
+	       HB_BROKER_SOCKET);
+	printf("  -m, --shm <name>\tshared memory name (default: %s)\n",
+	       HB_BROKER_SHM);
+	printf("  -c, --config <path>\tline access list (default: %s)\n",
+	       BROKER_CONFIG);
+	printf("  -h, --help\t\tdisplay this help and exit\n");
+}
+
+/* seqlock writer side, see hb_gpio_broker.h */
+static void line_publish(unsigned int slot, int value, uint64_t timestamp_ns,
+			 uint32_t edges)
+{
+	struct hb_broker_line *entry = &table->lines[slot];
+	struct broker_line *line = &lines[slot];
+	uint32_t seq = entry->seq;
+
+	__atomic_store_n(&entry->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	entry->chip = line->chip;
+	entry->offset = line->offset;
+	entry->direction = line->direction;
+	entry->users = line->users;
+	if (value >= 0)
+		entry->value = value;
+	if (timestamp_ns)
+		entry->timestamp_ns = timestamp_ns;
+	if (edges)
+		entry->events += edges;
+	else if (line->direction == HB_BROKER_DIR_NONE)
+		entry->events = 0;
+
+	__atomic_store_n(&entry->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int line_find(unsigned int chip, unsigned int offset)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_lines; i++) {
+		if (lines[i].chip == chip && lines[i].offset == offset)
+			return i;
+	}
+	return -1;
+}
+
+/* value: HB_BROKER_INPUT/OUTPUT_*, or LINE_HOLD to leave the line as is */
+#define LINE_HOLD	-1
+
+static struct gpiod_line_config *line_config(unsigned int offset, int value,
+					     unsigned int bias)
+{
+	struct gpiod_line_settings *settings;
+	struct gpiod_line_config *line_cfg;
+	int err;
+
+	settings = gpiod_line_settings_new();
+	line_cfg = gpiod_line_config_new();
+	if (!settings || !line_cfg) {
+		gpiod_line_settings_free(settings);
+		gpiod_line_config_free(line_cfg);
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	if (value == LINE_HOLD) {
+		/* defaults: direction as is, no edge detection */
+	} else if (value == HB_BROKER_INPUT) {
+		/* inputs always watch both edges to keep the table current */
+		gpiod_line_settings_set_direction(settings,
+						  GPIOD_LINE_DIRECTION_INPUT);
+		gpiod_line_settings_set_edge_detection(settings,
+						       GPIOD_LINE_EDGE_BOTH);
+		gpiod_line_settings_set_event_clock(settings,
+						    GPIOD_LINE_CLOCK_MONOTONIC);
+		switch (bias) {
+		case HB_BROKER_BIAS_DISABLED:
+			gpiod_line_settings_set_bias(settings,
+						     GPIOD_LINE_BIAS_DISABLED);
+			break;
+		case HB_BROKER_BIAS_PULL_UP:
+			gpiod_line_settings_set_bias(settings,
+						     GPIOD_LINE_BIAS_PULL_UP);
+			break;
+		case HB_BROKER_BIAS_PULL_DOWN:
+			gpiod_line_settings_set_bias(settings,
+						     GPIOD_LINE_BIAS_PULL_DOWN);
+			break;
+		}
+	} else {
+		gpiod_line_settings_set_direction(settings,
+						  GPIOD_LINE_DIRECTION_OUTPUT);
+		gpiod_line_settings_set_output_value(settings,
+			value == HB_BROKER_OUTPUT_HIGH ?
+			GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE);
+	}
+
+	if (gpiod_line_config_add_line_settings(line_cfg, &offset, 1,
+						settings)) {
+		err = errno;
+		gpiod_line_config_free(line_cfg);
+		line_cfg = NULL;
+		errno = err;
+	}
+	gpiod_line_settings_free(settings);
+	return line_cfg;
+}
+
+static struct gpiod_line_request *line_request(unsigned int chip,
+					       unsigned int offset,
+					       int value, unsigned int bias)
+{
+	struct gpiod_request_config *req_cfg = NULL;
+	struct gpiod_line_config *line_cfg = NULL;
+	struct gpiod_line_request *request = NULL;
+	struct gpiod_chip *gpio_chip;
+	char path[32];
+	int err;
+
+	snprintf(path, sizeof(path), "/dev/gpiochip%u", chip);
+	gpio_chip = gpiod_chip_open(path);
+	if (!gpio_chip)
+		return NULL;
+
+	line_cfg = line_config(offset, value, bias);
+	req_cfg = gpiod_request_config_new();
+	if (!line_cfg || !req_cfg) {
+		if (line_cfg)
+			errno = ENOMEM;
+		goto out;
+	}
+
+	gpiod_request_config_set_consumer(req_cfg, BROKER_CONSUMER);
+	gpiod_request_config_set_event_buffer_size(req_cfg, EVENT_BUFFER_SIZE);
+
+	request = gpiod_chip_request_lines(gpio_chip, req_cfg, line_cfg);
+
+out:
+	err = errno;
+	gpiod_request_config_free(req_cfg);
+	gpiod_line_config_free(line_cfg);
+	gpiod_chip_close(gpio_chip);
+	errno = err;
+	return request;
+}
+
+/* a held line keeps its request, only the settings change hands */
+static int line_reconfigure(struct broker_line *line, int value,
+			    unsigned int bias)
+{
+	struct gpiod_line_config *line_cfg;
+	int ret, err;
+
+	line_cfg = line_config(line->offset, value, bias);
+	if (!line_cfg)
+		return -1;
+	ret = gpiod_line_request_reconfigure_lines(line->request, line_cfg);
+	err = errno;
+	gpiod_line_config_free(line_cfg);
+	errno = err;
+	return ret;
+}
+
+static bool line_allowed(const struct broker_line *line,
+			 const struct broker_client *client)
+{
+	unsigned int i, j;
+
+	if (!line->held || client->uid == 0)
+		return true;
+	for (i = 0; i < line->num_acl; i++) {
+		if (!line->acl[i].group) {
+			if (line->acl[i].id == client->uid)
+				return true;
+			continue;
+		}
+		for (j = 0; j < client->num_groups; j++) {
+			if (line->acl[i].id == client->groups[j])
+				return true;
+		}
+	}
+	return false;
+}
+
+static int do_request(struct broker_client *client,
+		      struct hb_broker_entry *entry)
+{
+	unsigned int bias = entry->arg;
+	struct broker_line *line;
+	int slot, value;
+
+	if (entry->value < HB_BROKER_INPUT ||
+	    entry->value > HB_BROKER_OUTPUT_HIGH ||
+	    entry->chip > UINT16_MAX)
+		return -EINVAL;
+
+	slot = line_find(entry->chip, entry->offset);
+	if (slot < 0) {
+		if (num_lines == HB_BROKER_MAX_LINES)
+			return -ENOSPC;
+		slot = num_lines;
+		lines[slot].chip = entry->chip;
+		lines[slot].offset = entry->offset;
+	}
+	line = &lines[slot];
+	entry->arg = slot;
+
+	if (!line_allowed(line, client))
+		return -EACCES;
+
+	if (line->users) {
+		if ((entry->value == HB_BROKER_INPUT) !=
+		    (line->direction == HB_BROKER_DIR_INPUT))
+			return -EBUSY;
+		if (client->refs[slot] == UINT8_MAX)
+			return -EMFILE;
+	} else {
+		if (line->held) {
+			if (line_reconfigure(line, entry->value, bias))
+				return -errno;
+		} else {
+			line->request = line_request(entry->chip, entry->offset,
+						     entry->value, bias);
+			if (!line->request)
+				return -errno;
+		}
+		/* the slot may be released and reused within one poll round */
+		fcntl(gpiod_line_request_get_fd(line->request), F_SETFL,
+		      O_NONBLOCK);
+		line->direction = entry->value == HB_BROKER_INPUT ?
+				  HB_BROKER_DIR_INPUT : HB_BROKER_DIR_OUTPUT;
+		value = gpiod_line_request_get_value(line->request,
+						     line->offset);
+		line->users = 1;
+		line->last_seqno = 0;
+		client->refs[slot]++;
+		line_publish(slot, value < 0 ? 0 : value, now_ns(), 0);
+		if ((unsigned int)slot == num_lines) {
+			num_lines++;
+			__atomic_store_n(&table->num_lines, num_lines,
+					 __ATOMIC_RELEASE);
+		}
+		return 0;
+	}
+
+	line->users++;
+	client->refs[slot]++;
+	line_publish(slot, -1, 0, 0);
+	return 0;
+}
+
+static void line_put(struct broker_client *client, unsigned int slot)
+{
+	struct broker_line *line = &lines[slot];
+
+	client->refs[slot]--;
+	if (!client->refs[slot])
+		client->edges[slot] = 0;
+
+	if (--line->users == 0) {
+		if (!line->held) {
+			gpiod_line_request_release(line->request);
+			line->request = NULL;
+		} else if (line_reconfigure(line, LINE_HOLD, 0)) {
+			print_error("unable to stop edge detection on %u:%u: %s",
+				    line->chip, line->offset, strerror(errno));
+		}
+		line->direction = HB_BROKER_DIR_NONE;
+	}
+	line_publish(slot, -1, 0, 0);
+}
+
+static int client_slot(struct broker_client *client,
+		       struct hb_broker_entry *entry)
+{
+	int slot = line_find(entry->chip, entry->offset);
+
+	if (slot < 0 || !client->refs[slot])
+		return -EPERM;
+	entry->arg = slot;
+	return slot;
+}
+
+static int do_release(struct broker_client *client,
+		      struct hb_broker_entry *entry)
+{
+	int slot = client_slot(client, entry);
+
+	if (slot < 0)
+		return slot;
+	line_put(client, slot);
+	return 0;
+}
+
+static int do_set(struct broker_client *client, struct hb_broker_entry *entry)
+{
+	struct broker_line *line;
+	int slot = client_slot(client, entry);
+
+	if (slot < 0)
+		return slot;
+	line = &lines[slot];
+	if (line->direction != HB_BROKER_DIR_OUTPUT)
+		return -EINVAL;
+
+	if (gpiod_line_request_set_value(line->request, line->offset,
+					 entry->value ?
+					 GPIOD_LINE_VALUE_ACTIVE :
+					 GPIOD_LINE_VALUE_INACTIVE))
+		return -errno;
+
+	line_publish(slot, !!entry->value, now_ns(), 0);
+	return 0;
+}
+
+static int do_subscribe(struct broker_client *client,
+			struct hb_broker_entry *entry, bool subscribe)
+{
+	uint32_t edges = entry->arg & (HB_BROKER_EDGE_RISING |
+				       HB_BROKER_EDGE_FALLING);
+	int slot = line_find(entry->chip, entry->offset);
+
+	/* any client may watch a line that somebody holds as an input */
+	if (slot < 0 || lines[slot].direction != HB_BROKER_DIR_INPUT)
+		return -EINVAL;
+	if (!line_allowed(&lines[slot], client))
+		return -EACCES;
+	entry->arg = slot;
+
+	if (subscribe)
+		client->edges[slot] = edges;
+	else
+		client->edges[slot] = 0;
+	return 0;
+}
+
+static void client_close(struct broker_client *client)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_lines; i++) {
+		while (client->refs[i])
+			line_put(client, i);
+		client->edges[i] = 0;
+	}
+	close(client->fd);
+	client->fd = -1;
+}
+
+static void client_send(struct broker_client *client, struct hb_broker_msg *msg)
+{
+	size_t len = sizeof(msg->hdr) + msg->hdr.count * sizeof(msg->entries[0]);
+
+	/* never block the loop on a client that stopped reading */
+	if (send(client->fd, msg, len, MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+		if (errno == EAGAIN && msg->hdr.type == HB_BROKER_EVENT)
+			client->dropped += msg->hdr.count;
+		else
+			client_close(client);
+	}
+}
+
+static void client_flush(struct broker_client *client)
+{
+	if (!client->pending.hdr.count)
+		return;
+
+	client->pending.hdr.type = HB_BROKER_EVENT;
+	client->pending.hdr.cookie = client->dropped;
+	client->dropped = 0;
+	client_send(client, &client->pending);
+	client->pending.hdr.count = 0;
+}
+
+static void client_message(struct broker_client *client)
+{
+	struct hb_broker_msg msg;
+	struct hb_broker_entry *entry;
+	ssize_t len;
+	int i, ret;
+
+	len = recv(client->fd, &msg, sizeof(msg), MSG_DONTWAIT);
+	if (len < 0 && (errno == EAGAIN || errno == EINTR))
+		return;
+	if (len < (ssize_t)sizeof(msg.hdr) ||
+	    msg.hdr.count > HB_BROKER_MAX_BATCH ||
+	    (size_t)len != sizeof(msg.hdr) +
+			   msg.hdr.count * sizeof(msg.entries[0])) {
+		client_close(client);
+		return;
+	}
+
+	for (i = 0; i < msg.hdr.count; i++) {
+		entry = &msg.entries[i];
+		switch (msg.hdr.type) {
+		case HB_BROKER_REQUEST:
+			ret = do_request(client, entry);
+			break;
+		case HB_BROKER_RELEASE:
+			ret = do_release(client, entry);
+			break;
+		case HB_BROKER_SET:
+			ret = do_set(client, entry);
+			break;
+		case HB_BROKER_SUBSCRIBE:
+			ret = do_subscribe(client, entry, true);
+			break;
+		case HB_BROKER_UNSUBSCRIBE:
+			ret = do_subscribe(client, entry, false);
+			break;
+		default:
+			ret = -EOPNOTSUPP;
+			break;
+		}
+		entry->value = ret;
+		entry->timestamp_ns = 0;
+		if (entry->arg < num_lines)
+			entry->timestamp_ns = table->lines[entry->arg].timestamp_ns;
+	}
+
+	msg.hdr.type = HB_BROKER_REPLY;
+	client_send(client, &msg);
+}
+
+/* the groups are looked up once per connection, not per request */
+static void client_credentials(struct broker_client *client)
+{
+	socklen_t len = sizeof(struct ucred);
+	struct ucred cred;
+	struct passwd *pw;
+	int num = CLIENT_MAX_GROUPS;
+
+	client->uid = (uid_t)-1;
+	if (getsockopt(client->fd, SOL_SOCKET, SO_PEERCRED, &cred, &len))
+		return;
+	client->uid = cred.uid;
+	client->groups[0] = cred.gid;
+	client->num_groups = 1;
+
+	pw = getpwuid(cred.uid);
+	if (!pw)
+		return;
+	/* the groups that fit are filled in even when there are more */
+	if (getgrouplist(pw->pw_name, cred.gid, client->groups, &num) < 0)
+		num = CLIENT_MAX_GROUPS;
+	client->num_groups = num;
+}
+
+static void client_accept(int listen_fd)
+{
+	struct broker_client *client = NULL;
+	int fd, i;
+
+	fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+	if (fd < 0)
+		return;
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			client = &clients[i];
+			break;
+		}
+	}
+	if (!client) {
+		print_error("too many clients, dropping connection");
+		close(fd);
+		return;
+	}
+
+	memset(client, 0, sizeof(*client));
+	client->fd = fd;
+	client_credentials(client);
+}
+
+static void line_events(unsigned int slot)
+{
+	struct broker_line *line = &lines[slot];
+	struct broker_client *client;
+	struct hb_broker_entry *out;
+	struct gpiod_edge_event *event;
+	int num, i, j, value;
+	unsigned long seqno;
+	uint64_t timestamp;
+	uint32_t edge, edges;
+
+	num = gpiod_line_request_read_edge_events(line->request, event_buffer,
+						  EVENT_BUFFER_SIZE);
+	for (i = 0; i < num; i++) {
+		event = gpiod_edge_event_buffer_get_event(event_buffer, i);
+		value = gpiod_edge_event_get_event_type(event) ==
+			GPIOD_EDGE_EVENT_RISING_EDGE;
+		timestamp = gpiod_edge_event_get_timestamp_ns(event);
+
+		/*
+		 * The kernel numbers edges per line, a gap means its kfifo
+		 * overflowed. The dropped edges are counted in the line's
+		 * events so clients see them as a gap in seqno.
+		 */
+		seqno = gpiod_edge_event_get_line_seqno(event);
+		edges = 1;
+		if (line->last_seqno && seqno > line->last_seqno + 1)
+			edges += seqno - line->last_seqno - 1;
+		line->last_seqno = seqno;
+		line_publish(slot, value, timestamp, edges);
+
+		edge = value ? HB_BROKER_EDGE_RISING : HB_BROKER_EDGE_FALLING;
+		for (j = 0; j < MAX_CLIENTS; j++) {
+			client = &clients[j];
+			if (client->fd < 0 || !(client->edges[slot] & edge))
+				continue;
+			if (client->pending.hdr.count == HB_BROKER_MAX_BATCH)
+				client_flush(client);
+			if (client->fd < 0)
+				continue;
+			out = &client->pending.entries[client->pending.hdr.count++];
+			out->chip = line->chip;
+			out->offset = line->offset;
+			out->value = value;
+			out->arg = slot;
+			out->seqno = table->lines[slot].events;
+			out->timestamp_ns = timestamp;
+		}
+	}
+}
+
+static void config_error(const char *path, int num, const char *what)
+{
+	print_error("%s:%d: %s", path, num, what);
+	exit(EXIT_FAILURE);
+}
+
+static void config_acl(struct broker_line *acl, char *ids, const char *path,
+		       int num)
+{
+	struct passwd *pw;
+	struct group *grp;
+	char *id;
+
+	for (id = strtok(ids, " \t\n,"); id; id = strtok(NULL, " \t\n,")) {
+		if (strcmp(id, "none") == 0)
+			continue;
+		if (acl->num_acl == ACL_MAX_IDS)
+			config_error(path, num, "too many users and groups");
+		if (id[0] == '@') {
+			grp = getgrnam(id + 1);
+			if (!grp)
+				config_error(path, num, "unknown group");
+			acl->acl[acl->num_acl].group = true;
+			acl->acl[acl->num_acl++].id = grp->gr_gid;
+		} else {
+			pw = getpwnam(id);
+			if (!pw)
+				config_error(path, num, "unknown user");
+			acl->acl[acl->num_acl].group = false;
+			acl->acl[acl->num_acl++].id = pw->pw_uid;
+		}
+	}
+}
+
+/*
+ * One line per range of lines, followed by who may request them:
+ *
+ *	gpiochip0:5-7	@camera robot
+ *
+ * "@name" is a group, "name" a user and "none" leaves only root. All the
+ * lines are requested here, in one process, before any client connects.
+ */
+static void load_config(const char *path, bool required)
+{
+	unsigned int chip, first, last, offset;
+	char buf[256], *spec, *ids;
+	struct broker_line acl, *line;
+	int num = 0, value;
+	FILE *fp;
+
+	fp = fopen(path, "r");
+	if (!fp) {
+		if (errno == ENOENT && !required)
+			return;
+		die_perror("unable to open '%s'", path);
+	}
+
+	while (fgets(buf, sizeof(buf), fp)) {
+		num++;
+		spec = strtok(buf, " \t\n");
+		if (!spec || spec[0] == '#')
+			continue;
+		ids = strtok(NULL, "");
+		if (strncmp(spec, "gpiochip", 8) == 0)
+			spec += 8;
+		value = sscanf(spec, "%u:%u-%u", &chip, &first, &last);
+		if (value == 2)
+			last = first;
+		else if (value != 3 || last < first)
+			config_error(path, num, "expected gpiochipN:offset[-offset]");
+		if (chip > UINT16_MAX)
+			config_error(path, num, "invalid chip");
+		acl.num_acl = 0;
+		if (ids)
+			config_acl(&acl, ids, path, num);
+
+		for (offset = first; offset <= last; offset++) {
+			if (line_find(chip, offset) >= 0)
+				config_error(path, num, "line listed twice");
+			if (num_lines == HB_BROKER_MAX_LINES)
+				config_error(path, num, "too many lines");
+			line = &lines[num_lines];
+			line->chip = chip;
+			line->offset = offset;
+			line->num_acl = acl.num_acl;
+			memcpy(line->acl, acl.acl, sizeof(line->acl));
+			line->request = line_request(chip, offset, LINE_HOLD, 0);
+			if (!line->request)
+				die_perror("unable to hold line %u:%u", chip,
+					   offset);
+			line->held = true;
+			value = gpiod_line_request_get_value(line->request,
+							     offset);
+			line_publish(num_lines, value < 0 ? 0 : value, now_ns(),
+				     0);
+			num_lines++;
+		}
+	}
+	fclose(fp);
+	__atomic_store_n(&table->num_lines, num_lines, __ATOMIC_RELEASE);
+}
+
+static int listen_socket(const char *path)
+{
+	struct sockaddr_un addr;
+	struct group *grp;
+	int fd;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		errno = ENAMETOOLONG;
+		die_perror("invalid socket path '%s'", path);
+	}
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		die_perror("unable to create socket");
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)))
+		die_perror("unable to bind '%s'", path);
+
+	/* same access rules as the sysfs nodes set up by 99-gpio.rules */
+	grp = getgrnam(BROKER_GROUP);
+	if (grp && chown(path, 0, grp->gr_gid))
+		print_error("unable to chown '%s': %s", path, strerror(errno));
+	chmod(path, 0660);
+
+	if (listen(fd, MAX_CLIENTS))
+		die_perror("unable to listen on '%s'", path);
+	return fd;
+}
+
+static void map_table(const char *name)
+{
+	int fd;
+
+	/*
+	 * A table from a previous run may still be mapped by clients, it is
+	 * never resized or reused: they keep reading its frozen lines until
+	 * they notice the pid stopped running, new clients get a fresh one.
+	 */
+	if (shm_unlink(name) && errno != ENOENT)
+		die_perror("unable to remove shared memory '%s'", name);
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+	if (fd < 0)
+		die_perror("unable to create shared memory '%s'", name);
+	if (ftruncate(fd, sizeof(*table)))
+		die_perror("unable to size shared memory '%s'", name);
+	fchmod(fd, 0644);
+
+	table = mmap(NULL, sizeof(*table), PROT_READ | PROT_WRITE, MAP_SHARED,
+		     fd, 0);
+	if (table == MAP_FAILED)
+		die_perror("unable to map shared memory '%s'", name);
+	close(fd);
+
+	table->version = HB_BROKER_VERSION;
+	table->max_lines = HB_BROKER_MAX_LINES;
+	table->pid = getpid();
+	__atomic_store_n(&table->magic, HB_BROKER_MAGIC, __ATOMIC_RELEASE);
+}
+
+static void handle_signal(int sig)
+{
+	(void)sig;
+	stop = 1;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option longopts[] = {
+		{ "socket",	required_argument, NULL,	's' },
+		{ "shm",	required_argument, NULL,	'm' },
+		{ "config",	required_argument, NULL,	'c' },
+		{ "help",	no_argument,	NULL,		'h' },
+		{ NULL,		0,		NULL,		0 },
+	};
+	const char *socket_path = HB_BROKER_SOCKET;
+	const char *shm_name = HB_BROKER_SHM;
+	const char *config_path = BROKER_CONFIG;
+	bool config_required = false;
+	struct pollfd fds[MAX_POLL_FDS];
+	int owners[MAX_POLL_FDS];
+	struct sigaction sa;
+	int listen_fd, optc, nfds, i;
+	unsigned int slot;
+
+	for (;;) {
+		optc = getopt_long(argc, argv, "s:m:c:h", longopts, NULL);
+		if (optc < 0)
+			break;
+
+		switch (optc) {
+		case 's':
+			socket_path = optarg;
+			break;
+		case 'm':
+			shm_name = optarg;
+			break;
+		case 'c':
+			config_path = optarg;
+			config_required = true;
+			break;
+		case 'h':
+			print_help();
+			exit(EXIT_SUCCESS);
+		default:
+			fprintf(stderr, "try %s --help\n", progname);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = handle_signal;
+	sigaction(SIGTERM, &sa, NULL);
+	sigaction(SIGINT, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	event_buffer = gpiod_edge_event_buffer_new(EVENT_BUFFER_SIZE);
+	if (!event_buffer)
+		die_perror("unable to allocate the edge event buffer");
+
+	for (i = 0; i < MAX_CLIENTS; i++)
+		clients[i].fd = -1;
+
+	map_table(shm_name);
+	load_config(config_path, config_required);
+	listen_fd = listen_socket(socket_path);
+
+	while (!stop) {
+		/* owners: -1 for the listening socket, client index, or
+		 * MAX_CLIENTS + line slot */
+		nfds = 0;
+		fds[nfds].fd = listen_fd;
+		fds[nfds].events = POLLIN;
+		owners[nfds++] = -1;
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			if (clients[i].fd < 0)
+				continue;
+			fds[nfds].fd = clients[i].fd;
+			fds[nfds].events = POLLIN;
+			owners[nfds++] = i;
+		}
+		for (slot = 0; slot < num_lines; slot++) {
+			if (lines[slot].direction != HB_BROKER_DIR_INPUT)
+				continue;
+			fds[nfds].fd = gpiod_line_request_get_fd(lines[slot].request);
+			fds[nfds].events = POLLIN;
+			owners[nfds++] = MAX_CLIENTS + slot;
+		}
+
+		if (poll(fds, nfds, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			die_perror("poll failed");
+		}
+
+		for (i = 0; i < nfds; i++) {
+			if (!fds[i].revents)
+				continue;
+			if (owners[i] < 0) {
+				client_accept(listen_fd);
+			} else if (owners[i] < MAX_CLIENTS) {
+				if (clients[owners[i]].fd != fds[i].fd)
+					continue;
+				if (fds[i].revents & POLLIN)
+					client_message(&clients[owners[i]]);
+				else
+					client_close(&clients[owners[i]]);
+			} else {
+				slot = owners[i] - MAX_CLIENTS;
+				/* released by a client earlier in this round */
+				if (lines[slot].direction == HB_BROKER_DIR_INPUT)
+					line_events(slot);
+			}
+		}
+
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			if (clients[i].fd >= 0)
+				client_flush(&clients[i]);
+		}
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].fd >= 0)
+			client_close(&clients[i]);
+	}
+	close(listen_fd);
+	unlink(socket_path);
+	/* tells the clients still mapping the table that it is dead */
+	__atomic_store_n(&table->pid, 0, __ATOMIC_RELEASE);
+	shm_unlink(shm_name);
+	gpiod_edge_event_buffer_free(event_buffer);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __HB_GPIO_BROKER_H__
+#define __HB_GPIO_BROKER_H__
+
+#include <stdint.h>
+
+/*
+ * Wire format shared between hb_gpio_broker and its clients.
+ *
+ * The broker owns every line request. Line state is published in a shared
+ * memory table that clients map read-only, each entry guarded by a seqlock:
+ * seq is odd while the broker updates the entry, readers retry until they
+ * see the same even seq before and after copying it. Entries are only ever
+ * appended, so a slot index stays valid for the broker's lifetime. A new
+ * broker creates a new table, pid is the broker that writes this one and
+ * is cleared when it exits.
+ *
+ * Requests, writes and edge subscriptions go over a SOCK_SEQPACKET socket.
+ * Every datagram is one header followed by up to HB_BROKER_MAX_BATCH
+ * entries, and the broker answers each client datagram with one REPLY
+ * carrying an entry per request entry. Edge events are pushed as EVENT
+ * datagrams on the connection that subscribed to them.
+ *
+ * All fields are in host byte order.
+ */
+
+#define HB_BROKER_SOCKET	"/run/hobot-gpio/broker.sock"
+#define HB_BROKER_SHM		"/hobot-gpio"
+
+#define HB_BROKER_MAGIC		0x4b524248	/* "HBRK" */
+#define HB_BROKER_VERSION	2
+#define HB_BROKER_MAX_LINES	256
+#define HB_BROKER_MAX_BATCH	64
+
+/* message types */
+enum {
+	HB_BROKER_REQUEST = 1,	/* value: HB_BROKER_INPUT/OUTPUT_*, arg: bias */
+	HB_BROKER_RELEASE,
+	HB_BROKER_SET,		/* value: 0 or 1 */
+	HB_BROKER_SUBSCRIBE,	/* arg: HB_BROKER_EDGE_* mask */
+	HB_BROKER_UNSUBSCRIBE,
+	HB_BROKER_REPLY,	/* value: 0 or -errno, arg: slot */
+	HB_BROKER_EVENT,	/* value: new level, arg: slot, seqno */
+};
+
+/* HB_BROKER_REQUEST values */
+enum {
+	HB_BROKER_INPUT = 0,
+	HB_BROKER_OUTPUT_LOW,
+	HB_BROKER_OUTPUT_HIGH,
+};
+
+/* HB_BROKER_REQUEST args */
+enum {
+	HB_BROKER_BIAS_AS_IS = 0,
+	HB_BROKER_BIAS_DISABLED,
+	HB_BROKER_BIAS_PULL_UP,
+	HB_BROKER_BIAS_PULL_DOWN,
+};
+
+/* HB_BROKER_SUBSCRIBE args */
+#define HB_BROKER_EDGE_RISING	1
+#define HB_BROKER_EDGE_FALLING	2
+
+/* hb_broker_line.direction */
+enum {
+	HB_BROKER_DIR_NONE = 0,
+	HB_BROKER_DIR_INPUT,
+	HB_BROKER_DIR_OUTPUT,
+};
+
+struct hb_broker_line {
+	uint32_t seq;
+	uint16_t chip;		/* N of /dev/gpiochipN */
+	uint8_t direction;
+	uint8_t value;
+	uint32_t offset;
+	uint32_t events;	/* edges since the line was requested, with
+				   the ones the kernel dropped */
+	uint64_t timestamp_ns;	/* of the last edge or write */
+	uint32_t users;
+	uint32_t reserved;
+};
+
+struct hb_broker_table {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t max_lines;
+	uint32_t num_lines;
+	uint32_t pid;
+	uint8_t reserved[16];
+	struct hb_broker_line lines[HB_BROKER_MAX_LINES];
+};
+
+struct hb_broker_hdr {
+	uint16_t type;
+	uint16_t count;
+	uint32_t cookie;	/* echoed in REPLY, dropped events in EVENT */
+};
+
+struct hb_broker_entry {
+	uint32_t chip;
+	uint32_t offset;
+	int32_t value;
+	uint32_t arg;
+	uint32_t seqno;		/* events of the line at this edge */
+	uint32_t reserved;
+	uint64_t timestamp_ns;
+};
+
+struct hb_broker_msg {
+	struct hb_broker_hdr hdr;
+	struct hb_broker_entry entries[HB_BROKER_MAX_BATCH];
+};
+
+_Static_assert(sizeof(struct hb_broker_line) == 32, "line entry layout");
+_Static_assert(sizeof(struct hb_broker_hdr) == 8, "header layout");
+_Static_assert(sizeof(struct hb_broker_entry) == 32, "entry layout");
+
+#endif /* __HB_GPIO_BROKER_H__ */
@@ -0,0 +1,524 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __HOBOT_GPIO_HPP__
+#define __HOBOT_GPIO_HPP__
+
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <gpiod.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+#include "gpio_pins.hpp"
+
+/*
+ * Header-only C++17 access to the 40 pin header of the RDK boards.
+ *
+ * Pins are named by strongly typed ids generated from the Hobot.GPIO board
+ * tables, e.g. rdk_x5::BOARD::P11, rdk_x5::BCM::GPIO17 or
+ * rdk_x5::SOC::GPIO380, so a pin of another board or a number that is not
+ * on the header does not compile.
+ *
+ * A PinGroup works out at compile time which controller every pin sits on
+ * and which bit of the group mask it owns, then requests each controller
+ * once: set() and get() cost one ioctl per controller and no table lookup.
+ * Only the sysfs base of each controller is read when the group is opened,
+ * it is assigned by the kernel at probe time.
+ *
+ *	using namespace hobot::gpio;
+ *	using Leds = PinGroup<rdk_x5::BOARD::P11, rdk_x5::BOARD::P13>;
+ *
+ *	Leds leds(Direction::Output);
+ *	leds.set(Leds::mask<rdk_x5::BOARD::P13>());
+ *
+ * Errors are reported with std::system_error.
+ */
+
+namespace hobot {
+namespace gpio {
+
+enum class Direction {
+	Input,
+	Output,
+};
+
+namespace detail {
+
+inline constexpr const char *consumer = "hobot-gpio";
+inline constexpr const char *platform_path = "/sys/devices/platform/";
+inline constexpr const char *board_id_path = "/sys/class/socinfo/board_id";
+inline constexpr const char *soc_name_path = "/sys/class/socinfo/soc_name";
+
+[[noreturn]] inline void fail(const std::string &what, int err = errno)
+{
+	throw std::system_error(err, std::generic_category(), what);
+}
+
+inline std::string read_file(const std::string &path)
+{
+	char buf[64];
+	ssize_t len;
+	int fd;
+
+	fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		fail("unable to open " + path);
+	len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (len < 0)
+		fail("unable to read " + path);
+	while (len > 0 && std::isspace(static_cast<unsigned char>(buf[len - 1])))
+		len--;
+	return std::string(buf, len);
+}
+
+inline void write_file(int fd, const std::string &what, uint64_t value)
+{
+	std::string str = std::to_string(value);
+
+	if (pwrite(fd, str.data(), str.size(), 0) < 0)
+		fail("unable to write " + what);
+}
+
+inline std::string find_entry(const std::string &dir, const char *prefix)
+{
+	std::unique_ptr<DIR, int (*)(DIR *)> d(opendir(dir.c_str()), closedir);
+	std::string prefix_str(prefix);
+	struct dirent *entry;
+
+	if (!d)
+		fail("unable to open " + dir);
+	while ((entry = readdir(d.get()))) {
+		if (std::string(entry->d_name).compare(0, prefix_str.size(),
+						       prefix_str) == 0)
+			return entry->d_name;
+	}
+	fail(std::string(prefix) + " not found in " + dir, ENODEV);
+}
+
+/* the same resolution as gpio_pin_data.get_gpio_line() */
+struct Chip {
+	std::string path;
+	unsigned int base;
+};
+
+inline Chip resolve_chip(const char *controller)
+{
+	std::string dir = std::string(platform_path) + controller;
+	std::string sysfs = dir + "/gpio/" + find_entry(dir + "/gpio", "gpiochip");
+
+	return { "/dev/" + find_entry(dir, "gpiochip"),
+		 static_cast<unsigned int>(std::stoul(read_file(sysfs + "/base"))) };
+}
+
+inline void check_board(Board board)
+{
+	const BoardDesc &desc = describe(board);
+	unsigned long id;
+	std::string soc;
+
+	soc = read_file(soc_name_path);
+	for (auto &c : soc)
+		c = std::tolower(static_cast<unsigned char>(c));
+	id = std::stoul(read_file(board_id_path), nullptr, 16) & 0xfff;
+
+	if (soc.find(desc.soc) != std::string::npos) {
+		for (std::size_t i = 0; i < desc.num_board_ids; i++) {
+			if (desc.board_ids[i] == id)
+				return;
+		}
+	}
+	throw std::runtime_error(std::string("hobot::gpio: pins were built for ") +
+				 desc.name + ", this board is not one");
+}
+
+inline gpiod_line_request *request_lines(const std::string &chip_path,
+					 const unsigned int *offsets,
+					 std::size_t num_offsets,
+					 Direction direction,
+					 const gpiod_line_value *values)
+{
+	std::unique_ptr<gpiod_chip, void (*)(gpiod_chip *)>
+		chip(gpiod_chip_open(chip_path.c_str()), gpiod_chip_close);
+	std::unique_ptr<gpiod_line_settings, void (*)(gpiod_line_settings *)>
+		settings(gpiod_line_settings_new(), gpiod_line_settings_free);
+	std::unique_ptr<gpiod_line_config, void (*)(gpiod_line_config *)>
+		line_cfg(gpiod_line_config_new(), gpiod_line_config_free);
+	std::unique_ptr<gpiod_request_config, void (*)(gpiod_request_config *)>
+		req_cfg(gpiod_request_config_new(), gpiod_request_config_free);
+	gpiod_line_request *request;
+
+	if (!chip)
+		fail("unable to open " + chip_path);
+	if (!settings || !line_cfg || !req_cfg)
+		fail("unable to allocate the line config", ENOMEM);
+
+	gpiod_line_settings_set_direction(settings.get(),
+		direction == Direction::Output ? GPIOD_LINE_DIRECTION_OUTPUT :
+						 GPIOD_LINE_DIRECTION_INPUT);
+	if (gpiod_line_config_add_line_settings(line_cfg.get(), offsets,
+						num_offsets, settings.get()))
+		fail("unable to configure lines on " + chip_path);
+	if (direction == Direction::Output &&
+	    gpiod_line_config_set_output_values(line_cfg.get(), values,
+						num_offsets))
+		fail("unable to set initial values on " + chip_path);
+	gpiod_request_config_set_consumer(req_cfg.get(), consumer);
+
+	request = gpiod_chip_request_lines(chip.get(), req_cfg.get(),
+					   line_cfg.get());
+	if (!request)
+		fail("unable to request lines on " + chip_path);
+	return request;
+}
+
+} /* namespace detail */
+
+template <auto... Pins>
+class PinGroup {
+public:
+	static constexpr std::size_t size = sizeof...(Pins);
+
+private:
+	static constexpr std::array<PinDesc, size> descs = { describe(Pins)... };
+
+	static constexpr bool same_board()
+	{
+		for (std::size_t i = 1; i < size; i++) {
+			if (descs[i].board != descs[0].board)
+				return false;
+		}
+		return true;
+	}
+
+	static constexpr bool unique()
+	{
+		for (std::size_t i = 0; i < size; i++) {
+			for (std::size_t j = i + 1; j < size; j++) {
+				if (descs[i].soc == descs[j].soc)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(size > 0 && size <= 64, "a PinGroup holds 1 to 64 pins");
+	static_assert(same_board(), "the pins of a PinGroup must be of one board");
+	static_assert(unique(), "a pin appears twice in the PinGroup");
+
+	static constexpr std::size_t count_chips()
+	{
+		uint64_t seen = 0;
+		std::size_t num = 0;
+
+		for (std::size_t i = 0; i < size; i++) {
+			if (!(seen & (uint64_t(1) << descs[i].chip)))
+				num++;
+			seen |= uint64_t(1) << descs[i].chip;
+		}
+		return num;
+	}
+
+public:
+	static constexpr std::size_t num_chips = count_chips();
+	static constexpr uint64_t all = size == 64 ? ~uint64_t(0) :
+						    (uint64_t(1) << size) - 1;
+
+private:
+	struct Layout {
+		/* first pin of each controller, to name it */
+		std::array<std::size_t, num_chips> first{};
+		/* group bits owned by each controller */
+		std::array<uint64_t, num_chips> mask{};
+	};
+
+	static constexpr Layout make_layout()
+	{
+		Layout layout{};
+		std::size_t num = 0, c = 0;
+
+		for (std::size_t i = 0; i < size; i++) {
+			for (c = 0; c < num; c++) {
+				if (descs[layout.first[c]].chip == descs[i].chip)
+					break;
+			}
+			if (c == num)
+				layout.first[num++] = i;
+			layout.mask[c] |= uint64_t(1) << i;
+		}
+		return layout;
+	}
+
+	static constexpr Layout layout = make_layout();
+
+	template <auto Pin>
+	static constexpr std::size_t index_of()
+	{
+		for (std::size_t i = 0; i < size; i++) {
+			if (descs[i].board == describe(Pin).board &&
+			    descs[i].soc == describe(Pin).soc)
+				return i;
+		}
+		return size;
+	}
+
+public:
+	/* bit of Pin in the masks taken and returned by set() and get() */
+	template <auto Pin>
+	static constexpr uint64_t mask()
+	{
+		constexpr std::size_t i = index_of<Pin>();
+
+		static_assert(i < size, "the pin is not part of this PinGroup");
+		return uint64_t(1) << i;
+	}
+
+	/* initial holds the output levels, one bit per pin in group order */
+	explicit PinGroup(Direction direction, uint64_t initial = 0)
+	{
+		detail::check_board(descs[0].board);
+
+		try {
+			for (std::size_t c = 0; c < num_chips; c++)
+				open_chip(c, direction, initial);
+		} catch (...) {
+			release();
+			throw;
+		}
+	}
+
+	~PinGroup()
+	{
+		release();
+	}
+
+	PinGroup(const PinGroup &) = delete;
+	PinGroup &operator=(const PinGroup &) = delete;
+
+	void set(uint64_t levels)
+	{
+		set(all, levels);
+	}
+
+	void set(uint64_t mask, uint64_t levels)
+	{
+		unsigned int offsets[size];
+		gpiod_line_value values[size];
+		std::size_t num, i;
+		uint64_t bits;
+
+		for (std::size_t c = 0; c < num_chips; c++) {
+			bits = mask & layout.mask[c];
+			for (num = 0; bits; bits &= bits - 1, num++) {
+				i = __builtin_ctzll(bits);
+				offsets[num] = offsets_[i];
+				values[num] = (levels >> i) & 1 ?
+					      GPIOD_LINE_VALUE_ACTIVE :
+					      GPIOD_LINE_VALUE_INACTIVE;
+			}
+			if (num && gpiod_line_request_set_values_subset(
+					requests_[c], num, offsets, values))
+				detail::fail("unable to set gpio lines");
+		}
+	}
+
+	uint64_t get(uint64_t mask = all) const
+	{
+		unsigned int offsets[size];
+		gpiod_line_value values[size];
+		std::size_t num, i, n;
+		uint64_t bits, levels = 0;
+
+		for (std::size_t c = 0; c < num_chips; c++) {
+			bits = mask & layout.mask[c];
+			for (num = 0; bits; bits &= bits - 1)
+				offsets[num++] = offsets_[__builtin_ctzll(bits)];
+			if (!num)
+				continue;
+			if (gpiod_line_request_get_values_subset(
+					requests_[c], num, offsets, values))
+				detail::fail("unable to get gpio lines");
+			bits = mask & layout.mask[c];
+			for (n = 0; bits; bits &= bits - 1, n++) {
+				i = __builtin_ctzll(bits);
+				if (values[n] == GPIOD_LINE_VALUE_ACTIVE)
+					levels |= uint64_t(1) << i;
+			}
+		}
+		return levels;
+	}
+
+private:
+	void open_chip(std::size_t c, Direction direction, uint64_t initial)
+	{
+		detail::Chip chip = detail::resolve_chip(
+			descs[layout.first[c]].gpio_chip);
+		unsigned int offsets[size];
+		gpiod_line_value values[size];
+		std::size_t num = 0, i;
+		uint64_t bits;
+
+		for (bits = layout.mask[c]; bits; bits &= bits - 1, num++) {
+			i = __builtin_ctzll(bits);
+			offsets_[i] = descs[i].soc - chip.base;
+			offsets[num] = offsets_[i];
+			values[num] = (initial >> i) & 1 ?
+				      GPIOD_LINE_VALUE_ACTIVE :
+				      GPIOD_LINE_VALUE_INACTIVE;
+		}
+		requests_[c] = detail::request_lines(chip.path, offsets, num,
+						     direction, values);
+	}
+
+	void release()
+	{
+		for (auto &request : requests_) {
+			if (request)
+				gpiod_line_request_release(request);
+			request = nullptr;
+		}
+	}
+
+	std::array<gpiod_line_request *, num_chips> requests_{};
+	std::array<unsigned int, size> offsets_{};
+};
+
+/* a single line is a group of one, set(1)/get() drive and read it */
+template <auto Pin>
+using Line = PinGroup<Pin>;
+
+/*
+ * Hardware PWM through the sysfs pwm class. Pins without a PWM channel are
+ * rejected at compile time.
+ */
+template <auto Pin>
+class Pwm {
+	static constexpr const PinDesc &desc = describe(Pin);
+
+	static_assert(desc.pwm_id >= 0, "the pin has no PWM channel");
+
+public:
+	Pwm(uint64_t period_ns, uint64_t duty_cycle_ns = 0)
+	{
+		std::string dir = std::string(detail::platform_path) +
+				  desc.pwm_chip + "/pwm";
+		std::string chip = dir + "/" + detail::find_entry(dir, "pwmchip");
+		std::string id = std::to_string(desc.pwm_id);
+		std::string pwm = chip + "/pwm" + id;
+
+		if (access(pwm.c_str(), F_OK)) {
+			int fd = open((chip + "/export").c_str(),
+				      O_WRONLY | O_CLOEXEC);
+
+			if (fd < 0)
+				detail::fail("unable to export " + pwm);
+			if (write(fd, id.data(), id.size()) < 0 && errno != EBUSY) {
+				close(fd);
+				detail::fail("unable to export " + pwm);
+			}
+			close(fd);
+		}
+
+		/* udev fixes up the permissions after the export */
+		for (int retry = 0; retry < 500; retry++) {
+			if (!access((pwm + "/enable").c_str(), R_OK | W_OK))
+				break;
+			usleep(10000);
+		}
+
+		try {
+			fd_period_ = open_attr(pwm + "/period");
+			fd_duty_cycle_ = open_attr(pwm + "/duty_cycle");
+			fd_enable_ = open_attr(pwm + "/enable");
+			period_ = std::stoull(detail::read_file(pwm + "/period"));
+			configure(period_ns, duty_cycle_ns);
+		} catch (...) {
+			close_attrs();
+			throw;
+		}
+	}
+
+	~Pwm()
+	{
+		if (fd_enable_ >= 0)
+			pwrite(fd_enable_, "0", 1, 0);
+		close_attrs();
+	}
+
+	Pwm(const Pwm &) = delete;
+	Pwm &operator=(const Pwm &) = delete;
+
+	/* the kernel rejects duty_cycle > period, order the writes for it */
+	void configure(uint64_t period_ns, uint64_t duty_cycle_ns)
+	{
+		if (period_ns >= period_) {
+			detail::write_file(fd_period_, "pwm period", period_ns);
+			detail::write_file(fd_duty_cycle_, "pwm duty_cycle",
+					   duty_cycle_ns);
+		} else {
+			detail::write_file(fd_duty_cycle_, "pwm duty_cycle",
+					   duty_cycle_ns);
+			detail::write_file(fd_period_, "pwm period", period_ns);
+		}
+		period_ = period_ns;
+	}
+
+	void duty_cycle(uint64_t duty_cycle_ns)
+	{
+		detail::write_file(fd_duty_cycle_, "pwm duty_cycle", duty_cycle_ns);
+	}
+
+	void enable(bool on = true)
+	{
+		detail::write_file(fd_enable_, "pwm enable", on);
+	}
+
+private:
+	static int open_attr(const std::string &path)
+	{
+		int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+
+		if (fd < 0)
+			detail::fail("unable to open " + path);
+		return fd;
+	}
+
+	void close_attrs()
+	{
+		for (int *fd : { &fd_period_, &fd_duty_cycle_, &fd_enable_ }) {
+			if (*fd >= 0)
+				close(*fd);
+			*fd = -1;
+		}
+	}
+
+	int fd_period_ = -1;
+	int fd_duty_cycle_ = -1;
+	int fd_enable_ = -1;
+	uint64_t period_ = 0;
+};
+
+} /* namespace gpio */
+} /* namespace hobot */
+
+#endif /* __HOBOT_GPIO_HPP__ */
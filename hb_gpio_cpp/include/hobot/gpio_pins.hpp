@@ -0,0 +1,1106 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+#ifndef __HOBOT_GPIO_PINS_HPP__
+#define __HOBOT_GPIO_PINS_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hobot {
+namespace gpio {
+
+enum class Board : uint8_t {
+	X3SDBV3,
+	X3SDB,
+	X3PI,
+	X3CM,
+	X3PI_V2_1,
+	RDK_X5,
+	EVB_X5,
+};
+
+struct PinDesc {
+	Board board;
+	uint8_t board_pin;	/* BOARD mode number */
+	uint8_t bcm;		/* BCM mode number */
+	uint16_t soc;		/* SOC mode number, the sysfs gpio id */
+	uint8_t chip;		/* index of gpio_chip in the board's chip list */
+	int8_t pwm_id;		/* -1 when the pin has no PWM channel */
+	const char *gpio_chip;	/* controller under /sys/devices/platform */
+	const char *pwm_chip;
+	const char *cvm_name;
+	const char *soc_name;
+};
+
+struct BoardDesc {
+	Board board;
+	const char *name;
+	const char *soc;	/* matched against /sys/class/socinfo/soc_name */
+	const uint16_t *board_ids;
+	std::size_t num_board_ids;
+};
+
+namespace x3sdbv3 {
+
+inline constexpr uint16_t board_ids[] = { 0x304 };
+
+inline constexpr BoardDesc board = {
+	Board::X3SDBV3, "X3SDBV3", "x3", board_ids, 1,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::X3SDBV3, 3, 2, 11, 0, -1, "soc/a6003000.gpio", nullptr, "I2C1_SDA", "I2C1_SDA" },
+	{ Board::X3SDBV3, 5, 3, 10, 0, -1, "soc/a6003000.gpio", nullptr, "I2C1_SCL", "I2C1_SCL" },
+	{ Board::X3SDBV3, 7, 4, 38, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO38", "GPIO38" },
+	{ Board::X3SDBV3, 11, 17, 6, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO6", "JTG_TDI" },
+	{ Board::X3SDBV3, 13, 27, 5, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO5", "JTG_TMS" },
+	{ Board::X3SDBV3, 15, 22, 30, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO30", "BIFSPI_MISO" },
+	{ Board::X3SDBV3, 19, 10, 18, 0, 2, "soc/a6003000.gpio", "soc/a500e000.pwm", "SPI0_MOSI", "SPI0_MOSI" },
+	{ Board::X3SDBV3, 21, 9, 19, 0, 0, "soc/a6003000.gpio", "soc/a500f000.pwm", "SPI0_MISO", "SPI0_MISO" },
+	{ Board::X3SDBV3, 23, 11, 17, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_SCLK", "SPI0_SCLK" },
+	{ Board::X3SDBV3, 29, 5, 14, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO14", "SPI2_SCLK" },
+	{ Board::X3SDBV3, 31, 6, 31, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO31", "BIFSPI_RSTN" },
+	{ Board::X3SDBV3, 33, 13, 13, 0, 2, "soc/a6003000.gpio", "soc/a500f000.pwm", "PWM8", "SPI2_MISO" },
+	{ Board::X3SDBV3, 35, 19, 103, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_LRCK", "I2S0_LRCK" },
+	{ Board::X3SDBV3, 37, 26, 29, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO29", "BIFSPI_MOSI" },
+	{ Board::X3SDBV3, 8, 14, 95, 0, -1, "soc/a6003000.gpio", nullptr, "UART0_TXD", "UART0_TXD" },
+	{ Board::X3SDBV3, 10, 15, 96, 0, -1, "soc/a6003000.gpio", nullptr, "UART0_RXD", "UART0_RXD" },
+	{ Board::X3SDBV3, 12, 18, 102, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_BCLK", "I2S0_BCLK" },
+	{ Board::X3SDBV3, 16, 23, 27, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO27", "BIFSPI_CSN" },
+	{ Board::X3SDBV3, 18, 24, 7, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO7", "JTG_TDO" },
+	{ Board::X3SDBV3, 22, 25, 15, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO15", "SPI2_CSN" },
+	{ Board::X3SDBV3, 24, 8, 16, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_CSN", "I2C4_SDA" },
+	{ Board::X3SDBV3, 26, 7, 120, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_CSN1", "QSPI_CSN1" },
+	{ Board::X3SDBV3, 32, 12, 12, 0, 1, "soc/a6003000.gpio", "soc/a500f000.pwm", "PWM7", "SPI2_MOSI" },
+	{ Board::X3SDBV3, 36, 16, 28, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO28", "BIFSPI_SCLK" },
+	{ Board::X3SDBV3, 38, 20, 104, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_SDIO", "I2S0_SDIO" },
+	{ Board::X3SDBV3, 40, 21, 108, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_SDIO", "I2S1_SDIO" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 14,
+	P10 = 15,
+	P11 = 3,
+	P12 = 16,
+	P13 = 4,
+	P15 = 5,
+	P16 = 17,
+	P18 = 18,
+	P19 = 6,
+	P21 = 7,
+	P22 = 19,
+	P23 = 8,
+	P24 = 20,
+	P26 = 21,
+	P29 = 9,
+	P31 = 10,
+	P32 = 22,
+	P33 = 11,
+	P35 = 12,
+	P36 = 23,
+	P37 = 13,
+	P38 = 24,
+	P40 = 25,
+};
+
+enum class BCM : uint8_t {
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 9,
+	GPIO6 = 10,
+	GPIO7 = 21,
+	GPIO8 = 20,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 22,
+	GPIO13 = 11,
+	GPIO14 = 14,
+	GPIO15 = 15,
+	GPIO16 = 23,
+	GPIO17 = 3,
+	GPIO18 = 16,
+	GPIO19 = 12,
+	GPIO20 = 24,
+	GPIO21 = 25,
+	GPIO22 = 5,
+	GPIO23 = 17,
+	GPIO24 = 18,
+	GPIO25 = 19,
+	GPIO26 = 13,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO5 = 4,
+	GPIO6 = 3,
+	GPIO7 = 18,
+	GPIO10 = 1,
+	GPIO11 = 0,
+	GPIO12 = 22,
+	GPIO13 = 11,
+	GPIO14 = 9,
+	GPIO15 = 19,
+	GPIO16 = 20,
+	GPIO17 = 8,
+	GPIO18 = 6,
+	GPIO19 = 7,
+	GPIO27 = 17,
+	GPIO28 = 23,
+	GPIO29 = 13,
+	GPIO30 = 5,
+	GPIO31 = 10,
+	GPIO38 = 2,
+	GPIO95 = 14,
+	GPIO96 = 15,
+	GPIO102 = 16,
+	GPIO103 = 12,
+	GPIO104 = 24,
+	GPIO108 = 25,
+	GPIO120 = 21,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace x3sdbv3 */
+
+namespace x3sdb {
+
+inline constexpr uint16_t board_ids[] = { 0x404 };
+
+inline constexpr BoardDesc board = {
+	Board::X3SDB, "X3SDB", "x3", board_ids, 1,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::X3SDB, 3, 2, 11, 0, -1, "soc/a6003000.gpio", nullptr, "I2C1_SDA", "I2C1_SDA" },
+	{ Board::X3SDB, 5, 3, 10, 0, -1, "soc/a6003000.gpio", nullptr, "I2C1_SCL", "I2C1_SCL" },
+	{ Board::X3SDB, 7, 4, 101, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_MCLK", "I2S0_MCLK" },
+	{ Board::X3SDB, 11, 17, 6, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO6", "JTG_TDI" },
+	{ Board::X3SDB, 13, 27, 5, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO5", "JTG_TMS" },
+	{ Board::X3SDB, 15, 22, 30, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO30", "BIFSPI_MISO" },
+	{ Board::X3SDB, 19, 10, 18, 0, 2, "soc/a6003000.gpio", "soc/a500e000.pwm", "SPI0_MOSI", "SPI0_MOSI" },
+	{ Board::X3SDB, 21, 9, 19, 0, 0, "soc/a6003000.gpio", "soc/a500f000.pwm", "SPI0_MISO", "SPI0_MISO" },
+	{ Board::X3SDB, 23, 11, 17, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_SCLK", "SPI0_SCLK" },
+	{ Board::X3SDB, 27, 0, 106, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_BLCK", "I2S1_BLCK" },
+	{ Board::X3SDB, 29, 5, 14, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO14", "SPI2_SCLK" },
+	{ Board::X3SDB, 31, 6, 31, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO31", "BIFSPI_RSTN" },
+	{ Board::X3SDB, 33, 13, 4, 0, 0, "soc/a6003000.gpio", "soc/a500d000.pwm", "PWM0", "PWM0" },
+	{ Board::X3SDB, 35, 19, 103, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_LRCK", "I2S0_LRCK" },
+	{ Board::X3SDB, 37, 26, 105, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO105", "I2S1_MCLK" },
+	{ Board::X3SDB, 8, 14, 111, 0, -1, "soc/a6003000.gpio", nullptr, "UART3_TXD", "UART3_TXD" },
+	{ Board::X3SDB, 10, 15, 112, 0, -1, "soc/a6003000.gpio", nullptr, "UART3_RXD", "UART3_RXD" },
+	{ Board::X3SDB, 12, 18, 102, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_BCLK", "I2S0_BCLK" },
+	{ Board::X3SDB, 16, 23, 27, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO27", "BIFSPI_CSN" },
+	{ Board::X3SDB, 18, 24, 7, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO7", "JTG_TDO" },
+	{ Board::X3SDB, 22, 25, 15, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO15", "SPI2_CSN" },
+	{ Board::X3SDB, 24, 8, 16, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_CSN", "I2C4_SDA" },
+	{ Board::X3SDB, 26, 7, 120, 0, -1, "soc/a6003000.gpio", nullptr, "SPI0_CSN1", "QSPI_CSN1" },
+	{ Board::X3SDB, 28, 1, 107, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_LRCK", "I2S1_LRCK" },
+	{ Board::X3SDB, 32, 12, 25, 0, 1, "soc/a6003000.gpio", "soc/a500e000.pwm", "PWM4", "PWM4" },
+	{ Board::X3SDB, 36, 16, 3, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO3", "JTG_TCK" },
+	{ Board::X3SDB, 38, 20, 104, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_SDIO", "I2S0_SDIO" },
+	{ Board::X3SDB, 40, 21, 108, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_SDIO", "I2S1_SDIO" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P36 = 25,
+	P37 = 14,
+	P38 = 26,
+	P40 = 27,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO16 = 25,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 26,
+	GPIO21 = 27,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO3 = 25,
+	GPIO4 = 12,
+	GPIO5 = 4,
+	GPIO6 = 3,
+	GPIO7 = 19,
+	GPIO10 = 1,
+	GPIO11 = 0,
+	GPIO14 = 10,
+	GPIO15 = 20,
+	GPIO16 = 21,
+	GPIO17 = 8,
+	GPIO18 = 6,
+	GPIO19 = 7,
+	GPIO25 = 24,
+	GPIO27 = 18,
+	GPIO30 = 5,
+	GPIO31 = 11,
+	GPIO101 = 2,
+	GPIO102 = 17,
+	GPIO103 = 13,
+	GPIO104 = 26,
+	GPIO105 = 14,
+	GPIO106 = 9,
+	GPIO107 = 23,
+	GPIO108 = 27,
+	GPIO111 = 15,
+	GPIO112 = 16,
+	GPIO120 = 22,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace x3sdb */
+
+namespace x3pi {
+
+inline constexpr uint16_t board_ids[] = { 0x504, 0x604 };
+
+inline constexpr BoardDesc board = {
+	Board::X3PI, "X3PI", "x3", board_ids, 2,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::X3PI, 3, 2, 9, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SDA", "I2C0_SDA" },
+	{ Board::X3PI, 5, 3, 8, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SCL", "I2C0_SCL" },
+	{ Board::X3PI, 7, 4, 101, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_MCLK", "I2S0_MCLK" },
+	{ Board::X3PI, 11, 17, 6, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO6", "JTG_TDI" },
+	{ Board::X3PI, 13, 27, 5, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO5", "JTG_TMS" },
+	{ Board::X3PI, 15, 22, 30, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO30", "BIFSPI_MISO" },
+	{ Board::X3PI, 19, 10, 12, 0, 1, "soc/a6003000.gpio", "soc/a500f000.pwm", "SPI2_MOSI", "SPI2_MOSI" },
+	{ Board::X3PI, 21, 9, 13, 0, 2, "soc/a6003000.gpio", "soc/a500f000.pwm", "SPI2_MISO", "SPI2_MISO" },
+	{ Board::X3PI, 23, 11, 14, 0, -1, "soc/a6003000.gpio", nullptr, "SPI2_SCLK", "SPI2_SCLK" },
+	{ Board::X3PI, 27, 0, 106, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_BCLK", "I2S1_BCLK" },
+	{ Board::X3PI, 29, 5, 119, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO119", "GPIO119" },
+	{ Board::X3PI, 31, 6, 118, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO118", "GPIO118" },
+	{ Board::X3PI, 33, 13, 4, 0, 0, "soc/a6003000.gpio", "soc/a500d000.pwm", "PWM0", "JTG_TRSTN" },
+	{ Board::X3PI, 35, 19, 103, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_LRCK", "I2S0_LRCK" },
+	{ Board::X3PI, 37, 26, 105, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO105", "I2S1_MCLK" },
+	{ Board::X3PI, 8, 14, 111, 0, -1, "soc/a6003000.gpio", nullptr, "UART_TXD", "SENSOR2_MCLK" },
+	{ Board::X3PI, 10, 15, 112, 0, -1, "soc/a6003000.gpio", nullptr, "UART_RXD", "SENSOR3_MCLK" },
+	{ Board::X3PI, 12, 18, 102, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_BCLK", "I2S0_BCLK" },
+	{ Board::X3PI, 16, 23, 27, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO27", "BIFSPI_CSN" },
+	{ Board::X3PI, 18, 24, 7, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO7", "JTG_TDO" },
+	{ Board::X3PI, 22, 25, 29, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO29", "BIFSPI_MOSI" },
+	{ Board::X3PI, 24, 8, 15, 0, -1, "soc/a6003000.gpio", nullptr, "SPI2_CSN", "SPI2_CSN" },
+	{ Board::X3PI, 26, 7, 28, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO28", "BIFSPI_SCLK" },
+	{ Board::X3PI, 28, 1, 107, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_LRCK", "I2S1_LRCK" },
+	{ Board::X3PI, 32, 12, 25, 0, 1, "soc/a6003000.gpio", "soc/a500e000.pwm", "PWM4", "PWM4" },
+	{ Board::X3PI, 36, 16, 3, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO3", "JTG_TCK" },
+	{ Board::X3PI, 38, 20, 104, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_SDIO", "I2S0_SDIO" },
+	{ Board::X3PI, 40, 21, 108, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_SDIO", "I2S1_SDIO" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P36 = 25,
+	P37 = 14,
+	P38 = 26,
+	P40 = 27,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO16 = 25,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 26,
+	GPIO21 = 27,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO3 = 25,
+	GPIO4 = 12,
+	GPIO5 = 4,
+	GPIO6 = 3,
+	GPIO7 = 19,
+	GPIO8 = 1,
+	GPIO9 = 0,
+	GPIO12 = 6,
+	GPIO13 = 7,
+	GPIO14 = 8,
+	GPIO15 = 21,
+	GPIO25 = 24,
+	GPIO27 = 18,
+	GPIO28 = 22,
+	GPIO29 = 20,
+	GPIO30 = 5,
+	GPIO101 = 2,
+	GPIO102 = 17,
+	GPIO103 = 13,
+	GPIO104 = 26,
+	GPIO105 = 14,
+	GPIO106 = 9,
+	GPIO107 = 23,
+	GPIO108 = 27,
+	GPIO111 = 15,
+	GPIO112 = 16,
+	GPIO118 = 11,
+	GPIO119 = 10,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace x3pi */
+
+namespace x3cm {
+
+inline constexpr uint16_t board_ids[] = { 0xb04 };
+
+inline constexpr BoardDesc board = {
+	Board::X3CM, "X3CM", "x3", board_ids, 1,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::X3CM, 3, 2, 9, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SDA", "I2C0_SDA" },
+	{ Board::X3CM, 5, 3, 8, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SCL", "I2C0_SCL" },
+	{ Board::X3CM, 7, 4, 101, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_MCLK", "I2S0_MCLK" },
+	{ Board::X3CM, 11, 17, 12, 0, 1, "soc/a6003000.gpio", "soc/a500f000.pwm", "GPIO17", "SPI2_MOSI" },
+	{ Board::X3CM, 13, 27, 13, 0, 2, "soc/a6003000.gpio", "soc/a500f000.pwm", "GPIO27", "SPI2_MISO" },
+	{ Board::X3CM, 15, 22, 30, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO22", "BIFSPI_MISO" },
+	{ Board::X3CM, 19, 10, 6, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_MOSI", "SPI1_MOSI" },
+	{ Board::X3CM, 21, 9, 7, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_MISO", "SPI1_MISO" },
+	{ Board::X3CM, 23, 11, 3, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_SCLK", "SPI1_SCLK" },
+	{ Board::X3CM, 27, 0, 15, 0, -1, "soc/a6003000.gpio", nullptr, "I2C3_SDA", "I2C3_SDA" },
+	{ Board::X3CM, 29, 5, 119, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO5", "LPWM3" },
+	{ Board::X3CM, 31, 6, 118, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO6", "LPWM4" },
+	{ Board::X3CM, 33, 13, 4, 0, 0, "soc/a6003000.gpio", "soc/a500d000.pwm", "PWM0", "PWM0" },
+	{ Board::X3CM, 35, 19, 103, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_LRCK", "I2S0_LRCK" },
+	{ Board::X3CM, 37, 26, 117, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO25", "LPWM5" },
+	{ Board::X3CM, 8, 14, 111, 0, -1, "soc/a6003000.gpio", nullptr, "UART_TXD", "UART3_TXD" },
+	{ Board::X3CM, 10, 15, 112, 0, -1, "soc/a6003000.gpio", nullptr, "UART_RXD", "UART3_RXD" },
+	{ Board::X3CM, 12, 18, 102, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_BCLK", "I2S0_BCLK" },
+	{ Board::X3CM, 16, 23, 27, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO23", "BIFSPI_CSN" },
+	{ Board::X3CM, 18, 24, 22, 0, 1, "soc/a6003000.gpio", "soc/a500d000.pwm", "GPIO24", "PWM1" },
+	{ Board::X3CM, 22, 25, 29, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO25", "BIFSPI_MOSI" },
+	{ Board::X3CM, 24, 8, 5, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_CSN", "SPI1_CSN" },
+	{ Board::X3CM, 26, 7, 28, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO7", "BIFSPI_SCLK" },
+	{ Board::X3CM, 28, 1, 14, 0, -1, "soc/a6003000.gpio", nullptr, "I2C3_SCL", "I2C3_SCL" },
+	{ Board::X3CM, 32, 12, 25, 0, 1, "soc/a6003000.gpio", "soc/a500e000.pwm", "PWM4", "PWM4" },
+	{ Board::X3CM, 36, 16, 20, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO16", "BIFSD_CLK" },
+	{ Board::X3CM, 38, 20, 108, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_SDIO", "I2S1_SDIO" },
+	{ Board::X3CM, 40, 21, 104, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_SDIO", "I2S0_SDIO" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P36 = 25,
+	P37 = 14,
+	P38 = 26,
+	P40 = 27,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO16 = 25,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 26,
+	GPIO21 = 27,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO3 = 8,
+	GPIO4 = 12,
+	GPIO5 = 21,
+	GPIO6 = 6,
+	GPIO7 = 7,
+	GPIO8 = 1,
+	GPIO9 = 0,
+	GPIO12 = 3,
+	GPIO13 = 4,
+	GPIO14 = 23,
+	GPIO15 = 9,
+	GPIO20 = 25,
+	GPIO22 = 19,
+	GPIO25 = 24,
+	GPIO27 = 18,
+	GPIO28 = 22,
+	GPIO29 = 20,
+	GPIO30 = 5,
+	GPIO101 = 2,
+	GPIO102 = 17,
+	GPIO103 = 13,
+	GPIO104 = 27,
+	GPIO108 = 26,
+	GPIO111 = 15,
+	GPIO112 = 16,
+	GPIO117 = 14,
+	GPIO118 = 11,
+	GPIO119 = 10,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace x3cm */
+
+namespace x3pi_v2_1 {
+
+inline constexpr uint16_t board_ids[] = { 0x804 };
+
+inline constexpr BoardDesc board = {
+	Board::X3PI_V2_1, "X3PI_V2_1", "x3", board_ids, 1,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::X3PI_V2_1, 3, 2, 9, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SDA", "I2C0_SDA" },
+	{ Board::X3PI_V2_1, 5, 3, 8, 0, -1, "soc/a6003000.gpio", nullptr, "I2C0_SCL", "I2C0_SCL" },
+	{ Board::X3PI_V2_1, 7, 4, 101, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_MCLK", "I2S0_MCLK" },
+	{ Board::X3PI_V2_1, 11, 17, 12, 0, 1, "soc/a6003000.gpio", "soc/a500f000.pwm", "GPIO17", "SPI2_MOSI" },
+	{ Board::X3PI_V2_1, 13, 27, 13, 0, 2, "soc/a6003000.gpio", "soc/a500f000.pwm", "GPIO27", "SPI2_MISO" },
+	{ Board::X3PI_V2_1, 15, 22, 30, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO22", "BIFSPI_MISO" },
+	{ Board::X3PI_V2_1, 19, 10, 6, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_MOSI", "SPI1_MOSI" },
+	{ Board::X3PI_V2_1, 21, 9, 7, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_MISO", "SPI1_MISO" },
+	{ Board::X3PI_V2_1, 23, 11, 3, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_SCLK", "SPI1_SCLK" },
+	{ Board::X3PI_V2_1, 27, 0, 15, 0, -1, "soc/a6003000.gpio", nullptr, "I2C3_SDA", "I2C3_SDA" },
+	{ Board::X3PI_V2_1, 29, 5, 119, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO5", "LPWM3" },
+	{ Board::X3PI_V2_1, 31, 6, 118, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO6", "LPWM4" },
+	{ Board::X3PI_V2_1, 33, 13, 4, 0, 0, "soc/a6003000.gpio", "soc/a500d000.pwm", "PWM0", "PWM0" },
+	{ Board::X3PI_V2_1, 35, 19, 103, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_LRCK", "I2S0_LRCK" },
+	{ Board::X3PI_V2_1, 37, 26, 117, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO25", "LPWM5" },
+	{ Board::X3PI_V2_1, 8, 14, 111, 0, -1, "soc/a6003000.gpio", nullptr, "UART_TXD", "UART3_TXD" },
+	{ Board::X3PI_V2_1, 10, 15, 112, 0, -1, "soc/a6003000.gpio", nullptr, "UART_RXD", "UART3_RXD" },
+	{ Board::X3PI_V2_1, 12, 18, 102, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_BCLK", "I2S0_BCLK" },
+	{ Board::X3PI_V2_1, 16, 23, 27, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO23", "BIFSPI_CSN" },
+	{ Board::X3PI_V2_1, 18, 24, 22, 0, 1, "soc/a6003000.gpio", "soc/a500d000.pwm", "GPIO24", "PWM1" },
+	{ Board::X3PI_V2_1, 22, 25, 29, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO25", "BIFSPI_MOSI" },
+	{ Board::X3PI_V2_1, 24, 8, 5, 0, -1, "soc/a6003000.gpio", nullptr, "SPI1_CSN", "SPI1_CSN" },
+	{ Board::X3PI_V2_1, 26, 7, 28, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO7", "BIFSPI_SCLK" },
+	{ Board::X3PI_V2_1, 28, 1, 14, 0, -1, "soc/a6003000.gpio", nullptr, "I2C3_SCL", "I2C3_SCL" },
+	{ Board::X3PI_V2_1, 32, 12, 25, 0, 1, "soc/a6003000.gpio", "soc/a500e000.pwm", "PWM4", "PWM4" },
+	{ Board::X3PI_V2_1, 36, 16, 20, 0, -1, "soc/a6003000.gpio", nullptr, "GPIO16", "BIFSD_CLK" },
+	{ Board::X3PI_V2_1, 38, 20, 104, 0, -1, "soc/a6003000.gpio", nullptr, "I2S0_SDIO", "I2S0_SDIO" },
+	{ Board::X3PI_V2_1, 40, 21, 108, 0, -1, "soc/a6003000.gpio", nullptr, "I2S1_SDIO", "I2S1_SDIO" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P36 = 25,
+	P37 = 14,
+	P38 = 26,
+	P40 = 27,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO16 = 25,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 26,
+	GPIO21 = 27,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO3 = 8,
+	GPIO4 = 12,
+	GPIO5 = 21,
+	GPIO6 = 6,
+	GPIO7 = 7,
+	GPIO8 = 1,
+	GPIO9 = 0,
+	GPIO12 = 3,
+	GPIO13 = 4,
+	GPIO14 = 23,
+	GPIO15 = 9,
+	GPIO20 = 25,
+	GPIO22 = 19,
+	GPIO25 = 24,
+	GPIO27 = 18,
+	GPIO28 = 22,
+	GPIO29 = 20,
+	GPIO30 = 5,
+	GPIO101 = 2,
+	GPIO102 = 17,
+	GPIO103 = 13,
+	GPIO104 = 26,
+	GPIO108 = 27,
+	GPIO111 = 15,
+	GPIO112 = 16,
+	GPIO117 = 14,
+	GPIO118 = 11,
+	GPIO119 = 10,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace x3pi_v2_1 */
+
+namespace rdk_x5 {
+
+inline constexpr uint16_t board_ids[] = { 0x301, 0x302, 0x501, 0x502, 0x503, 0x504, 0x505, 0x506 };
+
+inline constexpr BoardDesc board = {
+	Board::RDK_X5, "RDK_X5", "x5", board_ids, 8,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::RDK_X5, 3, 2, 390, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SDA", "I2C5_SDA" },
+	{ Board::RDK_X5, 5, 3, 389, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SCL", "I2C5_SCL" },
+	{ Board::RDK_X5, 7, 4, 420, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "GPCLK0", "I2S1_MCLK" },
+	{ Board::RDK_X5, 11, 17, 380, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO17", "UART7_TXD" },
+	{ Board::RDK_X5, 13, 27, 379, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO27", "UART7_RXD" },
+	{ Board::RDK_X5, 15, 22, 388, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO22", "UART2_TXD" },
+	{ Board::RDK_X5, 19, 10, 398, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI_MOSI", "SPI1_MOSI" },
+	{ Board::RDK_X5, 21, 9, 397, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI_MISO", "SPI1_MISO" },
+	{ Board::RDK_X5, 23, 11, 395, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI_SCLK", "SPI1_SCLK" },
+	{ Board::RDK_X5, 27, 0, 355, 2, 1, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34160000.pwm", "ID_SD", "I2C0_SDA" },
+	{ Board::RDK_X5, 29, 5, 399, 0, 0, "soc/34000000.a55_apb0/34120000.gpio", "soc/34000000.a55_apb0/34140000.pwm", "GPIO5", "SPI2_SCLK" },
+	{ Board::RDK_X5, 31, 6, 400, 0, 1, "soc/34000000.a55_apb0/34120000.gpio", "soc/34000000.a55_apb0/34140000.pwm", "GPIO6", "I2C1_SDA" },
+	{ Board::RDK_X5, 33, 13, 357, 2, 1, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34170000.pwm", "PWM", "PWM7" },
+	{ Board::RDK_X5, 35, 19, 422, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "PCM_FS", "I2S1_LRCK" },
+	{ Board::RDK_X5, 37, 26, 401, 0, 0, "soc/34000000.a55_apb0/34120000.gpio", "soc/34000000.a55_apb0/34150000.pwm", "GPIO26", "SPI2_MISO" },
+	{ Board::RDK_X5, 8, 14, 383, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "TXD", "UART1_TXD" },
+	{ Board::RDK_X5, 10, 15, 384, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "RXD", "UART1_RXD" },
+	{ Board::RDK_X5, 12, 18, 421, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "PCM_CLK", "I2S1_BCLK" },
+	{ Board::RDK_X5, 16, 23, 382, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO23", "UART6_TXD" },
+	{ Board::RDK_X5, 18, 24, 402, 0, 1, "soc/34000000.a55_apb0/34120000.gpio", "soc/34000000.a55_apb0/34150000.pwm", "GPIO24", "SPI2_MOSI" },
+	{ Board::RDK_X5, 22, 25, 387, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO25", "UART2_RXD" },
+	{ Board::RDK_X5, 24, 8, 394, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI_CSN0", "SPI1_CSN1" },
+	{ Board::RDK_X5, 26, 7, 396, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI_CSN1", "SPI1_CSN0" },
+	{ Board::RDK_X5, 28, 1, 354, 2, 0, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34160000.pwm", "ID_SC", "I2C0_SCL" },
+	{ Board::RDK_X5, 32, 12, 356, 2, 0, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34170000.pwm", "PWM", "PWM6" },
+	{ Board::RDK_X5, 36, 16, 381, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO16", "BIFSD_CLK" },
+	{ Board::RDK_X5, 38, 20, 423, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "PCM_DIN", "I2S1_SDIN" },
+	{ Board::RDK_X5, 40, 21, 424, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "PCM_DOUT", "I2S1_SDOUT" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P36 = 25,
+	P37 = 14,
+	P38 = 26,
+	P40 = 27,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO16 = 25,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 26,
+	GPIO21 = 27,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO354 = 23,
+	GPIO355 = 9,
+	GPIO356 = 24,
+	GPIO357 = 12,
+	GPIO379 = 4,
+	GPIO380 = 3,
+	GPIO381 = 25,
+	GPIO382 = 18,
+	GPIO383 = 15,
+	GPIO384 = 16,
+	GPIO387 = 20,
+	GPIO388 = 5,
+	GPIO389 = 1,
+	GPIO390 = 0,
+	GPIO394 = 21,
+	GPIO395 = 8,
+	GPIO396 = 22,
+	GPIO397 = 7,
+	GPIO398 = 6,
+	GPIO399 = 10,
+	GPIO400 = 11,
+	GPIO401 = 14,
+	GPIO402 = 19,
+	GPIO420 = 2,
+	GPIO421 = 17,
+	GPIO422 = 13,
+	GPIO423 = 26,
+	GPIO424 = 27,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace rdk_x5 */
+
+namespace evb_x5 {
+
+inline constexpr uint16_t board_ids[] = { 0x201, 0x202, 0x203, 0x204 };
+
+inline constexpr BoardDesc board = {
+	Board::EVB_X5, "EVB_X5", "x5", board_ids, 4,
+};
+
+inline constexpr PinDesc pins[] = {
+	{ Board::EVB_X5, 3, 2, 390, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SDA5", "I2C5_SDA" },
+	{ Board::EVB_X5, 5, 3, 389, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SCL5", "I2C5_SCL" },
+	{ Board::EVB_X5, 7, 4, 420, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "I2S1_MCLK", "DSP_MCLK1" },
+	{ Board::EVB_X5, 11, 17, 382, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO17", "UART7_RTS" },
+	{ Board::EVB_X5, 13, 27, 381, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO27", "UART7_CTS" },
+	{ Board::EVB_X5, 15, 22, 385, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO22", "UART1_CTS" },
+	{ Board::EVB_X5, 19, 10, 402, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI2_MOSI", "SPI2_MOSI" },
+	{ Board::EVB_X5, 21, 9, 401, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI2_MISO", "SPI2_MISO" },
+	{ Board::EVB_X5, 23, 11, 399, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI2_SCLK", "SPI2_SCLK" },
+	{ Board::EVB_X5, 27, 0, 357, 2, -1, "soc/34000000.a55_apb0/34130000.gpio", nullptr, "SDA1", "I2C1_SDA" },
+	{ Board::EVB_X5, 29, 5, 379, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO5", "UART7_RX" },
+	{ Board::EVB_X5, 31, 6, 380, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO6", "UART7_TX" },
+	{ Board::EVB_X5, 33, 13, 354, 2, 0, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34160000.pwm", "PWM4", "PWM4" },
+	{ Board::EVB_X5, 35, 19, 422, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "I2S1_WS", "I2S1_WS" },
+	{ Board::EVB_X5, 37, 26, 386, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO26", "UART1_RTS" },
+	{ Board::EVB_X5, 8, 14, 387, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "TXD", "UART2_TXD" },
+	{ Board::EVB_X5, 10, 15, 388, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "RXD", "UART2_RXD" },
+	{ Board::EVB_X5, 12, 18, 421, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "I2S1_BCLK", "I2S1_BCLK" },
+	{ Board::EVB_X5, 16, 23, 383, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO23", "UART1_RXD" },
+	{ Board::EVB_X5, 18, 24, 384, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO24", "UART1_TXD" },
+	{ Board::EVB_X5, 22, 25, 391, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO25", "UART4_RXD" },
+	{ Board::EVB_X5, 24, 8, 400, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "SPI2_CSN", "SPI2_CSN" },
+	{ Board::EVB_X5, 26, 7, 392, 0, -1, "soc/34000000.a55_apb0/34120000.gpio", nullptr, "GPIO7", "UART4_TXD" },
+	{ Board::EVB_X5, 28, 1, 356, 2, -1, "soc/34000000.a55_apb0/34130000.gpio", nullptr, "SCL1", "I2C1_SCL" },
+	{ Board::EVB_X5, 32, 12, 355, 2, 1, "soc/34000000.a55_apb0/34130000.gpio", "soc/34000000.a55_apb0/34160000.pwm", "PWM", "PWM5" },
+	{ Board::EVB_X5, 38, 20, 423, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "I2S1_DI", "I2S1_SDIN" },
+	{ Board::EVB_X5, 40, 21, 424, 1, -1, "soc/32080000.dsp_apb/32150000.gpio", nullptr, "I2S1_DO", "I2S1_SDOUT" },
+};
+
+enum class BOARD : uint8_t {
+	P3 = 0,
+	P5 = 1,
+	P7 = 2,
+	P8 = 15,
+	P10 = 16,
+	P11 = 3,
+	P12 = 17,
+	P13 = 4,
+	P15 = 5,
+	P16 = 18,
+	P18 = 19,
+	P19 = 6,
+	P21 = 7,
+	P22 = 20,
+	P23 = 8,
+	P24 = 21,
+	P26 = 22,
+	P27 = 9,
+	P28 = 23,
+	P29 = 10,
+	P31 = 11,
+	P32 = 24,
+	P33 = 12,
+	P35 = 13,
+	P37 = 14,
+	P38 = 25,
+	P40 = 26,
+};
+
+enum class BCM : uint8_t {
+	GPIO0 = 9,
+	GPIO1 = 23,
+	GPIO2 = 0,
+	GPIO3 = 1,
+	GPIO4 = 2,
+	GPIO5 = 10,
+	GPIO6 = 11,
+	GPIO7 = 22,
+	GPIO8 = 21,
+	GPIO9 = 7,
+	GPIO10 = 6,
+	GPIO11 = 8,
+	GPIO12 = 24,
+	GPIO13 = 12,
+	GPIO14 = 15,
+	GPIO15 = 16,
+	GPIO17 = 3,
+	GPIO18 = 17,
+	GPIO19 = 13,
+	GPIO20 = 25,
+	GPIO21 = 26,
+	GPIO22 = 5,
+	GPIO23 = 18,
+	GPIO24 = 19,
+	GPIO25 = 20,
+	GPIO26 = 14,
+	GPIO27 = 4,
+};
+
+enum class SOC : uint8_t {
+	GPIO354 = 12,
+	GPIO355 = 24,
+	GPIO356 = 23,
+	GPIO357 = 9,
+	GPIO379 = 10,
+	GPIO380 = 11,
+	GPIO381 = 4,
+	GPIO382 = 3,
+	GPIO383 = 18,
+	GPIO384 = 19,
+	GPIO385 = 5,
+	GPIO386 = 14,
+	GPIO387 = 15,
+	GPIO388 = 16,
+	GPIO389 = 1,
+	GPIO390 = 0,
+	GPIO391 = 20,
+	GPIO392 = 22,
+	GPIO399 = 8,
+	GPIO400 = 21,
+	GPIO401 = 7,
+	GPIO402 = 6,
+	GPIO420 = 2,
+	GPIO421 = 17,
+	GPIO422 = 13,
+	GPIO423 = 25,
+	GPIO424 = 26,
+};
+
+constexpr const PinDesc &describe(BOARD pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(BCM pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+constexpr const PinDesc &describe(SOC pin)
+{
+	return pins[static_cast<std::size_t>(pin)];
+}
+
+} /* namespace evb_x5 */
+
+inline constexpr const BoardDesc *boards[] = {
+	&x3sdbv3::board,
+	&x3sdb::board,
+	&x3pi::board,
+	&x3cm::board,
+	&x3pi_v2_1::board,
+	&rdk_x5::board,
+	&evb_x5::board,
+};
+
+constexpr const BoardDesc &describe(Board board)
+{
+	return *boards[static_cast<std::size_t>(board)];
+}
+
+} /* namespace gpio */
+} /* namespace hobot */
+
+#endif /* __HOBOT_GPIO_PINS_HPP__ */
@@ -0,0 +1,844 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Bit-banged SPI, I2C and 1-Wire masters.
+ *
+ * A whole transaction is compiled into a list of steps before the GIL is
+ * released: each step drives every output of the bus in one batched
+ * set_values_subset() call per chip, holds for a fixed time and optionally
+ * samples the input line. The runner only follows the list against
+ * absolute deadlines, so the bit rate does not depend on how the payload
+ * is encoded.
+ *
+ * I2C and 1-Wire lines are requested open-drain and start released, the
+ * bus pull-ups provide the high level.
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* sample the input line once the step has been held */
+#define HB_BB_SAMPLE		0x01
+/* the input line must read low after the hold, the address was not acked */
+#define HB_BB_ACK_ADDR		0x02
+/* the input line must read low after the hold, a data byte was not acked */
+#define HB_BB_ACK_DATA		0x04
+/* wait for a stretched clock to be released before holding */
+#define HB_BB_STRETCH		0x08
+/* the input line reads low after the hold if a 1-Wire device is present */
+#define HB_BB_PRESENCE		0x10
+
+#define HB_BB_STRETCH_TIMEOUT_NS	(25 * 1000000ULL)
+
+/* 1-Wire standard speed timings */
+#define HB_W1_RESET_LOW_NS	480000
+#define HB_W1_PRESENCE_NS	70000
+#define HB_W1_RESET_REST_NS	410000
+#define HB_W1_WRITE1_LOW_NS	6000
+#define HB_W1_WRITE1_REST_NS	64000
+#define HB_W1_WRITE0_LOW_NS	60000
+#define HB_W1_WRITE0_REST_NS	10000
+#define HB_W1_READ_LOW_NS	6000
+#define HB_W1_READ_SAMPLE_NS	9000
+#define HB_W1_READ_REST_NS	55000
+
+struct hb_bb_step {
+	uint64_t levels;
+	uint32_t hold_ns;
+	uint32_t flags;
+};
+
+struct hb_bb_program {
+	struct hb_bb_step *steps;
+	size_t num;
+	size_t size;
+};
+
+typedef struct hb_bitbang {
+	PyObject_HEAD
+	bool open;
+	struct hb_line_group out;
+	/* SPI reads MISO through its own input request, the others read back
+	 * their open-drain outputs */
+	struct hb_line_group in;
+	bool has_in;
+	uint64_t out_mask;
+	uint64_t in_mask;
+	/* bits of the out group */
+	uint64_t clk;
+	uint64_t data;
+	uint64_t cs;
+	/* SPI */
+	bool cpol;
+	bool cpha;
+	bool lsb_first;
+	/* clock half period for SPI, quarter period for I2C */
+	uint32_t tick_ns;
+	/* outcome of the last run */
+	bool presence;
+} hb_bitbang;
+
+static int program_push(struct hb_bb_program *prog, uint64_t levels,
+			uint32_t hold_ns, uint32_t flags)
+{
+	struct hb_bb_step *steps;
+
+	if (prog->num == prog->size) {
+		prog->size = prog->size ? prog->size * 2 : 256;
+		steps = realloc(prog->steps, prog->size * sizeof(*steps));
+		if (!steps)
+			return -1;
+		prog->steps = steps;
+	}
+
+	prog->steps[prog->num].levels = levels;
+	prog->steps[prog->num].hold_ns = hold_ns;
+	prog->steps[prog->num++].flags = flags;
+
+	return 0;
+}
+
+static int bitbang_read_input(hb_bitbang *self, bool *level)
+{
+	struct hb_line_group *group = self->has_in ? &self->in : &self->out;
+	uint64_t levels;
+
+	if (hb_line_group_get(group, self->in_mask, &levels))
+		return -1;
+	*level = levels != 0;
+
+	return 0;
+}
+
+/*
+ * Run a compiled program, storing sampled bits into rx. Called without the
+ * GIL. Returns -1 with errno set on failure or on a missing acknowledge.
+ */
+static int bitbang_run(hb_bitbang *self, const struct hb_bb_program *prog,
+		       uint8_t *rx, size_t rx_len)
+{
+	const struct hb_bb_step *step;
+	uint64_t deadline, now, clk;
+	size_t i, bit = 0;
+	bool level;
+
+	self->presence = false;
+	deadline = hb_now_ns();
+
+	for (i = 0; i < prog->num; i++) {
+		step = &prog->steps[i];
+
+		if (hb_line_group_set(&self->out, self->out_mask, step->levels))
+			return -1;
+		now = hb_now_ns();
+
+		if (step->flags & HB_BB_STRETCH) {
+			/* a slave holds the clock low until it is ready */
+			do {
+				if (hb_line_group_get(&self->out, self->clk,
+						      &clk))
+					return -1;
+				if (clk)
+					break;
+				if (hb_now_ns() - now > HB_BB_STRETCH_TIMEOUT_NS) {
+					errno = ETIMEDOUT;
+					return -1;
+				}
+			} while (1);
+			now = hb_now_ns();
+			deadline = now;
+		}
+
+		/* keep the bit rate, but never hold a step for less than half
+		 * its time after running late */
+		deadline += step->hold_ns;
+		if (deadline < now + step->hold_ns / 2)
+			deadline = now + step->hold_ns / 2;
+		hb_spin_until(deadline);
+
+		if (!(step->flags & (HB_BB_SAMPLE | HB_BB_ACK_ADDR |
+				     HB_BB_ACK_DATA | HB_BB_PRESENCE)))
+			continue;
+
+		if (bitbang_read_input(self, &level))
+			return -1;
+
+		if (step->flags & HB_BB_PRESENCE)
+			self->presence = !level;
+		if ((step->flags & HB_BB_ACK_ADDR) && level) {
+			errno = ENXIO;
+			return -1;
+		}
+		if ((step->flags & HB_BB_ACK_DATA) && level) {
+			errno = EIO;
+			return -1;
+		}
+		if ((step->flags & HB_BB_SAMPLE) && bit < rx_len * 8) {
+			if (level)
+				rx[bit / 8] |= self->lsb_first ?
+					       1 << (bit % 8) :
+					       0x80 >> (bit % 8);
+			bit++;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Compile and run a program with the GIL released and return the sampled
+ * bytes. The program is freed.
+ */
+static PyObject *bitbang_execute(hb_bitbang *self, struct hb_bb_program *prog,
+				 Py_ssize_t rx_len)
+{
+	PyObject *rx;
+	int ret, err = 0;
+
+	rx = PyBytes_FromStringAndSize(NULL, rx_len);
+	if (!rx) {
+		free(prog->steps);
+		return NULL;
+	}
+	memset(PyBytes_AS_STRING(rx), 0, rx_len);
+
+	Py_BEGIN_ALLOW_THREADS
+	ret = bitbang_run(self, prog, (uint8_t *)PyBytes_AS_STRING(rx),
+			  rx_len);
+	if (ret)
+		err = errno;
+	Py_END_ALLOW_THREADS
+	free(prog->steps);
+
+	if (ret) {
+		Py_DECREF(rx);
+		errno = err;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+
+	return rx;
+}
+
+static int bitbang_check(hb_bitbang *self)
+{
+	if (!self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Bus is closed");
+		return -1;
+	}
+
+	return 0;
+}
+
+static uint32_t tick_from_speed(unsigned long speed_hz, unsigned int ticks)
+{
+	uint64_t tick = HB_NSEC_PER_SEC / ((uint64_t)speed_hz * ticks);
+
+	return tick ? tick : 1;
+}
+
+static int bitbang_open(hb_bitbang *self, PyObject *lines,
+			enum gpiod_line_drive drive, uint64_t levels)
+{
+	struct gpiod_line_settings *settings;
+	int ret;
+
+	if (self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Bus already open");
+		return -1;
+	}
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_OUTPUT);
+	gpiod_line_settings_set_drive(settings, drive);
+
+	/* outputs come up at their idle level, there is no edge to glitch */
+	ret = hb_line_group_open(&self->out, lines, settings, &levels, 0);
+	gpiod_line_settings_free(settings);
+	if (ret)
+		return -1;
+
+	self->out_mask = (1ULL << self->out.num_lines) - 1;
+	self->open = true;
+
+	return 0;
+}
+
+static void bitbang_release(hb_bitbang *self)
+{
+	if (!self->open)
+		return;
+	hb_line_group_close(&self->out);
+	if (self->has_in)
+		hb_line_group_close(&self->in);
+	self->has_in = false;
+	self->open = false;
+}
+
+static void bitbang_dealloc(hb_bitbang *self)
+{
+	bitbang_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *bitbang_close(hb_bitbang *self, PyObject *Py_UNUSED(args))
+{
+	bitbang_release(self);
+	Py_RETURN_NONE;
+}
+
+/* SPI */
+
+static int spi_init(hb_bitbang *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "sclk", "mosi", "miso", "cs", "mode",
+				  "speed_hz", "lsb_first", NULL };
+	PyObject *sclk, *mosi = Py_None, *miso = Py_None, *cs = Py_None;
+	struct gpiod_line_settings *settings;
+	unsigned long speed_hz = 500000;
+	int mode = 0, lsb_first = 0, ret;
+	PyObject *lines, *in_lines;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOikp", kwlist,
+					 &sclk, &mosi, &miso, &cs, &mode,
+					 &speed_hz, &lsb_first))
+		return -1;
+
+	if (mode < 0 || mode > 3) {
+		PyErr_SetString(PyExc_ValueError, "mode must be 0 to 3");
+		return -1;
+	}
+	if (!speed_hz) {
+		PyErr_SetString(PyExc_ValueError,
+				"speed_hz must be greater than 0");
+		return -1;
+	}
+
+	self->cpol = mode & 2;
+	self->cpha = mode & 1;
+	self->lsb_first = lsb_first;
+	self->tick_ns = tick_from_speed(speed_hz, 2);
+
+	/* out group: sclk, then mosi and cs when wired */
+	lines = Py_BuildValue("[O]", sclk);
+	if (!lines)
+		return -1;
+	self->clk = 1ULL << 0;
+	if (mosi != Py_None) {
+		self->data = 1ULL << PyList_GET_SIZE(lines);
+		if (PyList_Append(lines, mosi))
+			goto err_lines;
+	}
+	if (cs != Py_None) {
+		self->cs = 1ULL << PyList_GET_SIZE(lines);
+		if (PyList_Append(lines, cs))
+			goto err_lines;
+	}
+
+	/* chip select idles high, the clock at its polarity */
+	ret = bitbang_open(self, lines, GPIOD_LINE_DRIVE_PUSH_PULL,
+			   (self->cpol ? self->clk : 0) | self->cs);
+	Py_DECREF(lines);
+	if (ret)
+		return -1;
+
+	if (miso == Py_None)
+		return 0;
+
+	in_lines = Py_BuildValue("[O]", miso);
+	if (!in_lines) {
+		bitbang_release(self);
+		return -1;
+	}
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		Py_DECREF(in_lines);
+		bitbang_release(self);
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+	ret = hb_line_group_open(&self->in, in_lines, settings, NULL, 0);
+	gpiod_line_settings_free(settings);
+	Py_DECREF(in_lines);
+	if (ret) {
+		bitbang_release(self);
+		return -1;
+	}
+	self->has_in = true;
+	self->in_mask = 1;
+
+	return 0;
+
+err_lines:
+	Py_DECREF(lines);
+	return -1;
+}
+
+static PyObject *spi_transfer(hb_bitbang *self, PyObject *args)
+{
+	struct hb_bb_program prog = { 0 };
+	uint64_t idle, active, mosi, sample;
+	unsigned int bit, b;
+	Py_buffer tx;
+	Py_ssize_t i;
+	uint8_t byte;
+	int err = 0;
+
+	if (!PyArg_ParseTuple(args, "y*", &tx))
+		return NULL;
+	if (bitbang_check(self)) {
+		PyBuffer_Release(&tx);
+		return NULL;
+	}
+
+	idle = self->cpol ? self->clk : 0;
+	active = idle ^ self->clk;
+	sample = self->has_in ? HB_BB_SAMPLE : 0;
+	mosi = 0;
+
+	/* select, clock at idle */
+	if (self->cs)
+		err |= program_push(&prog, idle, self->tick_ns, 0);
+
+	for (i = 0; i < tx.len; i++) {
+		byte = ((uint8_t *)tx.buf)[i];
+		for (b = 0; b < 8; b++) {
+			bit = self->lsb_first ? (byte >> b) & 1 :
+						(byte >> (7 - b)) & 1;
+			mosi = bit ? self->data : 0;
+			/* data is stable for the whole active half, sample
+			 * right before the edge that leaves it */
+			if (self->cpha) {
+				err |= program_push(&prog, active | mosi,
+						    self->tick_ns, sample);
+				err |= program_push(&prog, idle | mosi,
+						    self->tick_ns, 0);
+			} else {
+				err |= program_push(&prog, idle | mosi,
+						    self->tick_ns, 0);
+				err |= program_push(&prog, active | mosi,
+						    self->tick_ns, sample);
+			}
+		}
+	}
+
+	err |= program_push(&prog, idle | mosi | self->cs, self->tick_ns, 0);
+	PyBuffer_Release(&tx);
+
+	if (err) {
+		free(prog.steps);
+		return PyErr_NoMemory();
+	}
+
+	return bitbang_execute(self, &prog, self->has_in ? i : 0);
+}
+
+static PyMethodDef spi_methods[] = {
+	{ "transfer", (PyCFunction)spi_transfer, METH_VARARGS,
+	  "Clock a buffer out and return the bytes clocked in" },
+	{ "close", (PyCFunction)bitbang_close, METH_NOARGS,
+	  "Release the lines" },
+	{ NULL }
+};
+
+static PyTypeObject hb_spi_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.SoftSPI",
+	.tp_doc = "Bit-banged SPI master",
+	.tp_basicsize = sizeof(hb_bitbang),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)spi_init,
+	.tp_dealloc = (destructor)bitbang_dealloc,
+	.tp_methods = spi_methods,
+};
+
+/* I2C */
+
+static int i2c_init(hb_bitbang *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "scl", "sda", "speed_hz", NULL };
+	unsigned long speed_hz = 100000;
+	PyObject *scl, *sda, *lines;
+	int ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|k", kwlist,
+					 &scl, &sda, &speed_hz))
+		return -1;
+
+	if (!speed_hz) {
+		PyErr_SetString(PyExc_ValueError,
+				"speed_hz must be greater than 0");
+		return -1;
+	}
+
+	self->tick_ns = tick_from_speed(speed_hz, 4);
+	self->clk = 1ULL << 0;
+	self->data = 1ULL << 1;
+	self->in_mask = self->data;
+
+	lines = Py_BuildValue("[OO]", scl, sda);
+	if (!lines)
+		return -1;
+	/* every line starts released */
+	ret = bitbang_open(self, lines, GPIOD_LINE_DRIVE_OPEN_DRAIN, ~0ULL);
+	Py_DECREF(lines);
+
+	return ret;
+}
+
+/*
+ * Every bit takes four ticks: data changes while SCL is low, SCL is
+ * released for two ticks and pulled low again before the next change.
+ */
+static int i2c_push_bit(hb_bitbang *self, struct hb_bb_program *prog,
+			bool bit, uint32_t flags)
+{
+	uint64_t sda = bit ? self->data : 0;
+	int err = 0;
+
+	err |= program_push(prog, sda, self->tick_ns, 0);
+	err |= program_push(prog, self->clk | sda, 2 * self->tick_ns,
+			    HB_BB_STRETCH | flags);
+	err |= program_push(prog, sda, self->tick_ns, 0);
+
+	return err;
+}
+
+static int i2c_push_byte(hb_bitbang *self, struct hb_bb_program *prog,
+			 uint8_t byte, uint32_t ack_flag)
+{
+	int b, err = 0;
+
+	for (b = 7; b >= 0; b--)
+		err |= i2c_push_bit(self, prog, (byte >> b) & 1, 0);
+	/* release SDA for the slave's acknowledge */
+	err |= i2c_push_bit(self, prog, true, ack_flag);
+
+	return err;
+}
+
+static int i2c_push_start(hb_bitbang *self, struct hb_bb_program *prog,
+			  bool repeated)
+{
+	uint64_t both = self->clk | self->data;
+	int err = 0;
+
+	if (repeated) {
+		err |= program_push(prog, self->data, self->tick_ns, 0);
+		err |= program_push(prog, both, 2 * self->tick_ns,
+				    HB_BB_STRETCH);
+	} else {
+		err |= program_push(prog, both, 2 * self->tick_ns, 0);
+	}
+	/* SDA falls while SCL is high */
+	err |= program_push(prog, self->clk, 2 * self->tick_ns, 0);
+	err |= program_push(prog, 0, self->tick_ns, 0);
+
+	return err;
+}
+
+static int i2c_push_stop(hb_bitbang *self, struct hb_bb_program *prog)
+{
+	int err = 0;
+
+	err |= program_push(prog, 0, self->tick_ns, 0);
+	err |= program_push(prog, self->clk, 2 * self->tick_ns, HB_BB_STRETCH);
+	/* SDA rises while SCL is high */
+	err |= program_push(prog, self->clk | self->data, 2 * self->tick_ns, 0);
+
+	return err;
+}
+
+static PyObject *i2c_transfer(hb_bitbang *self, PyObject *args,
+			      PyObject *kwds)
+{
+	static char *kwlist[] = { "addr", "write", "read", NULL };
+	struct hb_bb_program prog = { 0 }, stop = { 0 };
+	Py_buffer tx = { 0 };
+	Py_ssize_t read_len = 0, i;
+	unsigned int addr;
+	PyObject *rx;
+	int err = 0, ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|y*n", kwlist,
+					 &addr, &tx, &read_len))
+		return NULL;
+
+	if (addr > 0x7f || read_len < 0) {
+		PyBuffer_Release(&tx);
+		PyErr_SetString(PyExc_ValueError,
+				"addr must be 7 bit and read positive");
+		return NULL;
+	}
+	if (bitbang_check(self)) {
+		PyBuffer_Release(&tx);
+		return NULL;
+	}
+
+	/* a write phase is also issued when nothing is transferred, which
+	 * probes for the address */
+	if (tx.len || !read_len) {
+		err |= i2c_push_start(self, &prog, false);
+		err |= i2c_push_byte(self, &prog, addr << 1, HB_BB_ACK_ADDR);
+		for (i = 0; i < tx.len; i++)
+			err |= i2c_push_byte(self, &prog,
+					     ((uint8_t *)tx.buf)[i],
+					     HB_BB_ACK_DATA);
+	}
+	PyBuffer_Release(&tx);
+
+	if (read_len) {
+		err |= i2c_push_start(self, &prog, prog.num != 0);
+		err |= i2c_push_byte(self, &prog, (addr << 1) | 1,
+				     HB_BB_ACK_ADDR);
+		for (i = 0; i < read_len; i++) {
+			int b;
+
+			for (b = 0; b < 8; b++)
+				err |= i2c_push_bit(self, &prog, true,
+						    HB_BB_SAMPLE);
+			/* ack every byte but the last */
+			err |= i2c_push_bit(self, &prog, i == read_len - 1, 0);
+		}
+	}
+	err |= i2c_push_stop(self, &prog);
+	err |= i2c_push_stop(self, &stop);
+
+	if (err) {
+		free(prog.steps);
+		free(stop.steps);
+		return PyErr_NoMemory();
+	}
+
+	rx = bitbang_execute(self, &prog, read_len);
+	if (!rx) {
+		/* leave the bus idle after a missing acknowledge */
+		Py_BEGIN_ALLOW_THREADS
+		ret = bitbang_run(self, &stop, NULL, 0);
+		Py_END_ALLOW_THREADS
+		(void)ret;
+	}
+	free(stop.steps);
+
+	return rx;
+}
+
+static PyMethodDef i2c_methods[] = {
+	{ "transfer", (PyCFunction)(void (*)(void))i2c_transfer,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "Write a buffer to an address, then read bytes back after a "
+	  "repeated start" },
+	{ "close", (PyCFunction)bitbang_close, METH_NOARGS,
+	  "Release the lines" },
+	{ NULL }
+};
+
+static PyTypeObject hb_i2c_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.SoftI2C",
+	.tp_doc = "Bit-banged I2C master",
+	.tp_basicsize = sizeof(hb_bitbang),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)i2c_init,
+	.tp_dealloc = (destructor)bitbang_dealloc,
+	.tp_methods = i2c_methods,
+};
+
+/* 1-Wire */
+
+static int w1_init(hb_bitbang *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "line", NULL };
+	PyObject *line, *lines;
+	int ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &line))
+		return -1;
+
+	self->data = 1ULL << 0;
+	self->in_mask = self->data;
+	/* bytes go out and come back least significant bit first */
+	self->lsb_first = true;
+
+	lines = Py_BuildValue("[O]", line);
+	if (!lines)
+		return -1;
+	/* every line starts released */
+	ret = bitbang_open(self, lines, GPIOD_LINE_DRIVE_OPEN_DRAIN, ~0ULL);
+	Py_DECREF(lines);
+
+	return ret;
+}
+
+static int w1_push_reset(hb_bitbang *self, struct hb_bb_program *prog)
+{
+	int err = 0;
+
+	err |= program_push(prog, 0, HB_W1_RESET_LOW_NS, 0);
+	err |= program_push(prog, self->data, HB_W1_PRESENCE_NS,
+			    HB_BB_PRESENCE);
+	err |= program_push(prog, self->data, HB_W1_RESET_REST_NS, 0);
+
+	return err;
+}
+
+static PyObject *w1_transfer(hb_bitbang *self, PyObject *args,
+			     PyObject *kwds)
+{
+	static char *kwlist[] = { "write", "read", "reset", NULL };
+	struct hb_bb_program prog = { 0 };
+	Py_buffer tx = { 0 };
+	Py_ssize_t read_len = 0, i;
+	int reset = 1, err = 0, b;
+	PyObject *rx;
+	uint8_t byte;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|y*np", kwlist,
+					 &tx, &read_len, &reset))
+		return NULL;
+	if (read_len < 0) {
+		PyBuffer_Release(&tx);
+		PyErr_SetString(PyExc_ValueError, "read must be positive");
+		return NULL;
+	}
+	if (bitbang_check(self)) {
+		PyBuffer_Release(&tx);
+		return NULL;
+	}
+
+	if (reset)
+		err |= w1_push_reset(self, &prog);
+
+	for (i = 0; i < tx.len; i++) {
+		byte = ((uint8_t *)tx.buf)[i];
+		for (b = 0; b < 8; b++) {
+			if ((byte >> b) & 1) {
+				err |= program_push(&prog, 0,
+						    HB_W1_WRITE1_LOW_NS, 0);
+				err |= program_push(&prog, self->data,
+						    HB_W1_WRITE1_REST_NS, 0);
+			} else {
+				err |= program_push(&prog, 0,
+						    HB_W1_WRITE0_LOW_NS, 0);
+				err |= program_push(&prog, self->data,
+						    HB_W1_WRITE0_REST_NS, 0);
+			}
+		}
+	}
+	PyBuffer_Release(&tx);
+
+	for (i = 0; i < read_len * 8; i++) {
+		err |= program_push(&prog, 0, HB_W1_READ_LOW_NS, 0);
+		err |= program_push(&prog, self->data, HB_W1_READ_SAMPLE_NS,
+				    HB_BB_SAMPLE);
+		err |= program_push(&prog, self->data, HB_W1_READ_REST_NS, 0);
+	}
+
+	if (err) {
+		free(prog.steps);
+		return PyErr_NoMemory();
+	}
+	if (!prog.num) {
+		free(prog.steps);
+		return PyBytes_FromStringAndSize(NULL, 0);
+	}
+
+	rx = bitbang_execute(self, &prog, read_len);
+	if (rx && reset && !self->presence) {
+		Py_DECREF(rx);
+		errno = ENODEV;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+
+	return rx;
+}
+
+static PyObject *w1_reset(hb_bitbang *self, PyObject *Py_UNUSED(args))
+{
+	struct hb_bb_program prog = { 0 };
+	PyObject *rx;
+
+	if (bitbang_check(self))
+		return NULL;
+
+	if (w1_push_reset(self, &prog)) {
+		free(prog.steps);
+		return PyErr_NoMemory();
+	}
+
+	rx = bitbang_execute(self, &prog, 0);
+	if (!rx)
+		return NULL;
+	Py_DECREF(rx);
+
+	return PyBool_FromLong(self->presence);
+}
+
+static PyMethodDef w1_methods[] = {
+	{ "transfer", (PyCFunction)(void (*)(void))w1_transfer,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "Reset the bus, write a buffer and read bytes back" },
+	{ "reset", (PyCFunction)w1_reset, METH_NOARGS,
+	  "Send a reset pulse and return whether a device answered" },
+	{ "close", (PyCFunction)bitbang_close, METH_NOARGS,
+	  "Release the line" },
+	{ NULL }
+};
+
+static PyTypeObject hb_w1_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.OneWire",
+	.tp_doc = "Bit-banged 1-Wire master",
+	.tp_basicsize = sizeof(hb_bitbang),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)w1_init,
+	.tp_dealloc = (destructor)bitbang_dealloc,
+	.tp_methods = w1_methods,
+};
+
+static int add_type(PyObject *module, PyTypeObject *type, const char *name)
+{
+	if (PyType_Ready(type) < 0)
+		return -1;
+
+	Py_INCREF(type);
+	if (PyModule_AddObject(module, name, (PyObject *)type) < 0) {
+		Py_DECREF(type);
+		return -1;
+	}
+
+	return 0;
+}
+
+int hb_bitbang_init(PyObject *module)
+{
+	if (add_type(module, &hb_spi_type, "SoftSPI") < 0 ||
+	    add_type(module, &hb_i2c_type, "SoftI2C") < 0 ||
+	    add_type(module, &hb_w1_type, "OneWire") < 0)
+		return -1;
+
+	return 0;
+}
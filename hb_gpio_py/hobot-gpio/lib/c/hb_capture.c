@@ -0,0 +1,454 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Edge capture: frequency, period, duty cycle and pulse count measured from
+ * kernel edge timestamps.
+ *
+ * All capture lines in the process share one reactor thread which polls the
+ * line request fds and drains edge events in batches. Edges are kept in a
+ * per-line ring and the statistics are only computed when measure() is
+ * called, so no Python code runs per edge.
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HB_CAPTURE_RING_SIZE	4096
+#define HB_CAPTURE_BATCH	64
+
+struct hb_edge {
+	uint64_t ts;
+	bool rising;
+};
+
+typedef struct hb_capture {
+	PyObject_HEAD
+	struct gpiod_line_request *request;
+	unsigned int offset;
+	uint64_t window_ns;
+	pthread_mutex_t lock;
+	/* edges inside the window, oldest at head */
+	struct hb_edge *ring;
+	size_t head;
+	size_t count;
+	uint64_t pulses;
+	uint64_t missed;
+	unsigned long last_seqno;
+	bool level;
+	/* reactor list linkage, protected by reactor.lock */
+	struct hb_capture *next;
+	bool attached;
+} hb_capture;
+
+static struct {
+	pthread_mutex_t lock;
+	bool running;
+	int wake[2];
+	/* bumped whenever the capture list changes */
+	unsigned int generation;
+	hb_capture *captures;
+	unsigned int num_captures;
+} reactor = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.wake = { -1, -1 },
+};
+
+static void capture_prune(hb_capture *self, uint64_t now)
+{
+	while (self->count &&
+	       now - self->ring[self->head].ts > self->window_ns) {
+		self->head = (self->head + 1) % HB_CAPTURE_RING_SIZE;
+		self->count--;
+	}
+}
+
+static void capture_push(hb_capture *self, struct gpiod_edge_event *event)
+{
+	unsigned long seqno = gpiod_edge_event_get_line_seqno(event);
+	struct hb_edge *edge;
+	size_t tail;
+
+	/* the kernel numbers edges per line, a gap means its kfifo overflowed */
+	if (self->last_seqno && seqno > self->last_seqno + 1)
+		self->missed += seqno - self->last_seqno - 1;
+	self->last_seqno = seqno;
+
+	if (self->count == HB_CAPTURE_RING_SIZE) {
+		self->head = (self->head + 1) % HB_CAPTURE_RING_SIZE;
+		self->count--;
+	}
+
+	tail = (self->head + self->count) % HB_CAPTURE_RING_SIZE;
+	edge = &self->ring[tail];
+	edge->ts = gpiod_edge_event_get_timestamp_ns(event);
+	edge->rising = gpiod_edge_event_get_event_type(event) ==
+		       GPIOD_EDGE_EVENT_RISING_EDGE;
+	self->count++;
+
+	self->level = edge->rising;
+	if (edge->rising)
+		self->pulses++;
+
+	capture_prune(self, edge->ts);
+}
+
+static void capture_drain(hb_capture *self,
+			  struct gpiod_edge_event_buffer *buffer)
+{
+	int num, i;
+
+	num = gpiod_line_request_read_edge_events(self->request, buffer,
+						  HB_CAPTURE_BATCH);
+	if (num <= 0)
+		return;
+
+	pthread_mutex_lock(&self->lock);
+	for (i = 0; i < num; i++)
+		capture_push(self, gpiod_edge_event_buffer_get_event(buffer, i));
+	pthread_mutex_unlock(&self->lock);
+}
+
+static void *reactor_thread(void *arg)
+{
+	struct gpiod_edge_event_buffer *buffer;
+	struct pollfd *pfds = NULL;
+	hb_capture **caps = NULL;
+	unsigned int num = 0, size = 0, generation, i;
+	hb_capture *cap;
+	char drain[64];
+	int ret;
+
+	(void)arg;
+
+	buffer = gpiod_edge_event_buffer_new(HB_CAPTURE_BATCH);
+	if (!buffer)
+		return NULL;
+
+	for (;;) {
+		pthread_mutex_lock(&reactor.lock);
+		generation = reactor.generation;
+		if (reactor.num_captures + 1 > size) {
+			size = reactor.num_captures + 1;
+			pfds = realloc(pfds, size * sizeof(*pfds));
+			caps = realloc(caps, size * sizeof(*caps));
+			if (!pfds || !caps)
+				abort();
+		}
+		pfds[0].fd = reactor.wake[0];
+		pfds[0].events = POLLIN;
+		for (num = 1, cap = reactor.captures; cap; cap = cap->next, num++) {
+			pfds[num].fd = gpiod_line_request_get_fd(cap->request);
+			pfds[num].events = POLLIN;
+			caps[num] = cap;
+		}
+		pthread_mutex_unlock(&reactor.lock);
+
+		ret = poll(pfds, num, -1);
+		if (ret < 0)
+			continue;
+
+		if (pfds[0].revents & POLLIN)
+			while (read(reactor.wake[0], drain, sizeof(drain)) > 0)
+				;
+
+		pthread_mutex_lock(&reactor.lock);
+		/* fds may belong to closed captures if the list changed */
+		if (generation == reactor.generation) {
+			for (i = 1; i < num; i++) {
+				if (pfds[i].revents & POLLIN)
+					capture_drain(caps[i], buffer);
+			}
+		}
+		pthread_mutex_unlock(&reactor.lock);
+	}
+
+	return NULL;
+}
+
+static void reactor_wake(void)
+{
+	char c = 0;
+
+	if (write(reactor.wake[1], &c, 1) < 0 && errno != EAGAIN)
+		return;
+}
+
+/* Called with reactor.lock held. */
+static int reactor_start(void)
+{
+	sigset_t all, old;
+	pthread_t thread;
+	int ret;
+
+	if (reactor.running)
+		return 0;
+
+	if (pipe2(reactor.wake, O_NONBLOCK | O_CLOEXEC))
+		return -1;
+
+	/* keep signals on the interpreter's main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	ret = pthread_create(&thread, NULL, reactor_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (ret) {
+		close(reactor.wake[0]);
+		close(reactor.wake[1]);
+		reactor.wake[0] = reactor.wake[1] = -1;
+		errno = ret;
+		return -1;
+	}
+
+	pthread_detach(thread);
+	reactor.running = true;
+
+	return 0;
+}
+
+static int reactor_attach(hb_capture *self)
+{
+	int ret;
+
+	pthread_mutex_lock(&reactor.lock);
+	ret = reactor_start();
+	if (!ret) {
+		self->next = reactor.captures;
+		reactor.captures = self;
+		reactor.num_captures++;
+		reactor.generation++;
+		self->attached = true;
+		reactor_wake();
+	}
+	pthread_mutex_unlock(&reactor.lock);
+
+	return ret;
+}
+
+static void reactor_detach(hb_capture *self)
+{
+	hb_capture **pos;
+
+	pthread_mutex_lock(&reactor.lock);
+	for (pos = &reactor.captures; *pos; pos = &(*pos)->next) {
+		if (*pos == self) {
+			*pos = self->next;
+			reactor.num_captures--;
+			reactor.generation++;
+			reactor_wake();
+			break;
+		}
+	}
+	self->attached = false;
+	pthread_mutex_unlock(&reactor.lock);
+}
+
+static void capture_release(hb_capture *self)
+{
+	if (self->attached)
+		reactor_detach(self);
+	if (self->request) {
+		gpiod_line_request_release(self->request);
+		self->request = NULL;
+	}
+}
+
+static int capture_init(hb_capture *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "chip", "offset", "window_ns",
+				  "debounce_us", NULL };
+	struct gpiod_line_settings *settings;
+	unsigned long long window_ns;
+	unsigned long debounce_us = 0;
+	const char *chip_path;
+	enum gpiod_line_value value;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "sIK|k", kwlist,
+					 &chip_path, &self->offset,
+					 &window_ns, &debounce_us))
+		return -1;
+
+	if (!window_ns) {
+		PyErr_SetString(PyExc_ValueError,
+				"window_ns must be greater than 0");
+		return -1;
+	}
+	if (self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "Capture already open");
+		return -1;
+	}
+
+	self->window_ns = window_ns;
+	self->ring = calloc(HB_CAPTURE_RING_SIZE, sizeof(*self->ring));
+	if (!self->ring) {
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+	gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+	gpiod_line_settings_set_event_clock(settings,
+					    GPIOD_LINE_CLOCK_MONOTONIC);
+	gpiod_line_settings_set_debounce_period_us(settings, debounce_us);
+
+	self->request = hb_request_lines(chip_path, &self->offset, 1, settings,
+					 NULL, HB_CAPTURE_RING_SIZE);
+	gpiod_line_settings_free(settings);
+	if (!self->request) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, chip_path);
+		return -1;
+	}
+
+	value = gpiod_line_request_get_value(self->request, self->offset);
+	self->level = value == GPIOD_LINE_VALUE_ACTIVE;
+
+	if (reactor_attach(self)) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		capture_release(self);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void capture_dealloc(hb_capture *self)
+{
+	capture_release(self);
+	pthread_mutex_destroy(&self->lock);
+	free(self->ring);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *capture_new(PyTypeObject *type, PyObject *args,
+			     PyObject *kwds)
+{
+	hb_capture *self;
+
+	(void)args;
+	(void)kwds;
+
+	self = (hb_capture *)type->tp_alloc(type, 0);
+	if (self)
+		pthread_mutex_init(&self->lock, NULL);
+
+	return (PyObject *)self;
+}
+
+static PyObject *capture_measure(hb_capture *self, PyObject *Py_UNUSED(args))
+{
+	uint64_t high = 0, total = 0, last_rise = 0, cur_high = 0;
+	unsigned long long pulses, missed;
+	double frequency = 0.0, period = 0.0, duty_cycle;
+	unsigned int cycles = 0;
+	struct hb_edge *edge;
+	size_t i;
+
+	if (!self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "Capture is closed");
+		return NULL;
+	}
+
+	pthread_mutex_lock(&self->lock);
+	capture_prune(self, hb_now_ns());
+
+	/* a cycle runs from one rising edge to the next */
+	for (i = 0; i < self->count; i++) {
+		edge = &self->ring[(self->head + i) % HB_CAPTURE_RING_SIZE];
+		if (!edge->rising) {
+			if (last_rise)
+				cur_high = edge->ts - last_rise;
+			continue;
+		}
+		if (last_rise && cur_high) {
+			high += cur_high;
+			total += edge->ts - last_rise;
+			cycles++;
+		}
+		last_rise = edge->ts;
+		cur_high = 0;
+	}
+
+	if (cycles) {
+		period = (double)total / cycles / HB_NSEC_PER_SEC;
+		frequency = 1.0 / period;
+		duty_cycle = 100.0 * high / total;
+	} else {
+		duty_cycle = self->level ? 100.0 : 0.0;
+	}
+	pulses = self->pulses;
+	missed = self->missed;
+	pthread_mutex_unlock(&self->lock);
+
+	return Py_BuildValue("{s:d,s:d,s:d,s:K,s:K}",
+			     "frequency", frequency,
+			     "period", period,
+			     "duty_cycle", duty_cycle,
+			     "pulse_count", pulses,
+			     "missed", missed);
+}
+
+static PyObject *capture_close(hb_capture *self, PyObject *Py_UNUSED(args))
+{
+	capture_release(self);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef capture_methods[] = {
+	{ "measure", (PyCFunction)capture_measure, METH_NOARGS,
+	  "Return frequency, period, duty cycle and pulse count" },
+	{ "close", (PyCFunction)capture_close, METH_NOARGS,
+	  "Stop capturing and release the line" },
+	{ NULL }
+};
+
+static PyTypeObject hb_capture_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.Capture",
+	.tp_doc = "Edge timestamp capture on one GPIO line",
+	.tp_basicsize = sizeof(hb_capture),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = capture_new,
+	.tp_init = (initproc)capture_init,
+	.tp_dealloc = (destructor)capture_dealloc,
+	.tp_methods = capture_methods,
+};
+
+int hb_capture_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_capture_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_capture_type);
+	if (PyModule_AddObject(module, "Capture",
+			       (PyObject *)&hb_capture_type) < 0) {
+		Py_DECREF(&hb_capture_type);
+		return -1;
+	}
+
+	return 0;
+}
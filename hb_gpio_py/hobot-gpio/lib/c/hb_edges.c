@@ -0,0 +1,264 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Edge reader for event loops: an input line with both edges enabled whose
+ * request fd is handed out through fileno(), so that the caller can watch
+ * it with its own selector. read() never blocks and drains one batch of
+ * events per call. There is no thread here, everything runs on the caller's.
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#define HB_EDGES_BATCH		64
+#define HB_EDGES_BUFFER_SIZE	1024
+
+typedef struct {
+	PyObject_HEAD
+	struct gpiod_line_request *request;
+	struct gpiod_edge_event_buffer *buffer;
+	unsigned int offset;
+	unsigned long debounce_us;
+} hb_edges;
+
+static struct gpiod_line_settings *edges_settings(unsigned long debounce_us)
+{
+	struct gpiod_line_settings *settings;
+
+	settings = gpiod_line_settings_new();
+	if (!settings)
+		return NULL;
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+	gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+	gpiod_line_settings_set_event_clock(settings,
+					    GPIOD_LINE_CLOCK_MONOTONIC);
+	gpiod_line_settings_set_debounce_period_us(settings, debounce_us);
+
+	return settings;
+}
+
+static void edges_release(hb_edges *self)
+{
+	if (self->request) {
+		gpiod_line_request_release(self->request);
+		self->request = NULL;
+	}
+	if (self->buffer) {
+		gpiod_edge_event_buffer_free(self->buffer);
+		self->buffer = NULL;
+	}
+}
+
+static int edges_check(hb_edges *self)
+{
+	if (!self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "EdgeReader is closed");
+		return -1;
+	}
+	return 0;
+}
+
+static int edges_init(hb_edges *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "chip", "offset", "debounce_us", NULL };
+	struct gpiod_line_settings *settings;
+	const char *chip_path;
+	int fd;
+
+	self->debounce_us = 0;
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "sI|k", kwlist,
+					 &chip_path, &self->offset,
+					 &self->debounce_us))
+		return -1;
+
+	if (self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "EdgeReader already open");
+		return -1;
+	}
+
+	self->buffer = gpiod_edge_event_buffer_new(HB_EDGES_BATCH);
+	settings = edges_settings(self->debounce_us);
+	if (!self->buffer || !settings) {
+		gpiod_line_settings_free(settings);
+		edges_release(self);
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	self->request = hb_request_lines(chip_path, &self->offset, 1, settings,
+					 NULL, HB_EDGES_BUFFER_SIZE);
+	gpiod_line_settings_free(settings);
+	if (!self->request) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, chip_path);
+		edges_release(self);
+		return -1;
+	}
+
+	/* an event loop calls read() when the fd is ready, it must not block */
+	fd = gpiod_line_request_get_fd(self->request);
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	return 0;
+}
+
+static void edges_dealloc(hb_edges *self)
+{
+	edges_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *edges_fileno(hb_edges *self, PyObject *Py_UNUSED(args))
+{
+	if (edges_check(self))
+		return NULL;
+	return PyLong_FromLong(gpiod_line_request_get_fd(self->request));
+}
+
+static PyObject *edges_read(hb_edges *self, PyObject *Py_UNUSED(args))
+{
+	struct gpiod_edge_event *event;
+	PyObject *list, *item;
+	int num, i;
+
+	if (edges_check(self))
+		return NULL;
+
+	num = gpiod_line_request_read_edge_events(self->request, self->buffer,
+						  HB_EDGES_BATCH);
+	if (num < 0) {
+		if (errno == EAGAIN)
+			return PyList_New(0);
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+
+	list = PyList_New(num);
+	if (!list)
+		return NULL;
+	for (i = 0; i < num; i++) {
+		event = gpiod_edge_event_buffer_get_event(self->buffer, i);
+		item = Py_BuildValue("(KOk)",
+			(unsigned long long)gpiod_edge_event_get_timestamp_ns(event),
+			gpiod_edge_event_get_event_type(event) ==
+			GPIOD_EDGE_EVENT_RISING_EDGE ? Py_True : Py_False,
+			gpiod_edge_event_get_line_seqno(event));
+		if (!item) {
+			Py_DECREF(list);
+			return NULL;
+		}
+		PyList_SET_ITEM(list, i, item);
+	}
+
+	return list;
+}
+
+static PyObject *edges_value(hb_edges *self, PyObject *Py_UNUSED(args))
+{
+	enum gpiod_line_value value;
+
+	if (edges_check(self))
+		return NULL;
+
+	value = gpiod_line_request_get_value(self->request, self->offset);
+	if (value == GPIOD_LINE_VALUE_ERROR)
+		return PyErr_SetFromErrno(PyExc_OSError);
+	return PyLong_FromLong(value == GPIOD_LINE_VALUE_ACTIVE);
+}
+
+static PyObject *edges_set_debounce(hb_edges *self, PyObject *args)
+{
+	struct gpiod_line_settings *settings;
+	struct gpiod_line_config *line_cfg;
+	unsigned long debounce_us;
+	int ret;
+
+	if (!PyArg_ParseTuple(args, "k", &debounce_us))
+		return NULL;
+	if (edges_check(self))
+		return NULL;
+	if (debounce_us == self->debounce_us)
+		Py_RETURN_NONE;
+
+	settings = edges_settings(debounce_us);
+	line_cfg = gpiod_line_config_new();
+	if (!settings || !line_cfg) {
+		gpiod_line_settings_free(settings);
+		gpiod_line_config_free(line_cfg);
+		return PyErr_NoMemory();
+	}
+
+	ret = gpiod_line_config_add_line_settings(line_cfg, &self->offset, 1,
+						  settings);
+	if (!ret)
+		ret = gpiod_line_request_reconfigure_lines(self->request,
+							   line_cfg);
+	gpiod_line_config_free(line_cfg);
+	gpiod_line_settings_free(settings);
+	if (ret)
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	self->debounce_us = debounce_us;
+	Py_RETURN_NONE;
+}
+
+static PyObject *edges_close(hb_edges *self, PyObject *Py_UNUSED(args))
+{
+	edges_release(self);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef edges_methods[] = {
+	{ "fileno", (PyCFunction)edges_fileno, METH_NOARGS,
+	  "Return the line request fd, readable when edges are pending" },
+	{ "read", (PyCFunction)edges_read, METH_NOARGS,
+	  "Return the pending (timestamp_ns, rising, seqno) edges, "
+	  "without blocking" },
+	{ "value", (PyCFunction)edges_value, METH_NOARGS,
+	  "Return the current level of the line" },
+	{ "set_debounce", (PyCFunction)edges_set_debounce, METH_VARARGS,
+	  "Change the debounce period of the line, in microseconds" },
+	{ "close", (PyCFunction)edges_close, METH_NOARGS,
+	  "Release the line" },
+	{ NULL }
+};
+
+static PyTypeObject hb_edges_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.EdgeReader",
+	.tp_doc = "Non-blocking edge events of one GPIO line",
+	.tp_basicsize = sizeof(hb_edges),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)edges_init,
+	.tp_dealloc = (destructor)edges_dealloc,
+	.tp_methods = edges_methods,
+};
+
+int hb_edges_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_edges_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_edges_type);
+	if (PyModule_AddObject(module, "EdgeReader",
+			       (PyObject *)&hb_edges_type) < 0) {
+		Py_DECREF(&hb_edges_type);
+		return -1;
+	}
+
+	return 0;
+}
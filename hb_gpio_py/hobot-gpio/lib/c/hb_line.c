@@ -0,0 +1,188 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Line handle: one requested line whose write() and read() are a single
+ * ioctl each. Everything that can be checked is checked when the handle is
+ * opened, the calls only validate the level and allocate nothing, 0 and 1
+ * are the interpreter's cached ints. The GIL is kept across the ioctl, it
+ * costs less than releasing and taking it back.
+ */
+
+#include "hb_native.h"
+
+#include <stdbool.h>
+
+typedef struct {
+	PyObject_HEAD
+	struct gpiod_line_request *request;
+	unsigned int offset;
+	bool output;
+} hb_line;
+
+static void line_release(hb_line *self)
+{
+	if (self->request) {
+		gpiod_line_request_release(self->request);
+		self->request = NULL;
+	}
+}
+
+static int line_check(hb_line *self)
+{
+	if (!self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "Line is closed");
+		return -1;
+	}
+	return 0;
+}
+
+static int line_init(hb_line *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "chip", "offset", "output", "value", NULL };
+	struct gpiod_line_settings *settings;
+	const char *chip_path;
+	int output = 0, value = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "sI|pp", kwlist,
+					 &chip_path, &self->offset, &output,
+					 &value))
+		return -1;
+
+	if (self->request) {
+		PyErr_SetString(PyExc_RuntimeError, "Line already open");
+		return -1;
+	}
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	if (output) {
+		gpiod_line_settings_set_direction(settings,
+						  GPIOD_LINE_DIRECTION_OUTPUT);
+		gpiod_line_settings_set_output_value(settings, value ?
+						     GPIOD_LINE_VALUE_ACTIVE :
+						     GPIOD_LINE_VALUE_INACTIVE);
+	} else {
+		gpiod_line_settings_set_direction(settings,
+						  GPIOD_LINE_DIRECTION_INPUT);
+	}
+
+	self->request = hb_request_lines(chip_path, &self->offset, 1, settings,
+					 NULL, 0);
+	gpiod_line_settings_free(settings);
+	if (!self->request) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, chip_path);
+		return -1;
+	}
+	self->output = output;
+
+	return 0;
+}
+
+static void line_dealloc(hb_line *self)
+{
+	line_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *line_write(hb_line *self, PyObject *arg)
+{
+	long level = -1;
+
+	/* the same levels output() accepts: 0, 1, False and True */
+	if (PyLong_Check(arg)) {
+		level = PyLong_AsLong(arg);
+		if (level == -1)
+			PyErr_Clear();
+	}
+	if (level != 0 && level != 1) {
+		PyErr_SetString(PyExc_ValueError,
+				"The value setting of this channel is invalid");
+		return NULL;
+	}
+
+	if (line_check(self))
+		return NULL;
+	if (!self->output) {
+		PyErr_SetString(PyExc_RuntimeError,
+				"This line is not an output");
+		return NULL;
+	}
+
+	if (gpiod_line_request_set_value(self->request, self->offset,
+					 level ? GPIOD_LINE_VALUE_ACTIVE :
+						 GPIOD_LINE_VALUE_INACTIVE))
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *line_read(hb_line *self, PyObject *Py_UNUSED(args))
+{
+	enum gpiod_line_value value;
+
+	if (line_check(self))
+		return NULL;
+
+	value = gpiod_line_request_get_value(self->request, self->offset);
+	if (value == GPIOD_LINE_VALUE_ERROR)
+		return PyErr_SetFromErrno(PyExc_OSError);
+	return PyLong_FromLong(value == GPIOD_LINE_VALUE_ACTIVE);
+}
+
+static PyObject *line_close(hb_line *self, PyObject *Py_UNUSED(args))
+{
+	line_release(self);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef line_methods[] = {
+	{ "write", (PyCFunction)line_write, METH_O,
+	  "Drive the output to 0 or 1" },
+	{ "read", (PyCFunction)line_read, METH_NOARGS,
+	  "Return the current level of the line" },
+	{ "close", (PyCFunction)line_close, METH_NOARGS,
+	  "Release the line" },
+	{ NULL }
+};
+
+static PyTypeObject hb_line_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.Line",
+	.tp_doc = "One requested GPIO line, read and written without lookups",
+	.tp_basicsize = sizeof(hb_line),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)line_init,
+	.tp_dealloc = (destructor)line_dealloc,
+	.tp_methods = line_methods,
+};
+
+int hb_line_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_line_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_line_type);
+	if (PyModule_AddObject(module, "Line",
+			       (PyObject *)&hb_line_type) < 0) {
+		Py_DECREF(&hb_line_type);
+		return -1;
+	}
+
+	return 0;
+}
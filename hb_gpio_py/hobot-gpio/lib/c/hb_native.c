@@ -0,0 +1,292 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <string.h>
+
+#define HB_CALIBRATE_ROUNDS	32
+#define HB_CALIBRATE_SLEEP_NS	50000ULL
+#define HB_SPIN_MIN_NS		2000ULL
+#define HB_SPIN_MAX_NS		500000ULL
+
+struct gpiod_line_request *hb_request_lines(const char *chip_path,
+					    const unsigned int *offsets,
+					    size_t num_offsets,
+					    struct gpiod_line_settings *settings,
+					    const enum gpiod_line_value *values,
+					    size_t event_buffer_size)
+{
+	struct gpiod_request_config *req_cfg = NULL;
+	struct gpiod_line_request *request = NULL;
+	struct gpiod_line_config *line_cfg;
+	struct gpiod_chip *chip;
+	int err;
+
+	chip = gpiod_chip_open(chip_path);
+	if (!chip)
+		return NULL;
+
+	line_cfg = gpiod_line_config_new();
+	if (!line_cfg)
+		goto close_chip;
+
+	if (gpiod_line_config_add_line_settings(line_cfg, offsets, num_offsets,
+						settings))
+		goto free_line_cfg;
+
+	if (values &&
+	    gpiod_line_config_set_output_values(line_cfg, values, num_offsets))
+		goto free_line_cfg;
+
+	req_cfg = gpiod_request_config_new();
+	if (!req_cfg)
+		goto free_line_cfg;
+
+	gpiod_request_config_set_consumer(req_cfg, HB_CONSUMER);
+	if (event_buffer_size)
+		gpiod_request_config_set_event_buffer_size(req_cfg,
+							   event_buffer_size);
+
+	request = gpiod_chip_request_lines(chip, req_cfg, line_cfg);
+
+	gpiod_request_config_free(req_cfg);
+free_line_cfg:
+	gpiod_line_config_free(line_cfg);
+close_chip:
+	/* the request keeps its own reference to the chip fd */
+	err = errno;
+	gpiod_chip_close(chip);
+	errno = err;
+
+	return request;
+}
+
+int hb_line_group_open(struct hb_line_group *group, PyObject *lines,
+		       struct gpiod_line_settings *settings,
+		       const uint64_t *levels, size_t event_buffer_size)
+{
+	enum gpiod_line_value values[HB_GROUP_MAX_LINES];
+	const char *chip_paths[HB_GROUP_MAX_LINES];
+	unsigned int chip_first[HB_GROUP_MAX_LINES];
+	unsigned int offsets[HB_GROUP_MAX_LINES];
+	unsigned int chip, num_offsets;
+	PyObject *seq, *item;
+	Py_ssize_t num, i;
+
+	memset(group, 0, sizeof(*group));
+
+	seq = PySequence_Fast(lines, "lines must be a sequence");
+	if (!seq)
+		return -1;
+
+	num = PySequence_Fast_GET_SIZE(seq);
+	if (num < 1 || num > HB_GROUP_MAX_LINES) {
+		PyErr_Format(PyExc_ValueError, "between 1 and %d lines expected",
+			     HB_GROUP_MAX_LINES);
+		goto err_seq;
+	}
+
+	for (i = 0; i < num; i++) {
+		item = PySequence_Fast_GET_ITEM(seq, i);
+		if (!PyArg_ParseTuple(item, "sI;lines must be (chip, offset) pairs",
+				      &chip_paths[i], &group->line_offset[i]))
+			goto err_seq;
+
+		for (chip = 0; chip < group->num_chips; chip++) {
+			if (!strcmp(chip_paths[chip_first[chip]], chip_paths[i]))
+				break;
+		}
+		if (chip == group->num_chips)
+			chip_first[group->num_chips++] = i;
+		group->line_chip[i] = chip;
+	}
+
+	for (chip = 0; chip < group->num_chips; chip++) {
+		const char *path = chip_paths[chip_first[chip]];
+
+		for (num_offsets = 0, i = 0; i < num; i++) {
+			if (group->line_chip[i] != chip)
+				continue;
+			if (levels)
+				values[num_offsets] = (*levels >> i) & 1 ?
+					GPIOD_LINE_VALUE_ACTIVE :
+					GPIOD_LINE_VALUE_INACTIVE;
+			offsets[num_offsets++] = group->line_offset[i];
+		}
+
+		group->requests[chip] = hb_request_lines(path, offsets,
+							 num_offsets, settings,
+							 levels ? values : NULL,
+							 event_buffer_size);
+		if (!group->requests[chip]) {
+			PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+			goto err_requests;
+		}
+	}
+
+	group->num_lines = num;
+	Py_DECREF(seq);
+
+	return 0;
+
+err_requests:
+	hb_line_group_close(group);
+err_seq:
+	Py_DECREF(seq);
+	return -1;
+}
+
+void hb_line_group_close(struct hb_line_group *group)
+{
+	unsigned int chip;
+
+	for (chip = 0; chip < group->num_chips; chip++) {
+		if (group->requests[chip])
+			gpiod_line_request_release(group->requests[chip]);
+		group->requests[chip] = NULL;
+	}
+	group->num_chips = 0;
+	group->num_lines = 0;
+}
+
+int hb_line_group_set(struct hb_line_group *group, uint64_t mask,
+		      uint64_t levels)
+{
+	enum gpiod_line_value values[HB_GROUP_MAX_LINES];
+	unsigned int offsets[HB_GROUP_MAX_LINES];
+	unsigned int chip, line, num;
+
+	for (chip = 0; chip < group->num_chips; chip++) {
+		for (num = 0, line = 0; line < group->num_lines; line++) {
+			if (group->line_chip[line] != chip ||
+			    !(mask & (1ULL << line)))
+				continue;
+			offsets[num] = group->line_offset[line];
+			values[num++] = (levels >> line) & 1 ?
+					GPIOD_LINE_VALUE_ACTIVE :
+					GPIOD_LINE_VALUE_INACTIVE;
+		}
+		if (num && gpiod_line_request_set_values_subset(
+				group->requests[chip], num, offsets, values))
+			return -1;
+	}
+
+	return 0;
+}
+
+int hb_line_group_get(struct hb_line_group *group, uint64_t mask,
+		      uint64_t *levels)
+{
+	enum gpiod_line_value values[HB_GROUP_MAX_LINES];
+	unsigned int offsets[HB_GROUP_MAX_LINES];
+	unsigned int lines[HB_GROUP_MAX_LINES];
+	unsigned int chip, line, num, i;
+
+	*levels = 0;
+	for (chip = 0; chip < group->num_chips; chip++) {
+		for (num = 0, line = 0; line < group->num_lines; line++) {
+			if (group->line_chip[line] != chip ||
+			    !(mask & (1ULL << line)))
+				continue;
+			lines[num] = line;
+			offsets[num++] = group->line_offset[line];
+		}
+		if (!num)
+			continue;
+		if (gpiod_line_request_get_values_subset(group->requests[chip],
+							 num, offsets, values))
+			return -1;
+		for (i = 0; i < num; i++) {
+			if (values[i] == GPIOD_LINE_VALUE_ACTIVE)
+				*levels |= 1ULL << lines[i];
+		}
+	}
+
+	return 0;
+}
+
+static void ns_to_timespec(uint64_t ns, struct timespec *ts)
+{
+	ts->tv_sec = ns / HB_NSEC_PER_SEC;
+	ts->tv_nsec = ns % HB_NSEC_PER_SEC;
+}
+
+uint64_t hb_calibrate_spin(void)
+{
+	uint64_t target, late, worst = 0;
+	struct timespec ts;
+	int i;
+
+	for (i = 0; i < HB_CALIBRATE_ROUNDS; i++) {
+		target = hb_now_ns() + HB_CALIBRATE_SLEEP_NS;
+		ns_to_timespec(target, &ts);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+				       NULL) == EINTR)
+			;
+		late = hb_now_ns() - target;
+		if (late > worst)
+			worst = late;
+	}
+
+	/* leave headroom for wakeups slower than any seen while calibrating */
+	worst *= 2;
+	if (worst < HB_SPIN_MIN_NS)
+		worst = HB_SPIN_MIN_NS;
+	if (worst > HB_SPIN_MAX_NS)
+		worst = HB_SPIN_MAX_NS;
+
+	return worst;
+}
+
+void hb_wait_until(uint64_t target, uint64_t spin_ns)
+{
+	struct timespec ts;
+
+	if (target > hb_now_ns() + spin_ns) {
+		ns_to_timespec(target - spin_ns, &ts);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts,
+				       NULL) == EINTR)
+			;
+	}
+
+	hb_spin_until(target);
+}
+
+static struct PyModuleDef hb_native_module = {
+	PyModuleDef_HEAD_INIT,
+	.m_name = "Hobot.GPIO._native",
+	.m_doc = "Native libgpiod backend for Hobot.GPIO",
+	.m_size = -1,
+};
+
+PyMODINIT_FUNC PyInit__native(void)
+{
+	PyObject *module;
+
+	module = PyModule_Create(&hb_native_module);
+	if (!module)
+		return NULL;
+
+	if (hb_capture_init(module) < 0 || hb_wave_init(module) < 0 ||
+	    hb_softpwm_init(module) < 0 || hb_bitbang_init(module) < 0 ||
+	    hb_edges_init(module) < 0 || hb_sampler_init(module) < 0 ||
+	    hb_trace_init(module) < 0 || hb_line_init(module) < 0) {
+		Py_DECREF(module);
+		return NULL;
+	}
+
+	return module;
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __HB_NATIVE_H__
+#define __HB_NATIVE_H__
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <gpiod.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Native helpers for Hobot.GPIO built on the libgpiod character device API.
+ *
+ * Every feature lives in its own hb_<feature>.c file and registers its
+ * types with the module through an hb_<feature>_init() hook.
+ */
+
+#define HB_CONSUMER		"hobot-gpio"
+#define HB_NSEC_PER_SEC		1000000000ULL
+
+static inline uint64_t hb_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * HB_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/*
+ * Request a set of lines on one chip with identical settings. Outputs start
+ * at the per-line values when given, at the settings' value otherwise.
+ * Returns NULL with errno set on failure.
+ */
+struct gpiod_line_request *hb_request_lines(const char *chip_path,
+					    const unsigned int *offsets,
+					    size_t num_offsets,
+					    struct gpiod_line_settings *settings,
+					    const enum gpiod_line_value *values,
+					    size_t event_buffer_size);
+
+/*
+ * Output lines spread over several chips, addressed by their index in the
+ * group. Each chip is requested once so that an update costs one
+ * set_values_subset() call per chip, whatever the number of lines.
+ */
+#define HB_GROUP_MAX_LINES	64
+
+struct hb_line_group {
+	unsigned int num_lines;
+	unsigned int num_chips;
+	struct gpiod_line_request *requests[HB_GROUP_MAX_LINES];
+	/* chip index and offset of each line */
+	unsigned int line_chip[HB_GROUP_MAX_LINES];
+	unsigned int line_offset[HB_GROUP_MAX_LINES];
+};
+
+/*
+ * Request a sequence of (chip path, offset) pairs with the given settings,
+ * event_buffer_size as in hb_request_lines(). When levels is given, outputs
+ * start at its bit of the same index instead of the settings' value. Sets a
+ * Python exception and returns -1 on failure.
+ */
+int hb_line_group_open(struct hb_line_group *group, PyObject *lines,
+		       struct gpiod_line_settings *settings,
+		       const uint64_t *levels, size_t event_buffer_size);
+void hb_line_group_close(struct hb_line_group *group);
+
+/*
+ * Drive the lines selected by mask to the matching bits of levels. Safe to
+ * call without the GIL. Returns -1 with errno set on failure.
+ */
+int hb_line_group_set(struct hb_line_group *group, uint64_t mask,
+		      uint64_t levels);
+
+/*
+ * Read the lines selected by mask into the matching bits of levels. Safe to
+ * call without the GIL. Returns -1 with errno set on failure.
+ */
+int hb_line_group_get(struct hb_line_group *group, uint64_t mask,
+		      uint64_t *levels);
+
+/* Busy-wait until the monotonic clock reaches deadline. */
+static inline void hb_spin_until(uint64_t deadline)
+{
+	while (hb_now_ns() < deadline)
+		;
+}
+
+/* first deadline of a timed loop, this far after calibration */
+#define HB_LEAD_NS		200000ULL
+
+/*
+ * Timed loops sleep with clock_nanosleep() until spin_ns before each
+ * deadline and spin for the rest. The margin is calibrated from the wakeup
+ * latency measured on the calling thread, call it right before the loop.
+ */
+uint64_t hb_calibrate_spin(void);
+void hb_wait_until(uint64_t target, uint64_t spin_ns);
+
+int hb_capture_init(PyObject *module);
+int hb_wave_init(PyObject *module);
+int hb_softpwm_init(PyObject *module);
+int hb_bitbang_init(PyObject *module);
+int hb_edges_init(PyObject *module);
+int hb_sampler_init(PyObject *module);
+int hb_trace_init(PyObject *module);
+int hb_line_init(PyObject *module);
+
+#endif /* __HB_NATIVE_H__ */
@@ -0,0 +1,420 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Bulk sampler: reads a group of input lines at a fixed rate into a
+ * caller supplied buffer.
+ *
+ * Every sample is one get_values() call per chip, packed into 1, 2, 4 or 8
+ * little endian bytes with bit n holding line n, so the buffer can be a
+ * uint8/16/32/64 array. read() fills the whole buffer from a dedicated
+ * thread, SCHED_FIFO and pinned to one CPU when permitted, and only returns
+ * to Python at the end, with the achieved timing.
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define HB_SAMPLER_PRIORITY	80
+
+struct hb_sampler_stats {
+	uint64_t samples;
+	uint64_t min_ns;
+	uint64_t max_ns;
+	double mean_ns;
+	/* running sum of squared differences from the mean */
+	double m2;
+	uint64_t overruns;
+	uint64_t first_ns;
+	uint64_t last_ns;
+	uint64_t spin_ns;
+	bool realtime;
+	bool pinned;
+};
+
+typedef struct {
+	PyObject_HEAD
+	struct hb_line_group group;
+	bool open;
+	bool reading;
+	unsigned int sample_size;
+	/* per chip, the line index of each value returned by get_values() */
+	unsigned int chip_lines[HB_GROUP_MAX_LINES][HB_GROUP_MAX_LINES];
+	unsigned int chip_num_lines[HB_GROUP_MAX_LINES];
+} hb_sampler;
+
+struct hb_sampler_reader {
+	hb_sampler *sampler;
+	uint8_t *samples;
+	uint64_t *timestamps;
+	size_t count;
+	uint64_t period_ns;
+	int cpu;
+	int priority;
+	struct hb_sampler_stats stats;
+	int err;
+};
+
+static int sampler_get(hb_sampler *self, uint64_t *levels)
+{
+	enum gpiod_line_value values[HB_GROUP_MAX_LINES];
+	unsigned int chip, i;
+
+	*levels = 0;
+	for (chip = 0; chip < self->group.num_chips; chip++) {
+		if (gpiod_line_request_get_values(self->group.requests[chip],
+						  values))
+			return -1;
+		for (i = 0; i < self->chip_num_lines[chip]; i++) {
+			if (values[i] == GPIOD_LINE_VALUE_ACTIVE)
+				*levels |= 1ULL << self->chip_lines[chip][i];
+		}
+	}
+
+	return 0;
+}
+
+static void sampler_account(struct hb_sampler_stats *stats, uint64_t late,
+			    uint64_t period_ns)
+{
+	double delta;
+
+	if (!stats->samples || late < stats->min_ns)
+		stats->min_ns = late;
+	if (late > stats->max_ns)
+		stats->max_ns = late;
+	/* the next sample was already due */
+	if (period_ns && late >= period_ns)
+		stats->overruns++;
+
+	stats->samples++;
+	delta = late - stats->mean_ns;
+	stats->mean_ns += delta / stats->samples;
+	stats->m2 += delta * (late - stats->mean_ns);
+}
+
+static void *sampler_thread(void *arg)
+{
+	struct hb_sampler_reader *reader = arg;
+	struct hb_sampler_stats *stats = &reader->stats;
+	hb_sampler *sampler = reader->sampler;
+	unsigned int size = sampler->sample_size, b;
+	struct sched_param param;
+	uint64_t target, now, levels;
+	uint8_t *out;
+	cpu_set_t cpus;
+	size_t i;
+
+	if (reader->cpu >= 0) {
+		CPU_ZERO(&cpus);
+		CPU_SET(reader->cpu, &cpus);
+		stats->pinned = !pthread_setaffinity_np(pthread_self(),
+							sizeof(cpus), &cpus);
+	}
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = reader->priority;
+	stats->realtime = !pthread_setschedparam(pthread_self(), SCHED_FIFO,
+						 &param);
+
+	/* a period of 0 samples back to back, there is nothing to wait for */
+	if (reader->period_ns)
+		stats->spin_ns = hb_calibrate_spin();
+
+	target = hb_now_ns() + (reader->period_ns ? HB_LEAD_NS : 0);
+	for (i = 0, out = reader->samples; i < reader->count; i++, out += size) {
+		if (reader->period_ns)
+			hb_wait_until(target, stats->spin_ns);
+		now = hb_now_ns();
+
+		if (sampler_get(sampler, &levels)) {
+			reader->err = errno;
+			break;
+		}
+		for (b = 0; b < size; b++)
+			out[b] = levels >> (8 * b);
+		if (reader->timestamps)
+			reader->timestamps[i] = now;
+
+		if (!i)
+			stats->first_ns = now;
+		stats->last_ns = now;
+		if (reader->period_ns) {
+			sampler_account(stats, now - target, reader->period_ns);
+			target += reader->period_ns;
+		} else {
+			stats->samples++;
+		}
+	}
+
+	return NULL;
+}
+
+static int sampler_init(hb_sampler *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "lines", NULL };
+	struct gpiod_line_settings *settings;
+	unsigned int line, chip;
+	PyObject *lines;
+	int ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &lines))
+		return -1;
+
+	if (self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Sampler already open");
+		return -1;
+	}
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+
+	ret = hb_line_group_open(&self->group, lines, settings, NULL, 0);
+	gpiod_line_settings_free(settings);
+	if (ret)
+		return -1;
+	self->open = true;
+
+	/* get_values() returns the lines of a chip in the order requested */
+	memset(self->chip_num_lines, 0, sizeof(self->chip_num_lines));
+	for (line = 0; line < self->group.num_lines; line++) {
+		chip = self->group.line_chip[line];
+		self->chip_lines[chip][self->chip_num_lines[chip]++] = line;
+	}
+
+	for (self->sample_size = 1; self->sample_size * 8 < self->group.num_lines;)
+		self->sample_size *= 2;
+
+	return 0;
+}
+
+static void sampler_release(hb_sampler *self)
+{
+	if (self->open)
+		hb_line_group_close(&self->group);
+	self->open = false;
+}
+
+static void sampler_dealloc(hb_sampler *self)
+{
+	sampler_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int sampler_check(hb_sampler *self)
+{
+	if (!self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Sampler is closed");
+		return -1;
+	}
+	if (self->reading) {
+		PyErr_SetString(PyExc_RuntimeError, "Sampler is reading");
+		return -1;
+	}
+
+	return 0;
+}
+
+static PyObject *sampler_read(hb_sampler *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "buffer", "rate_hz", "count", "timestamps",
+				  "cpu", "priority", NULL };
+	struct hb_sampler_reader reader;
+	struct hb_sampler_stats *stats = &reader.stats;
+	Py_buffer samples = { 0 }, timestamps = { 0 };
+	PyObject *ts_obj = Py_None, *result = NULL;
+	Py_ssize_t count = -1;
+	double rate_hz = 0.0, stddev, achieved = 0.0;
+	sigset_t all, old;
+	pthread_t thread;
+	int ret;
+
+	memset(&reader, 0, sizeof(reader));
+	reader.sampler = self;
+	reader.cpu = -1;
+	reader.priority = HB_SAMPLER_PRIORITY;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "w*|dnOii", kwlist,
+					 &samples, &rate_hz, &count, &ts_obj,
+					 &reader.cpu, &reader.priority))
+		return NULL;
+	if (sampler_check(self))
+		goto out;
+
+	if (rate_hz < 0.0) {
+		PyErr_SetString(PyExc_ValueError, "rate_hz must not be negative");
+		goto out;
+	}
+	if (rate_hz > 0.0)
+		reader.period_ns = (uint64_t)(HB_NSEC_PER_SEC / rate_hz + 0.5);
+
+	if (count < 0)
+		count = samples.len / self->sample_size;
+	if ((size_t)count * self->sample_size > (size_t)samples.len) {
+		PyErr_Format(PyExc_ValueError,
+			     "buffer holds %zd samples of %u bytes",
+			     samples.len / self->sample_size,
+			     self->sample_size);
+		goto out;
+	}
+	reader.samples = samples.buf;
+	reader.count = count;
+
+	if (ts_obj != Py_None) {
+		if (PyObject_GetBuffer(ts_obj, &timestamps,
+				       PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS))
+			goto out;
+		if ((size_t)timestamps.len < (size_t)count * sizeof(uint64_t)) {
+			PyErr_SetString(PyExc_ValueError,
+					"timestamps holds fewer than count uint64");
+			goto out;
+		}
+		reader.timestamps = timestamps.buf;
+	}
+
+	self->reading = true;
+	Py_BEGIN_ALLOW_THREADS
+	/* keep signals on the interpreter's main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	ret = pthread_create(&thread, NULL, sampler_thread, &reader);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (!ret)
+		pthread_join(thread, NULL);
+	Py_END_ALLOW_THREADS
+	self->reading = false;
+
+	if (ret) {
+		errno = ret;
+		PyErr_SetFromErrno(PyExc_OSError);
+		goto out;
+	}
+	if (reader.err) {
+		errno = reader.err;
+		PyErr_SetFromErrno(PyExc_OSError);
+		goto out;
+	}
+
+	stddev = stats->samples > 1 ?
+		 sqrt(stats->m2 / (stats->samples - 1)) : 0.0;
+	if (stats->samples > 1 && stats->last_ns > stats->first_ns)
+		achieved = (double)(stats->samples - 1) * HB_NSEC_PER_SEC /
+			   (stats->last_ns - stats->first_ns);
+
+	result = Py_BuildValue("{s:K,s:d,s:K,s:K,s:K,s:d,s:d,s:K,s:K,s:K,s:O,s:O}",
+			       "samples", (unsigned long long)stats->samples,
+			       "rate_hz", achieved,
+			       "period_ns", (unsigned long long)reader.period_ns,
+			       "min_ns", (unsigned long long)stats->min_ns,
+			       "max_ns", (unsigned long long)stats->max_ns,
+			       "mean_ns", stats->mean_ns,
+			       "stddev_ns", stddev,
+			       "overruns", (unsigned long long)stats->overruns,
+			       "duration_ns",
+			       (unsigned long long)(stats->last_ns - stats->first_ns),
+			       "spin_ns", (unsigned long long)stats->spin_ns,
+			       "realtime", stats->realtime ? Py_True : Py_False,
+			       "pinned", stats->pinned ? Py_True : Py_False);
+
+out:
+	if (timestamps.obj)
+		PyBuffer_Release(&timestamps);
+	PyBuffer_Release(&samples);
+	return result;
+}
+
+static PyObject *sampler_get_value(hb_sampler *self, PyObject *Py_UNUSED(args))
+{
+	uint64_t levels;
+
+	if (sampler_check(self))
+		return NULL;
+	if (sampler_get(self, &levels))
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	return PyLong_FromUnsignedLongLong(levels);
+}
+
+static PyObject *sampler_close(hb_sampler *self, PyObject *Py_UNUSED(args))
+{
+	if (self->reading) {
+		PyErr_SetString(PyExc_RuntimeError, "Sampler is reading");
+		return NULL;
+	}
+
+	sampler_release(self);
+	Py_RETURN_NONE;
+}
+
+static PyObject *sampler_get_sample_size(hb_sampler *self, void *closure)
+{
+	(void)closure;
+	return PyLong_FromUnsignedLong(self->sample_size);
+}
+
+static PyMethodDef sampler_methods[] = {
+	{ "read", (PyCFunction)(void (*)(void))sampler_read,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "Fill a writable buffer with samples and return the timing" },
+	{ "get", (PyCFunction)sampler_get_value, METH_NOARGS,
+	  "Return one sample of all the lines as an int" },
+	{ "close", (PyCFunction)sampler_close, METH_NOARGS,
+	  "Release the lines" },
+	{ NULL }
+};
+
+static PyGetSetDef sampler_getset[] = {
+	{ "sample_size", (getter)sampler_get_sample_size, NULL,
+	  "Bytes per sample: 1, 2, 4 or 8", NULL },
+	{ NULL }
+};
+
+static PyTypeObject hb_sampler_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.Sampler",
+	.tp_doc = "Timed bulk sampling of a group of GPIO input lines",
+	.tp_basicsize = sizeof(hb_sampler),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)sampler_init,
+	.tp_dealloc = (destructor)sampler_dealloc,
+	.tp_methods = sampler_methods,
+	.tp_getset = sampler_getset,
+};
+
+int hb_sampler_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_sampler_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_sampler_type);
+	if (PyModule_AddObject(module, "Sampler",
+			       (PyObject *)&hb_sampler_type) < 0) {
+		Py_DECREF(&hb_sampler_type);
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,611 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Software PWM for lines without a PWM controller.
+ *
+ * Every channel in the process is driven by one scheduler thread. Each
+ * channel only keeps the deadline of its next edge; the thread sleeps until
+ * the earliest one, then fires every edge due within a small slack in a
+ * single set_values_subset() call per chip. All channels of a chip share
+ * one line request for that, which is re-requested with the current levels
+ * whenever a channel is added or removed.
+ *
+ * Duty cycle and period changes are latched at the start of the next period
+ * so that no runt pulse is produced. Channels at 0% or 100% are constant and
+ * cost no wakeups at all.
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HB_SOFTPWM_MAX_CHIPS	8
+#define HB_SOFTPWM_PRIORITY	50
+/* edges this close together are fired by the same wakeup */
+#define HB_SOFTPWM_SLACK_NS	20000ULL
+#define HB_SOFTPWM_IDLE		UINT64_MAX
+
+struct hb_softpwm_chip {
+	char path[64];
+	struct gpiod_line_request *request;
+	/* errno of a failed re-request, the chip's channels are stopped */
+	int err;
+	unsigned int num_lines;
+	unsigned int offsets[HB_GROUP_MAX_LINES];
+	/* edges collected by the current wakeup */
+	unsigned int num_batch;
+	unsigned int batch_offsets[HB_GROUP_MAX_LINES];
+	enum gpiod_line_value batch_values[HB_GROUP_MAX_LINES];
+};
+
+typedef struct hb_softpwm {
+	PyObject_HEAD
+	bool attached;
+	unsigned int chip;
+	unsigned int offset;
+	/* everything below is protected by scheduler.lock */
+	bool running;
+	bool level;
+	bool high_phase;
+	uint64_t period_ns;
+	uint64_t high_ns;
+	/* latched at the start of the next period */
+	uint64_t new_period_ns;
+	uint64_t new_high_ns;
+	uint64_t period_start;
+	uint64_t next_edge;
+	struct hb_softpwm *next;
+} hb_softpwm;
+
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool running;
+	hb_softpwm *channels;
+	struct hb_softpwm_chip chips[HB_SOFTPWM_MAX_CHIPS];
+	uint64_t wakeups;
+	uint64_t edges;
+	uint64_t max_late_ns;
+} scheduler = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static enum gpiod_line_value level_value(bool level)
+{
+	return level ? GPIOD_LINE_VALUE_ACTIVE : GPIOD_LINE_VALUE_INACTIVE;
+}
+
+static void softpwm_queue(hb_softpwm *ch, bool level)
+{
+	struct hb_softpwm_chip *chip = &scheduler.chips[ch->chip];
+
+	if (ch->level == level || !chip->request)
+		return;
+	ch->level = level;
+
+	chip->batch_offsets[chip->num_batch] = ch->offset;
+	chip->batch_values[chip->num_batch++] = level_value(level);
+	scheduler.edges++;
+}
+
+static void softpwm_flush(void)
+{
+	struct hb_softpwm_chip *chip;
+	unsigned int i;
+
+	for (i = 0; i < HB_SOFTPWM_MAX_CHIPS; i++) {
+		chip = &scheduler.chips[i];
+		if (!chip->num_batch || !chip->request)
+			continue;
+		/* nothing to report a failure to, the next edge retries */
+		gpiod_line_request_set_values_subset(chip->request,
+						     chip->num_batch,
+						     chip->batch_offsets,
+						     chip->batch_values);
+		chip->num_batch = 0;
+	}
+}
+
+static void softpwm_advance(hb_softpwm *ch, uint64_t now)
+{
+	if (ch->high_phase) {
+		softpwm_queue(ch, false);
+		ch->high_phase = false;
+		ch->next_edge = ch->period_start + ch->period_ns;
+		return;
+	}
+
+	/* a new period starts, pick up the latest configuration */
+	ch->period_ns = ch->new_period_ns;
+	ch->high_ns = ch->new_high_ns;
+	ch->period_start = ch->next_edge;
+	/* resynchronise instead of replaying periods missed while stalled */
+	if (ch->period_start + ch->period_ns <= now)
+		ch->period_start = now;
+
+	if (!ch->high_ns || ch->high_ns >= ch->period_ns) {
+		softpwm_queue(ch, ch->high_ns != 0);
+		ch->next_edge = HB_SOFTPWM_IDLE;
+		return;
+	}
+
+	softpwm_queue(ch, true);
+	ch->high_phase = true;
+	ch->next_edge = ch->period_start + ch->high_ns;
+}
+
+static void *softpwm_thread(void *arg)
+{
+	struct sched_param param;
+	uint64_t now, next;
+	struct timespec ts;
+	hb_softpwm *ch;
+
+	(void)arg;
+
+	/* best effort, servo pulses only need to be steady, not exact */
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = HB_SOFTPWM_PRIORITY;
+	pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+
+	pthread_mutex_lock(&scheduler.lock);
+	for (;;) {
+		now = hb_now_ns();
+		next = HB_SOFTPWM_IDLE;
+
+		for (ch = scheduler.channels; ch; ch = ch->next) {
+			if (!ch->running)
+				continue;
+			if (ch->next_edge <= now + HB_SOFTPWM_SLACK_NS) {
+				if (ch->next_edge != HB_SOFTPWM_IDLE &&
+				    now > ch->next_edge &&
+				    now - ch->next_edge > scheduler.max_late_ns)
+					scheduler.max_late_ns =
+						now - ch->next_edge;
+				softpwm_advance(ch, now);
+			}
+			if (ch->next_edge < next)
+				next = ch->next_edge;
+		}
+		softpwm_flush();
+
+		if (next == HB_SOFTPWM_IDLE) {
+			pthread_cond_wait(&scheduler.cond, &scheduler.lock);
+		} else {
+			ts.tv_sec = next / HB_NSEC_PER_SEC;
+			ts.tv_nsec = next % HB_NSEC_PER_SEC;
+			pthread_cond_timedwait(&scheduler.cond, &scheduler.lock,
+					       &ts);
+		}
+		scheduler.wakeups++;
+	}
+
+	return NULL;
+}
+
+/* Called with scheduler.lock held. */
+static int scheduler_start(void)
+{
+	pthread_condattr_t attr;
+	sigset_t all, old;
+	pthread_t thread;
+	int ret;
+
+	if (scheduler.running)
+		return 0;
+
+	/* deadlines are CLOCK_MONOTONIC, like everything else here */
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&scheduler.cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	/* keep signals on the interpreter's main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	ret = pthread_create(&thread, NULL, softpwm_thread, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (ret) {
+		pthread_cond_destroy(&scheduler.cond);
+		errno = ret;
+		return -1;
+	}
+
+	pthread_detach(thread);
+	scheduler.running = true;
+
+	return 0;
+}
+
+/*
+ * Request all lines currently assigned to a chip, keeping the level of the
+ * existing channels. Called with scheduler.lock held.
+ */
+static int chip_rerequest(struct hb_softpwm_chip *chip, unsigned int index)
+{
+	enum gpiod_line_value values[HB_GROUP_MAX_LINES];
+	struct gpiod_line_settings *settings;
+	struct gpiod_line_request *request;
+	hb_softpwm *ch;
+	unsigned int i;
+
+	for (i = 0; i < chip->num_lines; i++) {
+		values[i] = GPIOD_LINE_VALUE_INACTIVE;
+		for (ch = scheduler.channels; ch; ch = ch->next) {
+			if (ch->chip == index && ch->offset == chip->offsets[i])
+				values[i] = level_value(ch->level);
+		}
+	}
+
+	/* the old request has to go first, it still owns the lines */
+	if (chip->request) {
+		gpiod_line_request_release(chip->request);
+		chip->request = NULL;
+	}
+	if (!chip->num_lines)
+		return 0;
+
+	settings = gpiod_line_settings_new();
+	if (!settings)
+		return -1;
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_OUTPUT);
+
+	request = hb_request_lines(chip->path, chip->offsets, chip->num_lines,
+				   settings, values, 0);
+	gpiod_line_settings_free(settings);
+	if (!request)
+		return -1;
+
+	chip->request = request;
+	chip->err = 0;
+
+	return 0;
+}
+
+/*
+ * The chip's lines could not be requested back, somebody may have taken
+ * one while they were released. Its channels stop and report err from now
+ * on. Called with scheduler.lock held.
+ */
+static void chip_lost(struct hb_softpwm_chip *chip, unsigned int index,
+		      int err)
+{
+	hb_softpwm *ch;
+
+	chip->err = err;
+	chip->num_batch = 0;
+	for (ch = scheduler.channels; ch; ch = ch->next) {
+		if (ch->chip != index)
+			continue;
+		ch->running = false;
+		ch->high_phase = false;
+		ch->level = false;
+		ch->next_edge = HB_SOFTPWM_IDLE;
+	}
+}
+
+/* Called with scheduler.lock held. */
+static int softpwm_lost(hb_softpwm *self)
+{
+	struct hb_softpwm_chip *chip = &scheduler.chips[self->chip];
+
+	if (chip->request)
+		return 0;
+	errno = chip->err;
+	return -1;
+}
+
+static int softpwm_attach(hb_softpwm *self, const char *chip_path)
+{
+	struct hb_softpwm_chip *chip = NULL;
+	unsigned int i, free_slot = HB_SOFTPWM_MAX_CHIPS;
+	int ret = -1;
+
+	if (strlen(chip_path) >= sizeof(chip->path)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	pthread_mutex_lock(&scheduler.lock);
+
+	for (i = 0; i < HB_SOFTPWM_MAX_CHIPS; i++) {
+		if (!scheduler.chips[i].num_lines) {
+			if (free_slot == HB_SOFTPWM_MAX_CHIPS)
+				free_slot = i;
+			continue;
+		}
+		if (!strcmp(scheduler.chips[i].path, chip_path))
+			break;
+	}
+	if (i == HB_SOFTPWM_MAX_CHIPS) {
+		if (free_slot == HB_SOFTPWM_MAX_CHIPS) {
+			errno = ENOSPC;
+			goto out;
+		}
+		i = free_slot;
+		strcpy(scheduler.chips[i].path, chip_path);
+	}
+	chip = &scheduler.chips[i];
+
+	if (chip->num_lines == HB_GROUP_MAX_LINES) {
+		errno = ENOSPC;
+		goto out;
+	}
+	for (i = 0; i < chip->num_lines; i++) {
+		if (chip->offsets[i] == self->offset) {
+			errno = EBUSY;
+			goto out;
+		}
+	}
+
+	if (scheduler_start())
+		goto out;
+
+	chip->offsets[chip->num_lines++] = self->offset;
+	self->chip = chip - scheduler.chips;
+	if (chip_rerequest(chip, self->chip)) {
+		chip->num_lines--;
+		/* bring the other channels of the chip back */
+		i = errno;
+		if (chip_rerequest(chip, self->chip))
+			chip_lost(chip, self->chip, errno);
+		errno = i;
+		goto out;
+	}
+
+	self->next = scheduler.channels;
+	scheduler.channels = self;
+	self->attached = true;
+	ret = 0;
+out:
+	pthread_mutex_unlock(&scheduler.lock);
+
+	return ret;
+}
+
+static void softpwm_detach(hb_softpwm *self)
+{
+	struct hb_softpwm_chip *chip;
+	hb_softpwm **pos;
+	unsigned int i;
+
+	if (!self->attached)
+		return;
+
+	pthread_mutex_lock(&scheduler.lock);
+	for (pos = &scheduler.channels; *pos; pos = &(*pos)->next) {
+		if (*pos == self) {
+			*pos = self->next;
+			break;
+		}
+	}
+
+	/* leave the line low rather than frozen mid-pulse */
+	chip = &scheduler.chips[self->chip];
+	if (self->level && chip->request)
+		gpiod_line_request_set_value(chip->request, self->offset,
+					     GPIOD_LINE_VALUE_INACTIVE);
+
+	for (i = 0; i < chip->num_lines; i++) {
+		if (chip->offsets[i] == self->offset) {
+			chip->offsets[i] = chip->offsets[--chip->num_lines];
+			break;
+		}
+	}
+	if (chip_rerequest(chip, self->chip))
+		chip_lost(chip, self->chip, errno);
+
+	self->attached = false;
+	pthread_mutex_unlock(&scheduler.lock);
+}
+
+static int softpwm_check(hb_softpwm *self)
+{
+	if (!self->attached) {
+		PyErr_SetString(PyExc_RuntimeError, "SoftPWM is closed");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int softpwm_init(hb_softpwm *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "chip", "offset", NULL };
+	const char *chip_path;
+	int ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "sI", kwlist,
+					 &chip_path, &self->offset))
+		return -1;
+
+	if (self->attached) {
+		PyErr_SetString(PyExc_RuntimeError, "SoftPWM already open");
+		return -1;
+	}
+
+	self->next_edge = HB_SOFTPWM_IDLE;
+
+	Py_BEGIN_ALLOW_THREADS
+	ret = softpwm_attach(self, chip_path);
+	Py_END_ALLOW_THREADS
+	if (ret) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, chip_path);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void softpwm_dealloc(hb_softpwm *self)
+{
+	softpwm_detach(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *softpwm_configure(hb_softpwm *self, PyObject *args)
+{
+	unsigned long long period_ns, high_ns;
+
+	if (!PyArg_ParseTuple(args, "KK", &period_ns, &high_ns))
+		return NULL;
+	if (softpwm_check(self))
+		return NULL;
+	if (!period_ns) {
+		PyErr_SetString(PyExc_ValueError,
+				"period_ns must be greater than 0");
+		return NULL;
+	}
+
+	pthread_mutex_lock(&scheduler.lock);
+	if (softpwm_lost(self)) {
+		pthread_mutex_unlock(&scheduler.lock);
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+	self->new_period_ns = period_ns;
+	self->new_high_ns = high_ns;
+	/* a constant output has no next period to latch the change at */
+	if (self->running && self->next_edge == HB_SOFTPWM_IDLE) {
+		self->next_edge = hb_now_ns();
+		pthread_cond_signal(&scheduler.cond);
+	}
+	pthread_mutex_unlock(&scheduler.lock);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *softpwm_enable(hb_softpwm *self, PyObject *Py_UNUSED(args))
+{
+	if (softpwm_check(self))
+		return NULL;
+
+	pthread_mutex_lock(&scheduler.lock);
+	if (softpwm_lost(self)) {
+		pthread_mutex_unlock(&scheduler.lock);
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+	if (!self->running) {
+		self->running = true;
+		self->high_phase = false;
+		self->next_edge = hb_now_ns();
+		pthread_cond_signal(&scheduler.cond);
+	}
+	pthread_mutex_unlock(&scheduler.lock);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *softpwm_disable(hb_softpwm *self, PyObject *Py_UNUSED(args))
+{
+	struct hb_softpwm_chip *chip;
+	int ret = 0;
+
+	if (softpwm_check(self))
+		return NULL;
+
+	pthread_mutex_lock(&scheduler.lock);
+	self->running = false;
+	self->high_phase = false;
+	self->next_edge = HB_SOFTPWM_IDLE;
+	chip = &scheduler.chips[self->chip];
+	if (softpwm_lost(self)) {
+		ret = -1;
+	} else if (self->level) {
+		ret = gpiod_line_request_set_value(chip->request, self->offset,
+						   GPIOD_LINE_VALUE_INACTIVE);
+		if (!ret)
+			self->level = false;
+	}
+	pthread_mutex_unlock(&scheduler.lock);
+
+	if (ret)
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *softpwm_close(hb_softpwm *self, PyObject *Py_UNUSED(args))
+{
+	Py_BEGIN_ALLOW_THREADS
+	softpwm_detach(self);
+	Py_END_ALLOW_THREADS
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *softpwm_stats(PyObject *cls, PyObject *Py_UNUSED(args))
+{
+	unsigned long long wakeups, edges, max_late_ns;
+
+	(void)cls;
+
+	pthread_mutex_lock(&scheduler.lock);
+	wakeups = scheduler.wakeups;
+	edges = scheduler.edges;
+	max_late_ns = scheduler.max_late_ns;
+	pthread_mutex_unlock(&scheduler.lock);
+
+	return Py_BuildValue("{s:K,s:K,s:K}",
+			     "wakeups", wakeups,
+			     "edges", edges,
+			     "max_late_ns", max_late_ns);
+}
+
+static PyMethodDef softpwm_methods[] = {
+	{ "configure", (PyCFunction)softpwm_configure, METH_VARARGS,
+	  "Set the period and high time, applied from the next period" },
+	{ "enable", (PyCFunction)softpwm_enable, METH_NOARGS,
+	  "Start generating the waveform" },
+	{ "disable", (PyCFunction)softpwm_disable, METH_NOARGS,
+	  "Stop generating the waveform and drive the line low" },
+	{ "close", (PyCFunction)softpwm_close, METH_NOARGS,
+	  "Release the line" },
+	{ "stats", (PyCFunction)softpwm_stats, METH_NOARGS | METH_CLASS,
+	  "Return the scheduler wakeup, edge and lateness counters" },
+	{ NULL }
+};
+
+static PyTypeObject hb_softpwm_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.SoftPWM",
+	.tp_doc = "Software PWM on one GPIO line",
+	.tp_basicsize = sizeof(hb_softpwm),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)softpwm_init,
+	.tp_dealloc = (destructor)softpwm_dealloc,
+	.tp_methods = softpwm_methods,
+};
+
+int hb_softpwm_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_softpwm_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_softpwm_type);
+	if (PyModule_AddObject(module, "SoftPWM",
+			       (PyObject *)&hb_softpwm_type) < 0) {
+		Py_DECREF(&hb_softpwm_type);
+		return -1;
+	}
+
+	return 0;
+}
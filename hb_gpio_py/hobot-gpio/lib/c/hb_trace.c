@@ -0,0 +1,544 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Trace recorder: every edge of a group of input lines, appended to a
+ * memory mapped file in the format of hb_trace.h.
+ *
+ * A thread per recorder polls the line request fds of the group, drains
+ * the ready ones in batches, orders the batch by timestamp and encodes it
+ * straight into the mapping. No Python code runs per edge. The file grows
+ * by HB_TRACE_CHUNK with ftruncate() and mremap(), and is cut down to the
+ * data written when the recorder is closed.
+ */
+
+#include "hb_native.h"
+#include "hb_trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define HB_TRACE_BATCH		64
+/* the kernel caps a request's event buffer at 16 events per line */
+#define HB_TRACE_EVENT_BUFFER	1024
+#define HB_TRACE_CHUNK		(4 * 1024 * 1024)
+
+struct hb_trace_edge {
+	uint64_t ts;
+	unsigned int line;
+	bool rising;
+};
+
+typedef struct {
+	PyObject_HEAD
+	struct hb_line_group group;
+	bool open;
+	int fd;
+	uint8_t *map;
+	size_t map_size;
+	size_t header_size;
+	/* the recorder thread's, read from Python with atomics */
+	uint64_t data_size;
+	uint64_t events;
+	uint64_t missed;
+	uint64_t last_ts;
+	unsigned long last_seqno[HB_GROUP_MAX_LINES];
+	pthread_t thread;
+	bool running;
+	int wake[2];
+	int err;
+} hb_trace;
+
+static int trace_line(hb_trace *self, unsigned int chip, unsigned int offset)
+{
+	unsigned int line;
+
+	for (line = 0; line < self->group.num_lines; line++) {
+		if (self->group.line_chip[line] == chip &&
+		    self->group.line_offset[line] == offset)
+			return line;
+	}
+	return -1;
+}
+
+/*
+ * Blocks are allocated up front: a store into a hole of the shared mapping
+ * on a full filesystem is a SIGBUS, which would take the interpreter down
+ * instead of stopping the recorder with ENOSPC.
+ */
+static int trace_reserve(int fd, size_t from, size_t size)
+{
+	int err;
+
+	err = posix_fallocate(fd, from, size - from);
+	if (err) {
+		errno = err;
+		return -1;
+	}
+	return 0;
+}
+
+static int trace_grow(hb_trace *self, size_t needed)
+{
+	size_t size = self->map_size;
+	uint8_t *map;
+
+	while (size < needed)
+		size += HB_TRACE_CHUNK;
+	if (size == self->map_size)
+		return 0;
+
+	if (trace_reserve(self->fd, self->map_size, size))
+		return -1;
+	map = mremap(self->map, self->map_size, size, MREMAP_MAYMOVE);
+	if (map == MAP_FAILED)
+		return -1;
+	self->map = map;
+	self->map_size = size;
+
+	return 0;
+}
+
+static int trace_append(hb_trace *self, struct hb_trace_edge *edges,
+			unsigned int num)
+{
+	struct hb_trace_header *header;
+	struct hb_trace_edge tmp;
+	uint64_t size = self->data_size;
+	unsigned int i, j;
+	uint8_t *out;
+
+	/* chips are drained one after the other, put their edges in order */
+	for (i = 1; i < num; i++) {
+		tmp = edges[i];
+		for (j = i; j && edges[j - 1].ts > tmp.ts; j--)
+			edges[j] = edges[j - 1];
+		edges[j] = tmp;
+	}
+
+	if (trace_grow(self, self->header_size + size +
+			     (size_t)num * HB_TRACE_RECORD_MAX))
+		return -1;
+
+	out = self->map + self->header_size;
+	for (i = 0; i < num; i++) {
+		size += hb_trace_encode(out + size,
+					(int64_t)(edges[i].ts - self->last_ts),
+					edges[i].line, edges[i].rising);
+		self->last_ts = edges[i].ts;
+	}
+
+	/* readers trust data_size, publish it after the records */
+	header = (struct hb_trace_header *)self->map;
+	header->events = self->events + num;
+	header->missed = __atomic_load_n(&self->missed, __ATOMIC_RELAXED);
+	__atomic_store_n(&header->data_size, size, __ATOMIC_RELEASE);
+	__atomic_store_n(&self->data_size, size, __ATOMIC_RELAXED);
+	__atomic_store_n(&self->events, self->events + num, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+static int trace_drain(hb_trace *self, unsigned int chip,
+		       struct gpiod_edge_event_buffer *buffer,
+		       struct hb_trace_edge *edges, unsigned int *num)
+{
+	struct gpiod_edge_event *event;
+	unsigned long seqno;
+	int count, line, i;
+
+	count = gpiod_line_request_read_edge_events(self->group.requests[chip],
+						    buffer, HB_TRACE_BATCH);
+	if (count < 0)
+		return errno == EAGAIN ? 0 : -1;
+
+	for (i = 0; i < count; i++) {
+		event = gpiod_edge_event_buffer_get_event(buffer, i);
+		line = trace_line(self, chip,
+				  gpiod_edge_event_get_line_offset(event));
+		if (line < 0)
+			continue;
+
+		/* the kernel numbers edges per line, a gap means its kfifo overflowed */
+		seqno = gpiod_edge_event_get_line_seqno(event);
+		if (self->last_seqno[line] && seqno > self->last_seqno[line] + 1)
+			__atomic_add_fetch(&self->missed,
+					   seqno - self->last_seqno[line] - 1,
+					   __ATOMIC_RELAXED);
+		self->last_seqno[line] = seqno;
+
+		edges[*num].ts = gpiod_edge_event_get_timestamp_ns(event);
+		edges[*num].line = line;
+		edges[*num].rising = gpiod_edge_event_get_event_type(event) ==
+				     GPIOD_EDGE_EVENT_RISING_EDGE;
+		(*num)++;
+	}
+
+	return 0;
+}
+
+static void *trace_thread(void *arg)
+{
+	struct hb_trace_edge edges[HB_GROUP_MAX_LINES * HB_TRACE_BATCH];
+	struct pollfd pfds[HB_GROUP_MAX_LINES + 1];
+	struct gpiod_edge_event_buffer *buffer;
+	hb_trace *self = arg;
+	unsigned int chip, num;
+	bool stop = false;
+
+	buffer = gpiod_edge_event_buffer_new(HB_TRACE_BATCH);
+	if (!buffer) {
+		self->err = ENOMEM;
+		return NULL;
+	}
+
+	pfds[0].fd = self->wake[0];
+	pfds[0].events = POLLIN;
+	for (chip = 0; chip < self->group.num_chips; chip++) {
+		pfds[chip + 1].fd =
+			gpiod_line_request_get_fd(self->group.requests[chip]);
+		pfds[chip + 1].events = POLLIN;
+	}
+
+	while (!stop) {
+		if (poll(pfds, self->group.num_chips + 1, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			self->err = errno;
+			break;
+		}
+		/* drain once more on the way out, the fds are non-blocking */
+		if (pfds[0].revents & POLLIN)
+			stop = true;
+
+		num = 0;
+		for (chip = 0; chip < self->group.num_chips; chip++) {
+			if (!stop && !(pfds[chip + 1].revents & POLLIN))
+				continue;
+			if (trace_drain(self, chip, buffer, edges, &num)) {
+				self->err = errno;
+				stop = true;
+				break;
+			}
+		}
+		if (num && trace_append(self, edges, num)) {
+			self->err = errno;
+			break;
+		}
+	}
+
+	gpiod_edge_event_buffer_free(buffer);
+	return NULL;
+}
+
+/* line i of the table is lines[i], named after names[i] when given */
+static int trace_line_table(hb_trace *self, PyObject *lines, PyObject *names)
+{
+	struct hb_trace_line *entry;
+	const char *path, *base, *name;
+	PyObject *item, *str;
+	unsigned int line;
+	int ret;
+
+	entry = (struct hb_trace_line *)(self->map +
+					 sizeof(struct hb_trace_header));
+	for (line = 0; line < self->group.num_lines; line++, entry++) {
+		item = PySequence_GetItem(lines, line);
+		if (!item)
+			return -1;
+		ret = PyArg_ParseTuple(item, "sI", &path, &entry->offset);
+		if (ret) {
+			base = strrchr(path, '/');
+			snprintf(entry->chip, sizeof(entry->chip), "%s",
+				 base ? base + 1 : path);
+		}
+		Py_DECREF(item);
+		if (!ret)
+			return -1;
+
+		if (!names || line >= (unsigned int)PySequence_Fast_GET_SIZE(names))
+			continue;
+		str = PyObject_Str(PySequence_Fast_GET_ITEM(names, line));
+		if (!str)
+			return -1;
+		name = PyUnicode_AsUTF8(str);
+		if (name)
+			snprintf(entry->name, sizeof(entry->name), "%s", name);
+		Py_DECREF(str);
+		if (!name)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int trace_header(hb_trace *self)
+{
+	struct hb_trace_header *header;
+	struct timespec ts;
+	uint64_t levels;
+
+	/* the initial levels, so that a reader can follow every line */
+	if (hb_line_group_get(&self->group, ~0ULL, &levels)) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+
+	header = (struct hb_trace_header *)self->map;
+	memcpy(header->magic, HB_TRACE_MAGIC, sizeof(header->magic));
+	header->version = HB_TRACE_VERSION;
+	header->num_lines = self->group.num_lines;
+	header->header_size = self->header_size;
+	header->levels = levels;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	header->start_ns = hb_now_ns();
+	header->start_realtime_ns = (uint64_t)ts.tv_sec * HB_NSEC_PER_SEC +
+				    ts.tv_nsec;
+	self->last_ts = header->start_ns;
+
+	return 0;
+}
+
+static void trace_release(hb_trace *self)
+{
+	struct hb_trace_header *header;
+	char c = 0;
+
+	if (self->running) {
+		/* the pipe is empty, nothing else writes to it */
+		(void)!write(self->wake[1], &c, 1);
+		Py_BEGIN_ALLOW_THREADS
+		pthread_join(self->thread, NULL);
+		Py_END_ALLOW_THREADS
+		self->running = false;
+	}
+	if (self->wake[0] >= 0) {
+		close(self->wake[0]);
+		close(self->wake[1]);
+		self->wake[0] = self->wake[1] = -1;
+	}
+
+	if (self->map) {
+		header = (struct hb_trace_header *)self->map;
+		if (!self->err)
+			header->flags |= HB_TRACE_CLOSED;
+		munmap(self->map, self->map_size);
+		self->map = NULL;
+	}
+	if (self->fd >= 0) {
+		/* drop the preallocated tail */
+		(void)!ftruncate(self->fd, self->header_size + self->data_size);
+		close(self->fd);
+		self->fd = -1;
+	}
+
+	if (self->open)
+		hb_line_group_close(&self->group);
+	self->open = false;
+}
+
+static int trace_init(hb_trace *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "lines", "path", "names", "debounce_us",
+				  NULL };
+	struct gpiod_line_settings *settings;
+	PyObject *lines, *names = Py_None, *names_seq = NULL;
+	unsigned long debounce_us = 0;
+	unsigned int chip;
+	sigset_t all, old;
+	const char *path;
+	int ret, fd;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "Os|Ok", kwlist, &lines,
+					 &path, &names, &debounce_us))
+		return -1;
+
+	if (self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "TraceRecorder already open");
+		return -1;
+	}
+	self->fd = -1;
+	self->wake[0] = self->wake[1] = -1;
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_INPUT);
+	gpiod_line_settings_set_edge_detection(settings, GPIOD_LINE_EDGE_BOTH);
+	gpiod_line_settings_set_event_clock(settings,
+					    GPIOD_LINE_CLOCK_MONOTONIC);
+	gpiod_line_settings_set_debounce_period_us(settings, debounce_us);
+
+	ret = hb_line_group_open(&self->group, lines, settings, NULL,
+				 HB_TRACE_EVENT_BUFFER);
+	gpiod_line_settings_free(settings);
+	if (ret)
+		return -1;
+	self->open = true;
+
+	if (names != Py_None) {
+		names_seq = PySequence_Fast(names, "names must be a sequence");
+		if (!names_seq)
+			goto err;
+	}
+
+	self->header_size = sizeof(struct hb_trace_header) +
+			    self->group.num_lines * sizeof(struct hb_trace_line);
+	self->fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (self->fd < 0) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+		goto err;
+	}
+	self->map_size = HB_TRACE_CHUNK;
+	if (trace_reserve(self->fd, 0, self->map_size)) {
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+		goto err;
+	}
+	self->map = mmap(NULL, self->map_size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED, self->fd, 0);
+	if (self->map == MAP_FAILED) {
+		self->map = NULL;
+		PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+		goto err;
+	}
+
+	ret = trace_line_table(self, lines, names_seq);
+	Py_XDECREF(names_seq);
+	names_seq = NULL;
+	if (ret || trace_header(self))
+		goto err;
+
+	/* the last drain on close must not block on a quiet line */
+	for (chip = 0; chip < self->group.num_chips; chip++) {
+		fd = gpiod_line_request_get_fd(self->group.requests[chip]);
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	}
+
+	if (pipe2(self->wake, O_NONBLOCK | O_CLOEXEC)) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		goto err;
+	}
+
+	/* keep signals on the interpreter's main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	ret = pthread_create(&self->thread, NULL, trace_thread, self);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (ret) {
+		errno = ret;
+		PyErr_SetFromErrno(PyExc_OSError);
+		goto err;
+	}
+	self->running = true;
+
+	return 0;
+
+err:
+	Py_XDECREF(names_seq);
+	trace_release(self);
+	return -1;
+}
+
+static void trace_dealloc(hb_trace *self)
+{
+	trace_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *trace_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+	hb_trace *self;
+
+	(void)args;
+	(void)kwds;
+
+	self = (hb_trace *)type->tp_alloc(type, 0);
+	if (self) {
+		self->fd = -1;
+		self->wake[0] = self->wake[1] = -1;
+	}
+
+	return (PyObject *)self;
+}
+
+static PyObject *trace_stats(hb_trace *self, PyObject *Py_UNUSED(args))
+{
+	return Py_BuildValue("{s:K,s:K,s:K,s:O}",
+			     "events", (unsigned long long)
+			     __atomic_load_n(&self->events, __ATOMIC_RELAXED),
+			     "missed", (unsigned long long)
+			     __atomic_load_n(&self->missed, __ATOMIC_RELAXED),
+			     "bytes", (unsigned long long)(self->header_size +
+			     __atomic_load_n(&self->data_size, __ATOMIC_RELAXED)),
+			     "recording", self->running && !self->err ?
+			     Py_True : Py_False);
+}
+
+static PyObject *trace_close(hb_trace *self, PyObject *Py_UNUSED(args))
+{
+	int err;
+
+	trace_release(self);
+	err = self->err;
+	self->err = 0;
+	if (err) {
+		errno = err;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef trace_methods[] = {
+	{ "stats", (PyCFunction)trace_stats, METH_NOARGS,
+	  "Return the number of edges and bytes recorded so far" },
+	{ "close", (PyCFunction)trace_close, METH_NOARGS,
+	  "Stop recording, finish the file and release the lines" },
+	{ NULL }
+};
+
+static PyTypeObject hb_trace_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.TraceRecorder",
+	.tp_doc = "Records the edges of a group of GPIO lines to a trace file",
+	.tp_basicsize = sizeof(hb_trace),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = trace_new,
+	.tp_init = (initproc)trace_init,
+	.tp_dealloc = (destructor)trace_dealloc,
+	.tp_methods = trace_methods,
+};
+
+int hb_trace_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_trace_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_trace_type);
+	if (PyModule_AddObject(module, "TraceRecorder",
+			       (PyObject *)&hb_trace_type) < 0) {
+		Py_DECREF(&hb_trace_type);
+		return -1;
+	}
+
+	return 0;
+}
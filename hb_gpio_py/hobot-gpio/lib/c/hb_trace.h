@@ -0,0 +1,115 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __HB_TRACE_H__
+#define __HB_TRACE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Edge trace file, written by Hobot.GPIO's TraceRecorder and read by
+ * hb_gpio_trace and Hobot.GPIO.gpio_trace. Little endian.
+ *
+ *	struct hb_trace_header
+ *	struct hb_trace_line		[num_lines]
+ *	records				data_size bytes
+ *
+ * Each record is one edge, a LEB128 varint of
+ *
+ *	zigzag(timestamp - previous timestamp) << 7 | line << 1 | rising
+ *
+ * where the first previous timestamp is start_ns and all of them are the
+ * kernel's CLOCK_MONOTONIC edge timestamps. Edges of different chips are
+ * drained separately, so a delta may be negative. The file is grown in
+ * chunks and data_size is updated after every batch: bytes past it are
+ * either preallocated zeroes or a batch that was never committed.
+ */
+
+#define HB_TRACE_MAGIC		"HBTR"
+#define HB_TRACE_VERSION	1
+#define HB_TRACE_MAX_LINES	64
+/* longest record, deltas are below 2^56 ns so the varint holds 64 bits */
+#define HB_TRACE_RECORD_MAX	10
+
+/* hb_trace_header.flags */
+#define HB_TRACE_CLOSED		1	/* the recorder stopped cleanly */
+
+struct hb_trace_header {
+	char magic[4];
+	uint16_t version;
+	uint16_t num_lines;
+	uint32_t header_size;		/* offset of the first record */
+	uint32_t flags;
+	uint64_t start_ns;		/* CLOCK_MONOTONIC */
+	uint64_t start_realtime_ns;	/* CLOCK_REALTIME at start_ns */
+	uint64_t data_size;
+	uint64_t events;
+	uint64_t missed;		/* edges the kernel dropped */
+	uint64_t levels;		/* at start_ns, bit n is line n */
+};
+
+struct hb_trace_line {
+	char chip[24];			/* gpiochipN */
+	uint32_t offset;
+	uint32_t reserved;
+	char name[32];			/* the channel, as given by the caller */
+};
+
+_Static_assert(sizeof(struct hb_trace_header) == 64, "trace header layout");
+_Static_assert(sizeof(struct hb_trace_line) == 64, "trace line layout");
+
+static inline size_t hb_trace_encode(uint8_t *out, int64_t delta,
+				     unsigned int line, int rising)
+{
+	/* zigzag keeps small negative deltas small */
+	uint64_t zz = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+	uint64_t v = zz << 7 | (uint64_t)line << 1 | (rising ? 1 : 0);
+	size_t n = 0;
+
+	while (v >= 0x80) {
+		out[n++] = (v & 0x7f) | 0x80;
+		v >>= 7;
+	}
+	out[n++] = v;
+	return n;
+}
+
+/*
+ * Decodes one record from p, at most end - p bytes. Returns the record's
+ * length, 0 if it is truncated or overlong.
+ */
+static inline size_t hb_trace_decode(const uint8_t *p, const uint8_t *end,
+				     int64_t *delta, unsigned int *line,
+				     int *rising)
+{
+	unsigned int shift = 0;
+	uint64_t v = 0, zz;
+	size_t n = 0;
+
+	do {
+		if (p + n == end || n == HB_TRACE_RECORD_MAX)
+			return 0;
+		v |= (uint64_t)(p[n] & 0x7f) << shift;
+		shift += 7;
+	} while (p[n++] & 0x80);
+
+	zz = v >> 7;
+	*delta = (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+	*line = (v >> 1) & 0x3f;
+	*rising = v & 1;
+	return n;
+}
+
+#endif /* __HB_TRACE_H__ */
@@ -0,0 +1,466 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/*
+ * Waveform engine: plays a list of (line mask, level mask, delay) pulses on
+ * a group of output lines.
+ *
+ * load() compiles the pulses into a flat schedule of per-chip
+ * set_values_subset() calls so that nothing is allocated or looked up while
+ * playing. play() runs the schedule from a dedicated thread, SCHED_FIFO and
+ * pinned to one CPU when permitted, against absolute deadlines, see
+ * hb_wait_until().
+ */
+
+#include "hb_native.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HB_WAVE_PRIORITY		80
+
+/* one set_values_subset() call */
+struct hb_wave_op {
+	unsigned int chip;
+	unsigned int num;
+	/* index of the first offset/value in the schedule arrays */
+	unsigned int first;
+};
+
+struct hb_wave_step {
+	uint64_t delay_ns;
+	unsigned int first_op;
+	unsigned int num_ops;
+};
+
+struct hb_wave_stats {
+	uint64_t steps;
+	uint64_t min_ns;
+	uint64_t max_ns;
+	double mean_ns;
+	/* running sum of squared differences from the mean */
+	double m2;
+	uint64_t overruns;
+	uint64_t duration_ns;
+	uint64_t spin_ns;
+	bool realtime;
+	bool pinned;
+};
+
+typedef struct hb_wave {
+	PyObject_HEAD
+	struct hb_line_group group;
+	bool open;
+	bool playing;
+	/* compiled schedule */
+	struct hb_wave_step *steps;
+	unsigned int num_steps;
+	struct hb_wave_op *ops;
+	unsigned int *offsets;
+	enum gpiod_line_value *values;
+} hb_wave;
+
+struct hb_wave_player {
+	hb_wave *wave;
+	unsigned long repeat;
+	int cpu;
+	int priority;
+	struct hb_wave_stats stats;
+	int err;
+};
+
+static void wave_free_schedule(hb_wave *self)
+{
+	free(self->steps);
+	free(self->ops);
+	free(self->offsets);
+	free(self->values);
+	self->steps = NULL;
+	self->ops = NULL;
+	self->offsets = NULL;
+	self->values = NULL;
+	self->num_steps = 0;
+}
+
+static void wave_account(struct hb_wave_stats *stats, uint64_t late,
+			 uint64_t delay_ns)
+{
+	double delta;
+
+	if (!stats->steps || late < stats->min_ns)
+		stats->min_ns = late;
+	if (late > stats->max_ns)
+		stats->max_ns = late;
+	/* the next step was already due, the waveform is distorted */
+	if (late >= delay_ns)
+		stats->overruns++;
+
+	stats->steps++;
+	delta = late - stats->mean_ns;
+	stats->mean_ns += delta / stats->steps;
+	stats->m2 += delta * (late - stats->mean_ns);
+}
+
+static void *wave_thread(void *arg)
+{
+	struct hb_wave_player *player = arg;
+	struct hb_wave_stats *stats = &player->stats;
+	hb_wave *wave = player->wave;
+	struct sched_param param;
+	struct hb_wave_step *step;
+	struct hb_wave_op *op;
+	uint64_t start, target, now;
+	unsigned long r;
+	unsigned int i, j;
+	cpu_set_t cpus;
+
+	if (player->cpu >= 0) {
+		CPU_ZERO(&cpus);
+		CPU_SET(player->cpu, &cpus);
+		stats->pinned = !pthread_setaffinity_np(pthread_self(),
+							sizeof(cpus), &cpus);
+	}
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = player->priority;
+	stats->realtime = !pthread_setschedparam(pthread_self(), SCHED_FIFO,
+						 &param);
+
+	stats->spin_ns = hb_calibrate_spin();
+
+	start = hb_now_ns() + HB_LEAD_NS;
+	target = start;
+	for (r = 0; r < player->repeat; r++) {
+		for (i = 0; i < wave->num_steps; i++) {
+			step = &wave->steps[i];
+
+			hb_wait_until(target, stats->spin_ns);
+			now = hb_now_ns();
+
+			for (j = 0; j < step->num_ops; j++) {
+				op = &wave->ops[step->first_op + j];
+				if (gpiod_line_request_set_values_subset(
+						wave->group.requests[op->chip],
+						op->num,
+						&wave->offsets[op->first],
+						&wave->values[op->first])) {
+					player->err = errno;
+					goto out;
+				}
+			}
+
+			wave_account(stats, now - target, step->delay_ns);
+			target += step->delay_ns;
+		}
+	}
+
+	/* the last delay holds the final levels before returning */
+	hb_wait_until(target, stats->spin_ns);
+out:
+	stats->duration_ns = hb_now_ns() - start;
+
+	return NULL;
+}
+
+static int wave_init(hb_wave *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "lines", NULL };
+	struct gpiod_line_settings *settings;
+	PyObject *lines;
+	int ret;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &lines))
+		return -1;
+
+	if (self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Wave already open");
+		return -1;
+	}
+
+	settings = gpiod_line_settings_new();
+	if (!settings) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	gpiod_line_settings_set_direction(settings, GPIOD_LINE_DIRECTION_OUTPUT);
+	gpiod_line_settings_set_output_value(settings,
+					     GPIOD_LINE_VALUE_INACTIVE);
+
+	ret = hb_line_group_open(&self->group, lines, settings, NULL, 0);
+	gpiod_line_settings_free(settings);
+	if (ret)
+		return -1;
+	self->open = true;
+
+	return 0;
+}
+
+static void wave_release(hb_wave *self)
+{
+	if (self->open)
+		hb_line_group_close(&self->group);
+	self->open = false;
+	wave_free_schedule(self);
+}
+
+static void wave_dealloc(hb_wave *self)
+{
+	wave_release(self);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static int wave_check(hb_wave *self)
+{
+	if (!self->open) {
+		PyErr_SetString(PyExc_RuntimeError, "Wave is closed");
+		return -1;
+	}
+	if (self->playing) {
+		PyErr_SetString(PyExc_RuntimeError, "Wave is playing");
+		return -1;
+	}
+
+	return 0;
+}
+
+static PyObject *wave_load(hb_wave *self, PyObject *args)
+{
+	struct hb_line_group *group = &self->group;
+	unsigned long long line_mask, level_mask, delay_ns;
+	unsigned int num_ops = 0, num_values = 0, chip, line, num;
+	PyObject *pulses, *seq, *item;
+	struct hb_wave_step *step;
+	struct hb_wave_op *op;
+	Py_ssize_t num_steps, i;
+	uint64_t valid;
+
+	if (!PyArg_ParseTuple(args, "O", &pulses))
+		return NULL;
+	if (wave_check(self))
+		return NULL;
+
+	seq = PySequence_Fast(pulses, "pulses must be a sequence");
+	if (!seq)
+		return NULL;
+
+	wave_free_schedule(self);
+
+	num_steps = PySequence_Fast_GET_SIZE(seq);
+	if (!num_steps) {
+		Py_DECREF(seq);
+		Py_RETURN_NONE;
+	}
+
+	/* worst case sizes, one op per chip and one value per line */
+	self->steps = calloc(num_steps, sizeof(*self->steps));
+	self->ops = calloc(num_steps * group->num_chips, sizeof(*self->ops));
+	self->offsets = calloc(num_steps * group->num_lines,
+			       sizeof(*self->offsets));
+	self->values = calloc(num_steps * group->num_lines,
+			      sizeof(*self->values));
+	if (!self->steps || !self->ops || !self->offsets || !self->values) {
+		PyErr_NoMemory();
+		goto err;
+	}
+
+	valid = group->num_lines == 64 ? ~0ULL : (1ULL << group->num_lines) - 1;
+
+	for (i = 0; i < num_steps; i++) {
+		item = PySequence_Fast_GET_ITEM(seq, i);
+		if (!PyArg_ParseTuple(item,
+				      "KKK;pulses must be (line mask, level mask, delay_ns)",
+				      &line_mask, &level_mask, &delay_ns))
+			goto err;
+		if (line_mask & ~valid) {
+			PyErr_Format(PyExc_ValueError,
+				     "pulse %zd drives lines outside the group",
+				     i);
+			goto err;
+		}
+
+		step = &self->steps[i];
+		step->delay_ns = delay_ns;
+		step->first_op = num_ops;
+
+		for (chip = 0; chip < group->num_chips; chip++) {
+			op = &self->ops[num_ops];
+			op->chip = chip;
+			op->first = num_values;
+
+			for (num = 0, line = 0; line < group->num_lines; line++) {
+				if (group->line_chip[line] != chip ||
+				    !(line_mask & (1ULL << line)))
+					continue;
+				self->offsets[num_values] =
+					group->line_offset[line];
+				self->values[num_values++] =
+					(level_mask >> line) & 1 ?
+					GPIOD_LINE_VALUE_ACTIVE :
+					GPIOD_LINE_VALUE_INACTIVE;
+				num++;
+			}
+
+			if (num) {
+				op->num = num;
+				num_ops++;
+			}
+		}
+		step->num_ops = num_ops - step->first_op;
+	}
+
+	self->num_steps = num_steps;
+	Py_DECREF(seq);
+
+	Py_RETURN_NONE;
+
+err:
+	wave_free_schedule(self);
+	Py_DECREF(seq);
+	return NULL;
+}
+
+static PyObject *wave_play(hb_wave *self, PyObject *args, PyObject *kwds)
+{
+	static char *kwlist[] = { "repeat", "cpu", "priority", NULL };
+	struct hb_wave_player player;
+	struct hb_wave_stats *stats = &player.stats;
+	sigset_t all, old;
+	pthread_t thread;
+	double stddev;
+	int ret;
+
+	memset(&player, 0, sizeof(player));
+	player.wave = self;
+	player.repeat = 1;
+	player.cpu = -1;
+	player.priority = HB_WAVE_PRIORITY;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|kii", kwlist,
+					 &player.repeat, &player.cpu,
+					 &player.priority))
+		return NULL;
+	if (wave_check(self))
+		return NULL;
+	if (!self->num_steps) {
+		PyErr_SetString(PyExc_RuntimeError, "No pulses loaded");
+		return NULL;
+	}
+
+	self->playing = true;
+	Py_BEGIN_ALLOW_THREADS
+	/* keep signals on the interpreter's main thread */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	ret = pthread_create(&thread, NULL, wave_thread, &player);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	if (!ret)
+		pthread_join(thread, NULL);
+	Py_END_ALLOW_THREADS
+	self->playing = false;
+
+	if (ret) {
+		errno = ret;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+	if (player.err) {
+		errno = player.err;
+		return PyErr_SetFromErrno(PyExc_OSError);
+	}
+
+	stddev = stats->steps > 1 ? sqrt(stats->m2 / (stats->steps - 1)) : 0.0;
+
+	return Py_BuildValue("{s:K,s:K,s:K,s:d,s:d,s:K,s:K,s:K,s:O,s:O}",
+			     "steps", (unsigned long long)stats->steps,
+			     "min_ns", (unsigned long long)stats->min_ns,
+			     "max_ns", (unsigned long long)stats->max_ns,
+			     "mean_ns", stats->mean_ns,
+			     "stddev_ns", stddev,
+			     "overruns", (unsigned long long)stats->overruns,
+			     "duration_ns",
+			     (unsigned long long)stats->duration_ns,
+			     "spin_ns", (unsigned long long)stats->spin_ns,
+			     "realtime", stats->realtime ? Py_True : Py_False,
+			     "pinned", stats->pinned ? Py_True : Py_False);
+}
+
+static PyObject *wave_set(hb_wave *self, PyObject *args)
+{
+	unsigned long long line_mask, level_mask;
+
+	if (!PyArg_ParseTuple(args, "KK", &line_mask, &level_mask))
+		return NULL;
+	if (wave_check(self))
+		return NULL;
+
+	if (hb_line_group_set(&self->group, line_mask, level_mask))
+		return PyErr_SetFromErrno(PyExc_OSError);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *wave_close(hb_wave *self, PyObject *Py_UNUSED(args))
+{
+	if (self->playing) {
+		PyErr_SetString(PyExc_RuntimeError, "Wave is playing");
+		return NULL;
+	}
+
+	wave_release(self);
+	Py_RETURN_NONE;
+}
+
+static PyMethodDef wave_methods[] = {
+	{ "load", (PyCFunction)wave_load, METH_VARARGS,
+	  "Compile a list of (line mask, level mask, delay_ns) pulses" },
+	{ "play", (PyCFunction)(void (*)(void))wave_play,
+	  METH_VARARGS | METH_KEYWORDS,
+	  "Play the loaded pulses and return the timing statistics" },
+	{ "set", (PyCFunction)wave_set, METH_VARARGS,
+	  "Drive the lines in a mask to the given levels immediately" },
+	{ "close", (PyCFunction)wave_close, METH_NOARGS,
+	  "Release the lines" },
+	{ NULL }
+};
+
+static PyTypeObject hb_wave_type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "Hobot.GPIO._native.Wave",
+	.tp_doc = "Timed pulse trains on a group of GPIO output lines",
+	.tp_basicsize = sizeof(hb_wave),
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_new = PyType_GenericNew,
+	.tp_init = (initproc)wave_init,
+	.tp_dealloc = (destructor)wave_dealloc,
+	.tp_methods = wave_methods,
+};
+
+int hb_wave_init(PyObject *module)
+{
+	if (PyType_Ready(&hb_wave_type) < 0)
+		return -1;
+
+	Py_INCREF(&hb_wave_type);
+	if (PyModule_AddObject(module, "Wave", (PyObject *)&hb_wave_type) < 0) {
+		Py_DECREF(&hb_wave_type);
+		return -1;
+	}
+
+	return 0;
+}
@@ -15,15 +15,41 @@
 ################################################################################
 
 from Hobot.GPIO import gpio_event as event
+from Hobot.GPIO import gpio_capture as capture
+from Hobot.GPIO import gpio_sysfs as sysfs
+from Hobot.GPIO import gpio_wave as wave
+from Hobot.GPIO import gpio_sampler as sampler
+from Hobot.GPIO import gpio_trace as trace
+from Hobot.GPIO import gpio_handle as handle
+from Hobot.GPIO import gpio_softpwm as softpwm
+from Hobot.GPIO import gpio_bitbang as bitbang
+from Hobot.GPIO import gpio_broker as broker
+from Hobot.GPIO import gpio_stats as stats
 from Hobot.GPIO import gpio_pin_data
+try:
+    from Hobot.GPIO import gpio_asyncio as aio
+except SyntaxError:
+    # Python 2 has no asyncio
+    aio = None
 import os
-import time
 import copy
+import fcntl
+import struct
 import warnings
 
 # sysfs gpio
-SYSFS_GPIO = "/sys/class/gpio"
-SYSFS_PLATFORM_PATH = '/sys/devices/platform/'
+SYSFS_GPIO = gpio_pin_data.SYSFS_GPIO
+SYSFS_PLATFORM_PATH = gpio_pin_data.SYSFS_PLATFORM_PATH
+
+# pwm character device (Linux 6.13+), struct pwmchip_waveform
+PWM_CDEV_PATH = sysfs.root_path('/dev')
+PWM_IOCTL_REQUEST = 0x7501
+PWM_IOCTL_FREE = 0x7502
+PWM_IOCTL_SETROUNDWF = 0x40207505
+PWM_WAVEFORM_FORMAT = 'IIQQQ'
+
+# software pwm, for pins without a pwm controller
+SOFT_PWM_MAX_FREQUENCY = 10000
 
 # MODE_LIST
 BOARD = 'BOARD'
@@ -49,6 +75,13 @@ UNKNOWN = None
 OUT = "OUT"
 IN = "IN"
 HARD_PWM = "HARD_PWM"
+SOFT_PWM = "SOFT_PWM"
+CAPTURE = "CAPTURE"
+WAVE = "WAVE"
+SAMPLER = "SAMPLER"
+TRACE = "TRACE"
+HANDLE = "HANDLE"
+BITBANG = "BITBANG"
 DIRECTION_LIST = [OUT, IN]
 
 gpio_warning = True
@@ -66,6 +99,17 @@ class PinPro(object):
         self.gpio_value = None
         self.gpio_direction = None
         self.gpio_edge = None
+        self.gpio_chip = None
+        self.gpio_offset = None
+        self.capture = None
+        self.wave = None
+        self.sampler = None
+        self.trace = None
+        self.handle = None
+        self.soft_pwm = None
+        self.bitbang = None
+        self.broker_slot = None
+        self.edges = None
 
         self.pwm_id = None
         self.pwm_export = None
@@ -74,6 +118,13 @@ class PinPro(object):
         self.pwm_enable = None
         self.pwm_period = None
         self.pwm_duty_cycle = None
+        self.pwm_fd_period = None
+        self.pwm_fd_duty_cycle = None
+        self.pwm_fd_enable = None
+        self.pwm_cur_period = None
+        self.pwm_cur_duty_cycle = None
+        self.pwm_cur_enable = None
+        self.pwm_fd_cdev = None
 
         self.pin_status = None
         try:
@@ -118,8 +169,36 @@ def getmode():
     return pin_mode
 
 
+def _resolve_gpio_line(pin_name):
+    if pin_info[pin_name].gpio_chip is None:
+        line = gpio_pin_data.get_gpio_line(
+            all_pin_data[pin_mode][pin_name].gpio_chip_dir,
+            pin_info[pin_name].gpio_id)
+        pin_info[pin_name].gpio_chip, pin_info[pin_name].gpio_offset = line
+
+
+def _event_backend(pin_name):
+    if pin_info.__contains__(pin_name) and \
+            pin_info[pin_name].broker_slot is not None:
+        return broker
+    return event
+
+
 # GPIO function
-def _export_gpio(pin_name, direction):
+def _export_gpio(pin_name, direction, initial=None):
+    if broker.available():
+        _resolve_gpio_line(pin_name)
+        broker._broker_request(pin_info, pin_name, direction, initial)
+        pin_info[pin_name].pin_status = direction
+        return
+
+    if not os.access(pin_info[pin_name].gpio_export, os.W_OK):
+        raise RuntimeError("Insufficient permissions, need root permissions:" +
+                           pin_info[pin_name].gpio_export)
+    if not os.access(pin_info[pin_name].gpio_unexport, os.W_OK):
+        raise RuntimeError("Insufficient permissions, need root permissions:" +
+                           pin_info[pin_name].gpio_unexport)
+
     if not os.path.exists(pin_info[pin_name].gpio_name):
         f_export = open(pin_info[pin_name].gpio_export, "w")
         f_export.write(pin_info[pin_name].gpio_id)
@@ -130,8 +209,11 @@ def _export_gpio(pin_name, direction):
                           "has been exported before this operation ",
                           RuntimeWarning)
 
-    while not os.access(pin_info[pin_name].gpio_value, os.R_OK | os.W_OK):
-        time.sleep(0.01)
+    if not sysfs.wait_for_access(pin_info[pin_name].gpio_value,
+                                 os.R_OK | os.W_OK):
+        raise RuntimeError("Timed out waiting for " +
+                           pin_info[pin_name].gpio_value +
+                           " to become accessible, check the gpio udev rules")
 
     f_direction = open(pin_info[pin_name].gpio_direction, 'w')
     f_direction.write(direction.lower())
@@ -141,6 +223,16 @@ def _export_gpio(pin_name, direction):
 
 
 def _unexport_gpio(pin_name):
+    if pin_info[pin_name].edges is not None:
+        aio._edges_close(pin_info, pin_name)
+        pin_info[pin_name].pin_status = None
+        return
+
+    if pin_info[pin_name].broker_slot is not None:
+        broker._broker_release(pin_info, pin_name)
+        pin_info[pin_name].pin_status = None
+        return
+
     if os.path.exists(pin_info[pin_name].gpio_name):
         f_unexport = open(pin_info[pin_name].gpio_unexport, "w")
         f_unexport.write(pin_info[pin_name].gpio_id)
@@ -151,8 +243,10 @@ def _unexport_gpio(pin_name):
                           "did not exit before this operation ",
                           RuntimeWarning)
 
-    while os.access(pin_info[pin_name].gpio_value, os.R_OK | os.W_OK):
-        time.sleep(0.01)
+    if not sysfs.wait_for_no_access(pin_info[pin_name].gpio_value,
+                                    os.R_OK | os.W_OK):
+        raise RuntimeError("Timed out waiting for channel " + str(pin_name) +
+                           " to be unexported")
 
     pin_info[pin_name].pin_status = None
 
@@ -177,6 +271,10 @@ def output(channels, values):
         if pin_values[i] not in LEVEL_LIST:
             raise ValueError("The value setting of this channel is invalid")
 
+    if broker.available():
+        broker._broker_output(pin_info, pin_names, pin_values)
+        return
+
     for i, pin_name in enumerate(pin_names):
         f_value = open(pin_info[pin_name].gpio_value, 'w')
         f_value.write(str(pin_values[i]))
@@ -190,6 +288,11 @@ def input(channel):
     if pin_info[pin_name].pin_status != IN:
         raise RuntimeError("This channel direction is not an input")
 
+    if pin_info[pin_name].broker_slot is not None:
+        return broker._broker_input(pin_info, pin_name)
+    if pin_info[pin_name].edges is not None:
+        return aio._edges_value(pin_info, pin_name)
+
     f_value = open(pin_info[pin_name].gpio_value, 'r')
     value = f_value.read().rstrip()
     f_value.close()
@@ -220,15 +323,29 @@ def setup(channels, direction, pull_up_down=None, initial=None):
         except Exception as exc:
             raise ValueError("This channel was not found in this mode")
 
-        _export_gpio(pin_name, direction)
-        if direction == OUT and initial:
+        _export_gpio(pin_name, direction, initial)
+        if direction == OUT and initial and \
+                pin_info[pin_name].broker_slot is None:
             output(pin_name, initial)
 
 
 def _cleanup_one(pin_name):
     global pin_info
-    event._event_cleanup(pin_info, pin_name)
-    _unexport_gpio(pin_name)
+    if pin_info[pin_name].pin_status == CAPTURE:
+        capture._capture_close(pin_info, pin_name)
+    elif pin_info[pin_name].pin_status == WAVE:
+        wave._wave_close(pin_info, pin_name)
+    elif pin_info[pin_name].pin_status == SAMPLER:
+        sampler._sampler_close(pin_info, pin_name)
+    elif pin_info[pin_name].pin_status == TRACE:
+        trace._trace_close(pin_info, pin_name)
+    elif pin_info[pin_name].pin_status == HANDLE:
+        pin_info[pin_name].handle._release()
+    elif pin_info[pin_name].pin_status == BITBANG:
+        bitbang._bitbang_close(pin_info, pin_name)
+    else:
+        _event_backend(pin_name)._event_cleanup(pin_info, pin_name)
+        _unexport_gpio(pin_name)
     del pin_info[pin_name]
 
 def cleanup(channels=None):
@@ -237,6 +354,13 @@ def cleanup(channels=None):
     global pin_info
     gpio_clean_list = []
     pwm_clean_list = []
+    capture_clean_list = []
+    wave_clean_list = []
+    sampler_clean_list = []
+    trace_clean_list = []
+    handle_clean_list = []
+    soft_pwm_clean_list = []
+    bitbang_clean_list = []
 
     if not channels:
         if gpio_warning:
@@ -247,6 +371,20 @@ def cleanup(channels=None):
                            if pin_info[x].pin_status in DIRECTION_LIST]
         pwm_clean_list = [x for x, y in pin_info.items()
                           if pin_info[x].pin_status is HARD_PWM]
+        soft_pwm_clean_list = [x for x, y in pin_info.items()
+                               if pin_info[x].pin_status is SOFT_PWM]
+        capture_clean_list = [x for x, y in pin_info.items()
+                              if pin_info[x].pin_status is CAPTURE]
+        wave_clean_list = [x for x, y in pin_info.items()
+                           if pin_info[x].pin_status is WAVE]
+        sampler_clean_list = [x for x, y in pin_info.items()
+                              if pin_info[x].pin_status is SAMPLER]
+        trace_clean_list = [x for x, y in pin_info.items()
+                            if pin_info[x].pin_status is TRACE]
+        handle_clean_list = [x for x, y in pin_info.items()
+                             if pin_info[x].pin_status is HANDLE]
+        bitbang_clean_list = [x for x, y in pin_info.items()
+                              if pin_info[x].pin_status is BITBANG]
     else:
         if type(channels) == list or type(channels) == tuple:
             pin_names = copy.deepcopy(channels)
@@ -264,10 +402,24 @@ def cleanup(channels=None):
                 gpio_clean_list.append(pin_name)
             elif pin_info[pin_name].pin_status is HARD_PWM:
                 pwm_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is SOFT_PWM:
+                soft_pwm_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is CAPTURE:
+                capture_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is WAVE:
+                wave_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is SAMPLER:
+                sampler_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is TRACE:
+                trace_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is HANDLE:
+                handle_clean_list.append(pin_name)
+            elif pin_info[pin_name].pin_status is BITBANG:
+                bitbang_clean_list.append(pin_name)
 
     for x in gpio_clean_list:
         try:
-            event._event_cleanup(pin_info, pin_name)
+            _event_backend(x)._event_cleanup(pin_info, x)
         except Exception as exc:
             pass
         _unexport_gpio(x)
@@ -275,6 +427,27 @@ def cleanup(channels=None):
     for x in pwm_clean_list:
         _unexport_pwm(x)
         del pin_info[x]
+    for x in soft_pwm_clean_list:
+        softpwm._softpwm_close(pin_info, x)
+        del pin_info[x]
+    for x in capture_clean_list:
+        capture._capture_close(pin_info, x)
+        del pin_info[x]
+    for x in wave_clean_list:
+        wave._wave_close(pin_info, x)
+        del pin_info[x]
+    for x in sampler_clean_list:
+        sampler._sampler_close(pin_info, x)
+        del pin_info[x]
+    for x in trace_clean_list:
+        trace._trace_close(pin_info, x)
+        del pin_info[x]
+    for x in handle_clean_list:
+        pin_info[x].handle._release()
+        del pin_info[x]
+    for x in bitbang_clean_list:
+        bitbang._bitbang_close(pin_info, x)
+        del pin_info[x]
 
     pin_mode = None
 
@@ -295,7 +468,7 @@ def event_detected(channel):
     if pin_info[pin_name].pin_status != IN:
         raise RuntimeError("Channel direction must be set to input")
 
-    return event._is_event_occurred(pin_name)
+    return _event_backend(pin_name)._is_event_occurred(pin_name)
 
 
 def add_event_callback(channel, callback):
@@ -306,10 +479,11 @@ def add_event_callback(channel, callback):
     if pin_info[pin_name].pin_status != IN:
         raise RuntimeError("Channel direction must be set to input")
 
-    if not event._is_event_added(pin_name):
+    if not _event_backend(pin_name)._is_event_added(pin_name):
         raise RuntimeError("No add_event_detect before this operation")
 
-    event._add_callback(pin_name, lambda: callback(pin_name))
+    _event_backend(pin_name)._add_callback(pin_name,
+                                           lambda: callback(pin_name))
 
 
 def add_event_detect(channel, edge, callback=None, bouncetime=None):
@@ -328,11 +502,16 @@ def add_event_detect(channel, edge, callback=None, bouncetime=None):
         if bouncetime < 0:
             raise ValueError("bouncetime must be greater than 0")
 
-    result = event._add_event_detect(pin_info, pin_name, edge, bouncetime)
+    if pin_info[pin_name].edges is not None:
+        raise RuntimeError("Conflicting edge detection event already exists")
+
+    result = _event_backend(pin_name)._add_event_detect(pin_info, pin_name,
+                                                        edge, bouncetime)
 
     if result == 0:
         if callback is not None:
-            event._add_callback(pin_name, lambda: callback(pin_name))
+            _event_backend(pin_name)._add_callback(
+                pin_name, lambda: callback(pin_name))
 
     elif result == -1:
         raise RuntimeError("Conflicting edge detection event already exists")
@@ -350,7 +529,7 @@ def add_event_detect(channel, edge, callback=None, bouncetime=None):
 
 def remove_event_detect(channel):
     pin_name = channel
-    event._del_event(pin_info, pin_name)
+    _event_backend(pin_name)._del_event(pin_info, pin_name)
 
 
 def wait_for_edge(channel, edge, bouncetime=None, timeout=None):
@@ -375,8 +554,12 @@ def wait_for_edge(channel, edge, bouncetime=None, timeout=None):
         if timeout < 0:
             raise ValueError("Timeout must be greater than 0")
 
-    result = event._add_event_block(pin_info, pin_name,
-                                    edge, bouncetime, timeout)
+    if pin_info[pin_name].edges is not None:
+        raise RuntimeError("Conflicting edge detection event already exists")
+
+    result = _event_backend(pin_name)._add_event_block(pin_info, pin_name,
+                                                       edge, bouncetime,
+                                                       timeout)
 
     if not result:
         return None
@@ -400,72 +583,648 @@ def wait_for_edge(channel, edge, bouncetime=None, timeout=None):
         return pin_name
 
 
+# ASYNCIO function, see gpio_asyncio.py
+def _edges_open(pin_name, edge, bouncetime):
+    if aio is None:
+        raise RuntimeError("wait_edge and events need Python 3")
+    if not pin_mode:
+        raise RuntimeError("No channel mode set")
+    if not pin_info.__contains__(pin_name):
+        raise RuntimeError("This channel is not setup")
+    if pin_info[pin_name].pin_status != IN:
+        raise RuntimeError("This channel must be setup as an input")
+    if edge not in EDGE_LIST:
+        raise ValueError("The edge must be set to RISING, FALLING or BOTH")
+    if bouncetime is not None:
+        if bouncetime < 0:
+            raise ValueError("bouncetime must be greater than 0")
+    debounce_us = int(bouncetime * 1000) if bouncetime else 0
+
+    if pin_info[pin_name].edges is not None:
+        # a call without bouncetime keeps whatever the line already has
+        if bouncetime is not None:
+            aio._edges_debounce(pin_info, pin_name, debounce_us)
+        return
+    if pin_info[pin_name].broker_slot is not None:
+        raise RuntimeError("The gpio broker holds this channel, set "
+                           "HOBOT_GPIO_BROKER=0 to use wait_edge and events")
+    if event._is_event_added(pin_name):
+        raise RuntimeError("Conflicting edge detection event already exists")
+
+    # the line moves from sysfs to a line request whose fd the loop watches
+    _resolve_gpio_line(pin_name)
+    _unexport_gpio(pin_name)
+    try:
+        aio._edges_open(pin_info, pin_name, debounce_us)
+    except Exception:
+        _export_gpio(pin_name, IN)
+        raise
+    pin_info[pin_name].pin_status = IN
+
+
+# await wait_edge(channel) returns an EdgeEvent, or None after timeout ms
+def wait_edge(channel, edge=BOTH, bouncetime=None, timeout=None):
+    if timeout:
+        if timeout < 0:
+            raise ValueError("Timeout must be greater than 0")
+    _edges_open(channel, edge, bouncetime)
+    return aio._wait_edge(pin_info[channel].edges, edge, timeout)
+
+
+# async for ev in events(channel): one EdgeEvent per edge, until cleanup
+def events(channel, edge=BOTH, bouncetime=None):
+    _edges_open(channel, edge, bouncetime)
+    return aio._events(pin_info[channel].edges, edge)
+
+
+# Edge latency statistics, see gpio_stats.py
+def set_edge_stats(state):
+    stats.set_enabled(state)
+
+
+def get_edge_stats(channel=None):
+    if channel is None:
+        return stats.snapshot()
+    return stats.snapshot(channel)
+
+
+def reset_edge_stats(channel=None):
+    stats.reset(channel)
+
+
+# CAPTURE function
+def setup_capture(channels, window=1000, bouncetime=None):
+    if not pin_mode:
+        raise RuntimeError("No channel mode set")
+    if window <= 0:
+        raise ValueError("window must be greater than 0")
+    if bouncetime is not None:
+        if bouncetime < 0:
+            raise ValueError("bouncetime must be greater than 0")
+
+    if type(channels) == list or type(channels) == tuple:
+        pin_names = copy.deepcopy(channels)
+    elif type(channels) == str or type(channels) == int:
+        pin_names = []
+        pin_names.append(channels)
+    else:
+        raise TypeError("The channel parameter is of the wrong type")
+
+    for pin_name in pin_names:
+        if pin_info.__contains__(pin_name):
+            _cleanup_one(pin_name)
+        try:
+            pin_info[pin_name] = PinPro(pin_name)
+            _resolve_gpio_line(pin_name)
+        except Exception as exc:
+            pin_info.pop(pin_name, None)
+            raise ValueError("This channel was not found in this mode")
+
+        try:
+            capture._capture_open(pin_info, pin_name, window, bouncetime)
+        except Exception:
+            del pin_info[pin_name]
+            raise
+        pin_info[pin_name].pin_status = CAPTURE
+
+
+def measure(channel):
+    pin_name = channel
+    if not pin_info.__contains__(pin_name):
+        raise RuntimeError("This channel is not setup")
+    if pin_info[pin_name].pin_status != CAPTURE:
+        raise RuntimeError("This channel is not setup for capture")
+
+    return capture._capture_measure(pin_info, pin_name)
+
+
+# WAVE function
+class Wave(object):
+    # Bit n of the line and level masks passed to load() selects channels[n]
+    def __init__(self, channels):
+        if not pin_mode:
+            raise RuntimeError("No channel mode set")
+
+        if type(channels) == list or type(channels) == tuple:
+            pin_names = list(channels)
+        elif type(channels) == str or type(channels) == int:
+            pin_names = [channels]
+        else:
+            raise TypeError("The channel parameter is of the wrong type")
+
+        for pin_name in pin_names:
+            if pin_info.__contains__(pin_name):
+                raise RuntimeError("This channel is in use")
+        for pin_name in pin_names:
+            try:
+                pin_info[pin_name] = PinPro(pin_name)
+                _resolve_gpio_line(pin_name)
+            except Exception as exc:
+                for x in pin_names:
+                    pin_info.pop(x, None)
+                raise ValueError("This channel was not found in this mode")
+
+        try:
+            self.wave = wave._wave_open(pin_info, pin_names)
+        except Exception:
+            for x in pin_names:
+                del pin_info[x]
+            raise
+
+        self.pin_names = pin_names
+        for pin_name in pin_names:
+            pin_info[pin_name].wave = self.wave
+            pin_info[pin_name].pin_status = WAVE
+
+    def load(self, pulses):
+        self.wave.load(pulses)
+
+    def play(self, repeat=1, cpu=None):
+        return wave._wave_play(self.wave, repeat, cpu)
+
+    def set(self, line_mask, level_mask):
+        self.wave.set(line_mask, level_mask)
+
+    def close(self):
+        for pin_name in self.pin_names:
+            if pin_info.__contains__(pin_name) and \
+                    pin_info[pin_name].wave is self.wave:
+                wave._wave_close(pin_info, pin_name)
+                del pin_info[pin_name]
+        self.wave.close()
+
+
+# SAMPLER function
+class Sampler(object):
+    # Bit n of every sample is channels[n]. Samples are sample_size bytes,
+    # little endian, so the buffer can be a numpy uint8/16/32/64 array of
+    # that size. rate_hz=0 samples as fast as the lines can be read.
+    def __init__(self, channels):
+        if not pin_mode:
+            raise RuntimeError("No channel mode set")
+
+        if type(channels) == list or type(channels) == tuple:
+            pin_names = list(channels)
+        elif type(channels) == str or type(channels) == int:
+            pin_names = [channels]
+        else:
+            raise TypeError("The channel parameter is of the wrong type")
+
+        for pin_name in pin_names:
+            if pin_info.__contains__(pin_name):
+                raise RuntimeError("This channel is in use")
+        for pin_name in pin_names:
+            try:
+                pin_info[pin_name] = PinPro(pin_name)
+                _resolve_gpio_line(pin_name)
+            except Exception as exc:
+                for x in pin_names:
+                    pin_info.pop(x, None)
+                raise ValueError("This channel was not found in this mode")
+
+        try:
+            self.sampler = sampler._sampler_open(pin_info, pin_names)
+        except Exception:
+            for x in pin_names:
+                del pin_info[x]
+            raise
+
+        self.pin_names = pin_names
+        self.sample_size = self.sampler.sample_size
+        for pin_name in pin_names:
+            pin_info[pin_name].sampler = self.sampler
+            pin_info[pin_name].pin_status = SAMPLER
+
+    def read(self, buffer, rate_hz=0, count=None, timestamps=None, cpu=None):
+        return sampler._sampler_read(self.sampler, buffer, rate_hz, count,
+                                     timestamps, cpu)
+
+    def get(self):
+        return self.sampler.get()
+
+    def close(self):
+        for pin_name in self.pin_names:
+            if pin_info.__contains__(pin_name) and \
+                    pin_info[pin_name].sampler is self.sampler:
+                sampler._sampler_close(pin_info, pin_name)
+                del pin_info[pin_name]
+        self.sampler.close()
+
+
+# TRACE function
+class TraceRecorder(object):
+    # Records every edge of the channels to path until close(), line n of
+    # the trace is channels[n]. Read it back with open_trace().
+    def __init__(self, channels, path, bouncetime=None):
+        if not pin_mode:
+            raise RuntimeError("No channel mode set")
+
+        if type(channels) == list or type(channels) == tuple:
+            pin_names = list(channels)
+        elif type(channels) == str or type(channels) == int:
+            pin_names = [channels]
+        else:
+            raise TypeError("The channel parameter is of the wrong type")
+        if bouncetime is not None:
+            if bouncetime < 0:
+                raise ValueError("bouncetime must be greater than 0")
+        debounce_us = int(bouncetime * 1000) if bouncetime else 0
+
+        for pin_name in pin_names:
+            if pin_info.__contains__(pin_name):
+                raise RuntimeError("This channel is in use")
+        for pin_name in pin_names:
+            try:
+                pin_info[pin_name] = PinPro(pin_name)
+                _resolve_gpio_line(pin_name)
+            except Exception as exc:
+                for x in pin_names:
+                    pin_info.pop(x, None)
+                raise ValueError("This channel was not found in this mode")
+
+        try:
+            self.trace = trace._trace_open(pin_info, pin_names, path,
+                                           debounce_us)
+        except Exception:
+            for x in pin_names:
+                del pin_info[x]
+            raise
+
+        self.pin_names = pin_names
+        self.path = path
+        for pin_name in pin_names:
+            pin_info[pin_name].trace = self.trace
+            pin_info[pin_name].pin_status = TRACE
+
+    # {'events', 'missed', 'bytes', 'recording'}
+    def stats(self):
+        return self.trace.stats()
+
+    def close(self):
+        for pin_name in self.pin_names:
+            if pin_info.__contains__(pin_name) and \
+                    pin_info[pin_name].trace is self.trace:
+                trace._trace_close(pin_info, pin_name)
+                del pin_info[pin_name]
+        self.trace.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+# Iterating the reader yields (timestamp_ns, line, level) for each edge
+def open_trace(path):
+    return trace.TraceReader(path)
+
+
+# HANDLE function
+class _LineHandle(object):
+    # The channel is checked and its line requested once, read() and
+    # write() are then the line's own methods, without any lookup
+    def __init__(self, channel, direction, initial=None):
+        if not pin_mode:
+            raise RuntimeError("No channel mode set")
+        if type(channel) != str and type(channel) != int:
+            raise TypeError("The channel parameter is of the wrong type")
+        if initial is not None and initial not in LEVEL_LIST:
+            raise ValueError("The value setting of this channel is invalid")
+        if pin_info.__contains__(channel):
+            raise RuntimeError("This channel is in use")
+
+        try:
+            pin_info[channel] = PinPro(channel)
+        except Exception as exc:
+            raise ValueError("This channel was not found in this mode")
+
+        # without the native line request the line is exported as setup()
+        # does and the handle keeps its broker slot or sysfs value fd
+        self.exported = not handle._native_handles()
+        try:
+            if self.exported:
+                _export_gpio(channel, direction, initial)
+            else:
+                _resolve_gpio_line(channel)
+            self.line = handle._handle_open(pin_info, channel,
+                                            direction == OUT, initial)
+            if self.exported and direction == OUT and initial and \
+                    pin_info[channel].broker_slot is None:
+                self.line.write(initial)
+        except Exception:
+            if pin_info[channel].pin_status is not None:
+                _unexport_gpio(channel)
+            del pin_info[channel]
+            raise
+
+        self.channel = channel
+        self.read = self.line.read
+        pin_info[channel].handle = self
+        pin_info[channel].pin_status = HANDLE
+
+    def _release(self):
+        self.line.close()
+        if self.exported:
+            _unexport_gpio(self.channel)
+
+    def close(self):
+        if pin_info.__contains__(self.channel) and \
+                pin_info[self.channel].handle is self:
+            self._release()
+            del pin_info[self.channel]
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+
+class OutputHandle(_LineHandle):
+    def __init__(self, channel, initial=None):
+        _LineHandle.__init__(self, channel, OUT, initial)
+        self.write = self.line.write
+
+
+class InputHandle(_LineHandle):
+    def __init__(self, channel):
+        _LineHandle.__init__(self, channel, IN)
+
+
+# h = open_output(channel): h.write(value) and h.read() until h.close()
+def open_output(channel, initial=None):
+    return OutputHandle(channel, initial)
+
+
+# h = open_input(channel): h.read() until h.close()
+def open_input(channel):
+    return InputHandle(channel)
+
+
+# Bit-banged bus function
+class _BitBangBus(object):
+    def _claim(self, pin_names):
+        if not pin_mode:
+            raise RuntimeError("No channel mode set")
+        pin_names = [x for x in pin_names if x is not None]
+        for pin_name in pin_names:
+            if pin_info.__contains__(pin_name):
+                raise RuntimeError("This channel is in use")
+        for pin_name in pin_names:
+            try:
+                pin_info[pin_name] = PinPro(pin_name)
+                _resolve_gpio_line(pin_name)
+            except Exception as exc:
+                for x in pin_names:
+                    pin_info.pop(x, None)
+                raise ValueError("This channel was not found in this mode")
+        self.pin_names = pin_names
+
+    def _attach(self, open_bus, *args):
+        try:
+            self.bus = open_bus(pin_info, *args)
+        except Exception:
+            for x in self.pin_names:
+                del pin_info[x]
+            raise
+        for pin_name in self.pin_names:
+            pin_info[pin_name].bitbang = self.bus
+            pin_info[pin_name].pin_status = BITBANG
+
+    def close(self):
+        for pin_name in self.pin_names:
+            if pin_info.__contains__(pin_name) and \
+                    pin_info[pin_name].bitbang is self.bus:
+                bitbang._bitbang_close(pin_info, pin_name)
+                del pin_info[pin_name]
+        self.bus.close()
+
+
+class SoftSPI(_BitBangBus):
+    def __init__(self, sclk, mosi=None, miso=None, cs=None, mode=0,
+                 speed_hz=500000, lsb_first=False):
+        if mode not in (0, 1, 2, 3):
+            raise ValueError("Wrong SPI mode, must be 0, 1, 2 or 3")
+        self._claim([sclk, mosi, miso, cs])
+        self._attach(bitbang._spi_open, sclk, mosi, miso, cs, mode,
+                     speed_hz, lsb_first)
+
+    def transfer(self, data):
+        return self.bus.transfer(data)
+
+
+class SoftI2C(_BitBangBus):
+    def __init__(self, scl, sda, speed_hz=100000):
+        self._claim([scl, sda])
+        self._attach(bitbang._i2c_open, scl, sda, speed_hz)
+
+    def transfer(self, addr, write=b'', read=0):
+        return self.bus.transfer(addr, write, read)
+
+
+class OneWire(_BitBangBus):
+    def __init__(self, channel):
+        self._claim([channel])
+        self._attach(bitbang._onewire_open, channel)
+
+    def reset(self):
+        return self.bus.reset()
+
+    def transfer(self, write=b'', read=0, reset=True):
+        return self.bus.transfer(write, read, reset)
+
+
 # PWM function
+try:
+    _pwrite = os.pwrite
+    _pread = os.pread
+except AttributeError:
+    def _pwrite(fd, data, offset):
+        os.lseek(fd, offset, os.SEEK_SET)
+        return os.write(fd, data)
+
+    def _pread(fd, length, offset):
+        os.lseek(fd, offset, os.SEEK_SET)
+        return os.read(fd, length)
+
+
+def _read_pwm_fd(fd):
+    return int(_pread(fd, 32, 0).decode().rstrip())
+
+
+def _write_pwm_fd(fd, value):
+    _pwrite(fd, str(value).encode(), 0)
+
+
+def _open_pwm_fds(pin_name):
+    # Keep the attribute files open for the PWM lifetime and shadow their
+    # values, so updates cost one pwrite and redundant writes cost nothing
+    pin = pin_info[pin_name]
+    pin.pwm_fd_period = os.open(pin.pwm_period, os.O_RDWR)
+    pin.pwm_fd_duty_cycle = os.open(pin.pwm_duty_cycle, os.O_RDWR)
+    pin.pwm_fd_enable = os.open(pin.pwm_enable, os.O_RDWR)
+    pin.pwm_cur_period = _read_pwm_fd(pin.pwm_fd_period)
+    pin.pwm_cur_duty_cycle = _read_pwm_fd(pin.pwm_fd_duty_cycle)
+    pin.pwm_cur_enable = _read_pwm_fd(pin.pwm_fd_enable)
+
+
+def _close_pwm_fds(pin_name):
+    pin = pin_info[pin_name]
+    for fd in (pin.pwm_fd_period, pin.pwm_fd_duty_cycle, pin.pwm_fd_enable):
+        if fd is not None:
+            os.close(fd)
+    pin.pwm_fd_period = None
+    pin.pwm_fd_duty_cycle = None
+    pin.pwm_fd_enable = None
+
+
+def _open_pwm_cdev(pin_name):
+    # The pwm chardev sets period and duty cycle in one ioctl, use it when
+    # the kernel provides it and fall back to the sysfs attributes otherwise
+    pwm_chip = os.path.basename(os.path.dirname(pin_info[pin_name].pwm_export))
+    cdev_path = os.path.join(PWM_CDEV_PATH, pwm_chip)
+    if not os.path.exists(cdev_path):
+        return False
+    try:
+        fd = os.open(cdev_path, os.O_RDWR)
+    except OSError:
+        return False
+    try:
+        fcntl.ioctl(fd, PWM_IOCTL_REQUEST, int(pin_info[pin_name].pwm_id))
+    except (IOError, OSError):
+        os.close(fd)
+        return False
+
+    pin = pin_info[pin_name]
+    pin.pwm_fd_cdev = fd
+    pin.pwm_cur_period = 0
+    pin.pwm_cur_duty_cycle = 0
+    pin.pwm_cur_enable = 0
+    return True
+
+
+def _close_pwm_cdev(pin_name):
+    pin = pin_info[pin_name]
+    try:
+        fcntl.ioctl(pin.pwm_fd_cdev, PWM_IOCTL_FREE, int(pin.pwm_id))
+    except (IOError, OSError):
+        pass
+    os.close(pin.pwm_fd_cdev)
+    pin.pwm_fd_cdev = None
+
+
+def _set_pwm_waveform(pin_name, period_ns, duty_cycle_ns):
+    waveform = struct.pack(PWM_WAVEFORM_FORMAT, int(pin_info[pin_name].pwm_id),
+                           0, period_ns, duty_cycle_ns, 0)
+    fcntl.ioctl(pin_info[pin_name].pwm_fd_cdev, PWM_IOCTL_SETROUNDWF, waveform)
+
+
 def _export_pwm(pin_name):
+    if _open_pwm_cdev(pin_name):
+        pin_info[pin_name].pin_status = HARD_PWM
+        return
+
     if not os.path.exists(pin_info[pin_name].pwm_name):
         f_export = open(pin_info[pin_name].pwm_export, 'w')
         f_export.write(pin_info[pin_name].pwm_id)
         f_export.close()
 
-    while not os.access(pin_info[pin_name].pwm_enable, os.R_OK | os.W_OK):
-        time.sleep(0.01)
+    if not sysfs.wait_for_access(pin_info[pin_name].pwm_enable,
+                                 os.R_OK | os.W_OK):
+        raise RuntimeError("Timed out waiting for " +
+                           pin_info[pin_name].pwm_enable +
+                           " to become accessible, check the pwm udev rules")
 
+    _open_pwm_fds(pin_name)
     pin_info[pin_name].pin_status = HARD_PWM
 
 
 def _unexport_pwm(pin_name):
     if not pin_info.__contains__(pin_name):
         return
+    if pin_info[pin_name].pwm_fd_cdev is not None:
+        _close_pwm_cdev(pin_name)
+        pin_info[pin_name].pin_status = None
+        return
+
+    _close_pwm_fds(pin_name)
     f_unexport = open(pin_info[pin_name].pwm_unexport, 'w')
     f_unexport.write(pin_info[pin_name].pwm_id)
     f_unexport.close()
 
-    while os.access(pin_info[pin_name].pwm_enable, os.R_OK | os.W_OK):
-        time.sleep(0.01)
+    if not sysfs.wait_for_no_access(pin_info[pin_name].pwm_enable,
+                                    os.R_OK | os.W_OK):
+        raise RuntimeError("Timed out waiting for channel " + str(pin_name) +
+                           " to be unexported")
 
     pin_info[pin_name].pin_status = None
 
 
 def _set_pwm_period(pin_name, period_ns):
-    f_period = open(pin_info[pin_name].pwm_period, 'w')
-    f_period.write(str(period_ns))
-    f_period.close()
+    if pin_info[pin_name].pwm_cur_period == period_ns:
+        return
+    _write_pwm_fd(pin_info[pin_name].pwm_fd_period, period_ns)
+    pin_info[pin_name].pwm_cur_period = period_ns
 
-def _get_pwm_duty_cycle(pin_name):
-    f_duty_cycle = open(pin_info[pin_name].pwm_duty_cycle, 'r')
-    cur_duty_cycle = f_duty_cycle.read().rstrip()
-    f_duty_cycle.close()
 
-    return cur_duty_cycle
+def _get_pwm_duty_cycle(pin_name):
+    return pin_info[pin_name].pwm_cur_duty_cycle
 
 
 def _set_pwm_duty_cycle(pin_name, duty_cycle_ns):
-    if not duty_cycle_ns:
-        f_duty_cycle = open(pin_info[pin_name].pwm_duty_cycle, 'r')
-        cur_duty_cycle = f_duty_cycle.read().rstrip()
-        f_duty_cycle.close()
-        if cur_duty_cycle == '0':
-            return
+    if pin_info[pin_name].pwm_cur_duty_cycle == duty_cycle_ns:
+        return
+    _write_pwm_fd(pin_info[pin_name].pwm_fd_duty_cycle, duty_cycle_ns)
+    pin_info[pin_name].pwm_cur_duty_cycle = duty_cycle_ns
+
+
+def _update_pwm(pin_name, period_ns, duty_cycle_ns):
+    # Change period and duty cycle without disabling the output. The kernel
+    # rejects duty_cycle > period, so a growing period is written before the
+    # duty cycle and a shrinking one after it.
+    pin = pin_info[pin_name]
+    if pin.pwm_fd_cdev is not None:
+        if pin.pwm_cur_enable == 1:
+            _set_pwm_waveform(pin_name, period_ns, duty_cycle_ns)
+        pin.pwm_cur_period = period_ns
+        pin.pwm_cur_duty_cycle = duty_cycle_ns
+        return
 
-    f_duty_cycle = open(pin_info[pin_name].pwm_duty_cycle, 'w')
-    f_duty_cycle.write(str(duty_cycle_ns))
-    f_duty_cycle.close()
+    if period_ns >= pin.pwm_cur_period:
+        _set_pwm_period(pin_name, period_ns)
+        _set_pwm_duty_cycle(pin_name, duty_cycle_ns)
+    else:
+        _set_pwm_duty_cycle(pin_name, duty_cycle_ns)
+        _set_pwm_period(pin_name, period_ns)
 
 
 def _enable_pwm(pin_name):
-    if _get_pwm_duty_cycle(pin_name) == '0':
+    if pin_info[pin_name].pwm_cur_enable == 1:
+        return
+    if pin_info[pin_name].pwm_fd_cdev is not None:
+        _set_pwm_waveform(pin_name, pin_info[pin_name].pwm_cur_period,
+                          pin_info[pin_name].pwm_cur_duty_cycle)
+        pin_info[pin_name].pwm_cur_enable = 1
         return
-    f_enable = open(pin_info[pin_name].pwm_enable, 'w')
-    f_enable.write('1')
-    f_enable.close()
+    # a started channel with a zero duty cycle stays disabled, _configure
+    # enables it once the duty cycle is raised
+    if _get_pwm_duty_cycle(pin_name) == 0:
+        return
+    _write_pwm_fd(pin_info[pin_name].pwm_fd_enable, 1)
+    pin_info[pin_name].pwm_cur_enable = 1
 
 
 def _disable_pwm(pin_name):
-    if _get_pwm_duty_cycle(pin_name) == '0':
+    if pin_info[pin_name].pwm_cur_enable == 0:
+        return
+    if pin_info[pin_name].pwm_fd_cdev is not None:
+        # a zero period_length_ns disables the output
+        _set_pwm_waveform(pin_name, 0, 0)
+        pin_info[pin_name].pwm_cur_enable = 0
         return
-    f_enable = open(pin_info[pin_name].pwm_enable, 'w')
-    f_enable.write('0')
-    f_enable.close()
+    _write_pwm_fd(pin_info[pin_name].pwm_fd_enable, 0)
+    pin_info[pin_name].pwm_cur_enable = 0
 
 
 class PWM(object):
@@ -479,22 +1238,36 @@ class PWM(object):
         except Exception as exc:
             raise ValueError("This channel name was not found in this mode")
 
-        if pin_info[pin_name].pwm_name is None:
-            raise RuntimeError("The channel is not support PWM mode")
         if frequency_hz <= 0:
             raise ValueError("Wrong frequency value")
 
         self.pin_name = pin_name
         self.cur_frequency_hz = -1
         self.cur_duty_cycle = 0.0
-
-        _export_pwm(self.pin_name)
+        # Pins without a PWM controller are driven by the native software
+        # PWM scheduler instead
+        self.soft = pin_info[pin_name].pwm_name is None
+
+        if self.soft:
+            try:
+                _resolve_gpio_line(pin_name)
+                softpwm._softpwm_open(pin_info, pin_name)
+            except Exception:
+                del pin_info[pin_name]
+                raise RuntimeError("The channel is not support PWM mode")
+            pin_info[pin_name].pin_status = SOFT_PWM
+        else:
+            _export_pwm(self.pin_name)
         self.is_started = False
         self._configure(frequency_hz, 0.0)
 
     def __del__(self):
         if not pin_info.__contains__(self.pin_name):
             return
+        if pin_info[self.pin_name].pin_status == SOFT_PWM:
+            softpwm._softpwm_close(pin_info, self.pin_name)
+            del pin_info[self.pin_name]
+            return
         if pin_info[self.pin_name].pin_status != HARD_PWM:
             return
         self.stop()
@@ -504,10 +1277,21 @@ class PWM(object):
         if duty_cycle_percent < 0 or duty_cycle_percent > 100:
             raise ValueError("Wrong duty cycle value")
 
-        _enable_pwm(self.pin_name)
         self._configure(self.cur_frequency_hz, duty_cycle_percent)
+        if self.soft:
+            softpwm._softpwm_enable(pin_info, self.pin_name)
+        else:
+            _enable_pwm(self.pin_name)
         self.is_started = True
 
+    def set(self, frequency_hz, duty_cycle_percent):
+        if frequency_hz <= 0:
+            raise ValueError("Wrong frequency value")
+        if duty_cycle_percent < 0 or duty_cycle_percent > 100:
+            raise ValueError("Wrong duty cycle value")
+
+        self._configure(frequency_hz, duty_cycle_percent)
+
     def ChangeFrequency(self, frequency_hz):
         if frequency_hz <= 0:
             raise ValueError("Wrong frequency value")
@@ -521,29 +1305,26 @@ class PWM(object):
         self._configure(self.cur_frequency_hz, duty_cycle_percent)
 
     def stop(self):
-        _disable_pwm(self.pin_name)
+        if self.soft:
+            softpwm._softpwm_disable(pin_info, self.pin_name)
+        else:
+            _disable_pwm(self.pin_name)
         self.is_started = False
 
     def _configure(self, frequency_hz, duty_cycle_percent):
-        # Make sure to set the period first before setting the duty cycle
-        is_fre_changed = False
-        if self.cur_frequency_hz != frequency_hz:
-            is_fre_changed = True
-
-        if is_fre_changed:
-            _disable_pwm(self.pin_name)
-            self.is_started = False
-            _set_pwm_duty_cycle(self.pin_name, 0)
-            self.period_ns = int(1000000000.0 / frequency_hz)
-            _set_pwm_period(self.pin_name, self.period_ns)
-            self.cur_frequency_hz = frequency_hz
-
-        self.duty_cycle_ns = int(int(1000000000.0 / self.cur_frequency_hz) *
-                                 (duty_cycle_percent / 100.0))
-        _set_pwm_duty_cycle(self.pin_name, self.duty_cycle_ns)
+        # The output stays enabled, _update_pwm orders the writes so every
+        # intermediate period/duty pair is valid
+        if self.soft and frequency_hz > SOFT_PWM_MAX_FREQUENCY:
+            raise ValueError("Software PWM frequency must not exceed " +
+                             str(SOFT_PWM_MAX_FREQUENCY) + " Hz")
+        self.period_ns = int(1000000000.0 / frequency_hz)
+        self.duty_cycle_ns = int(self.period_ns * (duty_cycle_percent / 100.0))
+        if self.soft:
+            softpwm._softpwm_update(pin_info, self.pin_name,
+                                    self.period_ns, self.duty_cycle_ns)
+        else:
+            _update_pwm(self.pin_name, self.period_ns, self.duty_cycle_ns)
+            if self.is_started and self.duty_cycle_ns > 0:
+                _enable_pwm(self.pin_name)
+        self.cur_frequency_hz = frequency_hz
         self.cur_duty_cycle = duty_cycle_percent
-
-        if is_fre_changed:
-            _enable_pwm(self.pin_name)
-            self.is_started = True
-            is_fre_changed = False
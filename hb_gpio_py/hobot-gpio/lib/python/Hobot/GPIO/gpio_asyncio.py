@@ -0,0 +1,170 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# asyncio edge events. The line request fd of each channel is registered
+# with the running loop's selector, a ready fd is drained in one batch and
+# the edges are handed to the waiting coroutines, all on the loop's thread.
+# The fd is only registered while somebody waits on the channel.
+
+import asyncio
+import collections
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+from Hobot.GPIO import gpio_stats as stats
+
+# edges kept per events() iterator that is not consuming them, the oldest
+# are dropped first and show up as a gap in seqno
+STREAM_MAX_PENDING = 4096
+
+EdgeEvent = collections.namedtuple('EdgeEvent',
+                                   ['channel', 'edge', 'timestamp_ns',
+                                    'seqno'])
+
+
+def _wanted(want, edge):
+    return want == 'BOTH' or want == edge
+
+
+class _Stream(object):
+    def __init__(self, edge):
+        self.edge = edge
+        self.pending = collections.deque(maxlen=STREAM_MAX_PENDING)
+        self.wakeup = None
+
+    def put(self, event):
+        self.pending.append(event)
+        if self.wakeup is not None and not self.wakeup.done():
+            self.wakeup.set_result(None)
+
+    def fail(self, exc):
+        if self.wakeup is not None and not self.wakeup.done():
+            self.wakeup.set_exception(exc)
+
+
+class _Dispatcher(object):
+    def __init__(self, channel, reader):
+        self.channel = channel
+        self.reader = reader
+        self.loop = None
+        self.waiters = []
+        self.streams = []
+        self.last_seqno = None
+        self.debounce_us = 0
+
+    def attach(self):
+        loop = asyncio.get_event_loop()
+        if self.loop is loop:
+            return
+        if self.loop is not None:
+            raise RuntimeError("This channel is watched from another "
+                               "event loop")
+        # edges queued while nobody was waiting are not news
+        while self.reader.read():
+            pass
+        self.last_seqno = None
+        loop.add_reader(self.reader.fileno(), self._ready)
+        self.loop = loop
+
+    def detach_if_idle(self):
+        if self.loop is not None and not self.waiters and not self.streams:
+            self.loop.remove_reader(self.reader.fileno())
+            self.loop = None
+
+    def _ready(self):
+        for timestamp_ns, rising, seqno in self.reader.read():
+            # the kernel numbers edges per line, a gap means its kfifo
+            # overflowed
+            if stats.enabled and self.last_seqno is not None and \
+                    seqno > self.last_seqno + 1:
+                stats.missed(self.channel, seqno - self.last_seqno - 1)
+            self.last_seqno = seqno
+            edge = 'RISING' if rising else 'FALLING'
+            event = EdgeEvent(self.channel, edge, timestamp_ns, seqno)
+            for want, future in self.waiters:
+                if _wanted(want, edge) and not future.done():
+                    future.set_result(event)
+            for stream in self.streams:
+                if _wanted(stream.edge, edge):
+                    stream.put(event)
+
+    def close(self):
+        if self.loop is not None:
+            self.loop.remove_reader(self.reader.fileno())
+            self.loop = None
+        exc = RuntimeError("Channel " + str(self.channel) +
+                           " was cleaned up")
+        for want, future in self.waiters:
+            if not future.done():
+                future.set_exception(exc)
+        for stream in self.streams:
+            stream.fail(exc)
+        self.reader.close()
+
+
+async def _wait_edge(dispatcher, edge, timeout):
+    future = asyncio.get_event_loop().create_future()
+    waiter = (edge, future)
+    dispatcher.waiters.append(waiter)
+    try:
+        dispatcher.attach()
+        return await asyncio.wait_for(future, timeout / 1000.0
+                                      if timeout else None)
+    except asyncio.TimeoutError:
+        return None
+    finally:
+        dispatcher.waiters.remove(waiter)
+        dispatcher.detach_if_idle()
+
+
+async def _events(dispatcher, edge):
+    loop = asyncio.get_event_loop()
+    stream = _Stream(edge)
+    dispatcher.streams.append(stream)
+    try:
+        dispatcher.attach()
+        while True:
+            while stream.pending:
+                yield stream.pending.popleft()
+            stream.wakeup = loop.create_future()
+            await stream.wakeup
+    finally:
+        dispatcher.streams.remove(stream)
+        dispatcher.detach_if_idle()
+
+
+def _edges_open(pin_info, pin_name, debounce_us):
+    _check_native()
+    reader = _native.EdgeReader(pin_info[pin_name].gpio_chip,
+                                pin_info[pin_name].gpio_offset, debounce_us)
+    pin_info[pin_name].edges = _Dispatcher(pin_name, reader)
+    pin_info[pin_name].edges.debounce_us = debounce_us
+
+
+def _edges_debounce(pin_info, pin_name, debounce_us):
+    dispatcher = pin_info[pin_name].edges
+    if dispatcher.debounce_us != debounce_us:
+        dispatcher.reader.set_debounce(debounce_us)
+        dispatcher.debounce_us = debounce_us
+
+
+def _edges_value(pin_info, pin_name):
+    return pin_info[pin_name].edges.reader.value()
+
+
+def _edges_close(pin_info, pin_name):
+    if pin_info[pin_name].edges is not None:
+        pin_info[pin_name].edges.close()
+        pin_info[pin_name].edges = None
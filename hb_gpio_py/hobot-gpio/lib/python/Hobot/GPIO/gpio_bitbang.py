@@ -0,0 +1,47 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+
+
+def _line(pin_info, pin_name):
+    if pin_name is None:
+        return None
+    return (pin_info[pin_name].gpio_chip, pin_info[pin_name].gpio_offset)
+
+
+def _spi_open(pin_info, sclk, mosi, miso, cs, mode, speed_hz, lsb_first):
+    _check_native()
+    return _native.SoftSPI(_line(pin_info, sclk), _line(pin_info, mosi),
+                           _line(pin_info, miso), _line(pin_info, cs),
+                           mode, speed_hz, lsb_first)
+
+
+def _i2c_open(pin_info, scl, sda, speed_hz):
+    _check_native()
+    return _native.SoftI2C(_line(pin_info, scl), _line(pin_info, sda),
+                           speed_hz)
+
+
+def _onewire_open(pin_info, pin_name):
+    _check_native()
+    return _native.OneWire(_line(pin_info, pin_name))
+
+
+def _bitbang_close(pin_info, pin_name):
+    if pin_info[pin_name].bitbang is not None:
+        pin_info[pin_name].bitbang.close()
+        pin_info[pin_name].bitbang = None
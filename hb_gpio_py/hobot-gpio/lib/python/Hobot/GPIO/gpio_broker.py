@@ -0,0 +1,460 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Client side of hb_gpio_broker, see hb_gpio_broker/hb_gpio_broker.h for the
+# wire format. When the broker is running every gpio line goes through it:
+# inputs are read from its shared memory table without any syscall, outputs
+# and edge subscriptions are batched over its socket.
+
+import os
+import errno
+import mmap
+import socket
+import struct
+import threading
+import time
+import warnings
+
+from Hobot.GPIO.gpio_sysfs import root_path
+from Hobot.GPIO import gpio_stats as stats
+
+BROKER_SOCKET = root_path('/run/hobot-gpio/broker.sock')
+BROKER_SHM = root_path('/dev/shm/hobot-gpio')
+# HOBOT_GPIO_BROKER=0 drives the lines directly even if the broker is up
+BROKER_ENV = 'HOBOT_GPIO_BROKER'
+
+MAGIC = 0x4b524248
+VERSION = 2
+MAX_BATCH = 64
+# seconds to wait for the broker to answer a subscription
+REPLY_TIMEOUT = 5.0
+# seconds between two checks that the broker of the table still runs
+ALIVE_INTERVAL = 1.0
+
+REQUEST = 1
+RELEASE = 2
+SET = 3
+SUBSCRIBE = 4
+UNSUBSCRIBE = 5
+REPLY = 6
+EVENT = 7
+
+REQUEST_INPUT = 0
+REQUEST_OUTPUT_LOW = 1
+REQUEST_OUTPUT_HIGH = 2
+
+EDGE_MASK = {'RISING': 1, 'FALLING': 2, 'BOTH': 3}
+
+EVENT_BLOCK = "EVENT"
+EVENT_INTERRUPT = "INTERRUPT"
+
+_HDR = struct.Struct('=HHI')
+_ENTRY = struct.Struct('=IIiII4xQ')
+_TABLE = struct.Struct('=IHHII16x')
+_LINE = struct.Struct('=IHBBIIQII')
+_SEQ = struct.Struct('=I')
+
+_state = None
+_command = None
+_watch = None
+# replies to the watch connection, by cookie, for the callers waiting on
+# them; the watch thread owns the receiving side of that socket
+_replies = {}
+_reply_cond = threading.Condition()
+_watch_error = None
+_table = None
+_alive_check = [0.0]
+_mutex = threading.Lock()
+_slots = {}
+event_info = {}
+
+
+class _Connection(object):
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_SEQPACKET)
+        try:
+            self.sock.connect(path)
+        except socket.error:
+            self.sock.close()
+            raise
+        self.cookie = 0
+        self.lock = threading.Lock()
+
+    def _pack(self, msg_type, batch):
+        self.cookie = (self.cookie + 1) & 0xffffffff
+        buf = bytearray(_HDR.size + len(batch) * _ENTRY.size)
+        _HDR.pack_into(buf, 0, msg_type, len(batch), self.cookie)
+        for i, entry in enumerate(batch):
+            _ENTRY.pack_into(buf, _HDR.size + i * _ENTRY.size,
+                             entry[0], entry[1], entry[2], entry[3], 0, 0)
+        return buf
+
+    def send(self, msg_type, entries):
+        with self.lock:
+            for i in range(0, len(entries), MAX_BATCH):
+                self.sock.send(self._pack(msg_type, entries[i:i + MAX_BATCH]))
+
+    def call(self, msg_type, entries):
+        results = []
+        with self.lock:
+            for i in range(0, len(entries), MAX_BATCH):
+                batch = entries[i:i + MAX_BATCH]
+                try:
+                    self.sock.send(self._pack(msg_type, batch))
+                    reply = self.sock.recv(_HDR.size +
+                                           MAX_BATCH * _ENTRY.size)
+                except socket.error as exc:
+                    raise RuntimeError("Lost the connection to the gpio "
+                                       "broker: " + str(exc))
+                if len(reply) < _HDR.size:
+                    raise RuntimeError("Lost the connection to the gpio "
+                                       "broker")
+                reply_type, count, cookie = _HDR.unpack_from(reply, 0)
+                if reply_type != REPLY or cookie != self.cookie or \
+                        count != len(batch):
+                    raise RuntimeError("Unexpected reply from the gpio broker")
+                for j in range(count):
+                    entry = _ENTRY.unpack_from(reply,
+                                               _HDR.size + j * _ENTRY.size)
+                    results.append((entry[2], entry[3]))
+        return results
+
+    def close(self):
+        self.sock.close()
+
+
+class _BrokerEvent(object):
+    def __init__(self, event, edge=None, bouncetime=None):
+        self.event = event
+        self.edge = edge
+        self.bouncetime = bouncetime
+        self.lastcall = 0
+        self.last_seqno = None
+        self.is_occurred = False
+        self.fired = threading.Event()
+        self.callbacks = []
+
+
+def available():
+    global _state, _command, _table
+    if _state is None:
+        _state = False
+        if os.environ.get(BROKER_ENV, '1') != '0' and \
+                os.path.exists(BROKER_SOCKET):
+            try:
+                _table = _map_table()
+                _command = _Connection(BROKER_SOCKET)
+                _state = True
+            except (IOError, OSError, ValueError, socket.error):
+                _table = None
+    return _state
+
+
+def _map_table():
+    fd = os.open(BROKER_SHM, os.O_RDONLY)
+    try:
+        size = os.fstat(fd).st_size
+        table = mmap.mmap(fd, size, mmap.MAP_SHARED, mmap.PROT_READ)
+    finally:
+        os.close(fd)
+    magic, version, max_lines = _TABLE.unpack_from(table, 0)[:3]
+    if magic != MAGIC or version != VERSION or \
+            size < _TABLE.size + max_lines * _LINE.size:
+        table.close()
+        raise ValueError("Unsupported gpio broker table")
+    return table
+
+
+def _check_table():
+    # a restarted broker writes a new table, this one stays mapped with the
+    # lines frozen; its pid is cleared on a clean exit, a crash is noticed
+    # by probing the pid now and then
+    pid = _TABLE.unpack_from(_table, 0)[4]
+    if pid and time.time() - _alive_check[0] >= ALIVE_INTERVAL:
+        try:
+            os.kill(pid, 0)
+            _alive_check[0] = time.time()
+        except OSError as exc:
+            if exc.errno == errno.ESRCH:
+                pid = 0
+            else:
+                _alive_check[0] = time.time()
+    if not pid:
+        raise RuntimeError("The gpio broker stopped, the channels it "
+                           "served must be set up again")
+
+
+def _read_line(slot):
+    _check_table()
+    # seqlock reader, retry while the broker is updating the entry
+    offset = _TABLE.size + slot * _LINE.size
+    while True:
+        seq = _SEQ.unpack_from(_table, offset)[0]
+        if seq & 1:
+            continue
+        line = _LINE.unpack_from(_table, offset)
+        if line[0] == seq and _SEQ.unpack_from(_table, offset)[0] == seq:
+            return line
+
+
+def _chip_number(chip_path):
+    return int(os.path.basename(chip_path)[len('gpiochip'):])
+
+
+def _check(result, pin_name):
+    if result < 0:
+        raise RuntimeError("The gpio broker refused channel " +
+                           str(pin_name) + ": " + os.strerror(-result))
+
+
+def _line(pin_info, pin_name, value=0, arg=0):
+    return (_chip_number(pin_info[pin_name].gpio_chip),
+            pin_info[pin_name].gpio_offset, value, arg)
+
+
+def _broker_request(pin_info, pin_name, direction, initial=None):
+    if direction == "IN":
+        value = REQUEST_INPUT
+    elif initial:
+        value = REQUEST_OUTPUT_HIGH
+    else:
+        value = REQUEST_OUTPUT_LOW
+    result, slot = _command.call(REQUEST,
+                                 [_line(pin_info, pin_name, value)])[0]
+    _check(result, pin_name)
+    pin_info[pin_name].broker_slot = slot
+
+
+def _broker_release(pin_info, pin_name):
+    if pin_info[pin_name].broker_slot is None:
+        return
+    _command.call(RELEASE, [_line(pin_info, pin_name)])
+    pin_info[pin_name].broker_slot = None
+
+
+def _broker_output(pin_info, pin_names, values):
+    entries = [_line(pin_info, pin_name, int(values[i]))
+               for i, pin_name in enumerate(pin_names)]
+    for i, (result, slot) in enumerate(_command.call(SET, entries)):
+        _check(result, pin_names[i])
+
+
+def _broker_input(pin_info, pin_name):
+    return _read_line(pin_info[pin_name].broker_slot)[3]
+
+
+# EVENT function, same interface as gpio_event
+def _watch_thread():
+    size = _HDR.size + MAX_BATCH * _ENTRY.size
+    while True:
+        try:
+            msg = _watch.sock.recv(size)
+        except socket.error as exc:
+            _watch_lost(str(exc))
+            return
+        wake_ns = stats.now() if stats.enabled else 0
+        if len(msg) < _HDR.size:
+            _watch_lost("the broker closed the connection")
+            return
+        msg_type, count, cookie = _HDR.unpack_from(msg, 0)
+        if msg_type == REPLY:
+            with _reply_cond:
+                if cookie in _replies:
+                    _replies[cookie] = msg
+                    _reply_cond.notify_all()
+            continue
+        if msg_type != EVENT:
+            continue
+        for i in range(count):
+            entry = _ENTRY.unpack_from(msg, _HDR.size + i * _ENTRY.size)
+            _dispatch(entry[3], entry[2], entry[4], entry[5], wake_ns)
+
+
+def _watch_lost(reason):
+    # a restarted broker has forgotten our subscriptions, say so instead
+    # of leaving the callbacks silent
+    global _watch_error
+    with _reply_cond:
+        _watch_error = "Lost the connection to the gpio broker, edge " \
+                       "events have stopped: " + reason
+        _reply_cond.notify_all()
+    warnings.warn(_watch_error, RuntimeWarning)
+    with _mutex:
+        for info in event_info.values():
+            info.fired.set()
+
+
+def _check_watch():
+    if _watch_error is not None:
+        raise RuntimeError(_watch_error)
+
+
+def _watch_call(msg_type, entries):
+    # send on the watch connection and wait for the watch thread to hand
+    # the reply over
+    with _watch.lock:
+        buf = _watch._pack(msg_type, entries)
+        cookie = _watch.cookie
+        with _reply_cond:
+            _replies[cookie] = None
+        try:
+            _watch.sock.send(buf)
+        except socket.error:
+            with _reply_cond:
+                del _replies[cookie]
+            raise
+    deadline = time.time() + REPLY_TIMEOUT
+    with _reply_cond:
+        try:
+            while _replies[cookie] is None and _watch_error is None:
+                remaining = deadline - time.time()
+                if remaining <= 0:
+                    raise RuntimeError("The gpio broker did not answer")
+                _reply_cond.wait(remaining)
+        finally:
+            reply = _replies.pop(cookie)
+    _check_watch()
+    return [_ENTRY.unpack_from(reply, _HDR.size + i * _ENTRY.size)[2]
+            for i in range(len(entries))]
+
+
+def _dispatch(slot, value, seqno, timestamp_ns, wake_ns=0):
+    with _mutex:
+        pin_name = _slots.get(slot)
+        info = event_info.get(pin_name)
+        if info is None:
+            return
+        if wake_ns and info.last_seqno is not None:
+            # the broker numbers every edge of the line, the kernel's
+            # drops included; a one edge subscription skips every other
+            lost = ((seqno - info.last_seqno) & 0xffffffff) - \
+                (1 if info.edge == "BOTH" else 2)
+            if lost > 0:
+                stats.missed(pin_name, lost)
+        info.last_seqno = seqno
+        # debounce the input event for the specified bouncetime
+        if info.bouncetime and info.lastcall and \
+                timestamp_ns - info.lastcall < info.bouncetime * 1000000:
+            if wake_ns:
+                stats.debounced(pin_name)
+            return
+        info.lastcall = timestamp_ns
+        info.is_occurred = True
+        info.fired.set()
+        callbacks = list(info.callbacks)
+    if not wake_ns or not callbacks:
+        for callback in callbacks:
+            callback()
+        return
+    start_ns = stats.now()
+    for callback in callbacks:
+        callback()
+    stats.record(pin_name, timestamp_ns, wake_ns, start_ns, stats.now())
+
+
+def _subscribe(pin_info, pin_name, edge):
+    global _watch
+    _check_watch()
+    with _mutex:
+        if _watch is None:
+            _watch = _Connection(BROKER_SOCKET)
+            thread = threading.Thread(target=_watch_thread)
+            thread.daemon = True
+            thread.start()
+        _slots[pin_info[pin_name].broker_slot] = pin_name
+    result = _watch_call(SUBSCRIBE,
+                         [_line(pin_info, pin_name, 0, EDGE_MASK[edge])])[0]
+    _check(result, pin_name)
+
+
+def _is_event_added(pin_name):
+    if not event_info.__contains__(pin_name):
+        return "NO_EDGE"
+    return event_info[pin_name].edge
+
+
+def _add_event_detect(pin_info, pin_name, edge, bouncetime):
+    if event_info.__contains__(pin_name):
+        if event_info[pin_name].event == EVENT_BLOCK:
+            return -1
+    else:
+        with _mutex:
+            event_info[pin_name] = _BrokerEvent(EVENT_INTERRUPT, edge=edge,
+                                                bouncetime=bouncetime)
+    try:
+        _subscribe(pin_info, pin_name, edge)
+    except socket.error:
+        _del_event(pin_info, pin_name)
+        return -2
+    except RuntimeError:
+        _del_event(pin_info, pin_name)
+        raise
+    return 0
+
+
+def _add_callback(pin_name, callback):
+    with _mutex:
+        event_info[pin_name].callbacks.append(callback)
+
+
+def _is_event_occurred(pin_name):
+    retval = False
+    with _mutex:
+        if event_info.__contains__(pin_name) and \
+                event_info[pin_name].is_occurred:
+            event_info[pin_name].is_occurred = False
+            retval = True
+    return retval
+
+
+def _del_event(pin_info, pin_name):
+    if not event_info.__contains__(pin_name):
+        return
+    try:
+        _watch.send(UNSUBSCRIBE, [_line(pin_info, pin_name)])
+    except (AttributeError, socket.error):
+        pass
+    with _mutex:
+        _slots.pop(pin_info[pin_name].broker_slot, None)
+        del event_info[pin_name]
+
+
+def _add_event_block(pin_info, pin_name, edge, bouncetime, timeout):
+    if event_info.__contains__(pin_name):
+        if event_info[pin_name].event == EVENT_INTERRUPT:
+            return -1
+    else:
+        with _mutex:
+            event_info[pin_name] = _BrokerEvent(EVENT_BLOCK, edge=edge,
+                                                bouncetime=bouncetime)
+    try:
+        _subscribe(pin_info, pin_name, edge)
+    except socket.error:
+        _del_event(pin_info, pin_name)
+        return -2
+    except RuntimeError:
+        _del_event(pin_info, pin_name)
+        raise
+
+    timeout = (float(timeout) / 1000) if timeout else None
+    fired = event_info[pin_name].fired.wait(timeout)
+    _del_event(pin_info, pin_name)
+    _check_watch()
+    return int(bool(fired))
+
+
+def _event_cleanup(pin_info, pin_name):
+    _del_event(pin_info, pin_name)
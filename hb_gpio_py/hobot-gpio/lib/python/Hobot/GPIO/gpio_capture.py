@@ -0,0 +1,45 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+try:
+    from Hobot.GPIO import _native
+except ImportError:
+    _native = None
+
+
+def _check_native():
+    if _native is None:
+        raise RuntimeError("The native libgpiod backend is not available, "
+                           "reinstall Hobot.GPIO with libgpiod installed")
+
+
+def _capture_open(pin_info, pin_name, window, bouncetime):
+    _check_native()
+    debounce_us = int(bouncetime * 1000) if bouncetime else 0
+    pin_info[pin_name].capture = _native.Capture(pin_info[pin_name].gpio_chip,
+                                                 pin_info[pin_name].gpio_offset,
+                                                 int(window * 1000000),
+                                                 debounce_us)
+
+
+def _capture_measure(pin_info, pin_name):
+    return pin_info[pin_name].capture.measure()
+
+
+def _capture_close(pin_info, pin_name):
+    if pin_info[pin_name].capture is not None:
+        pin_info[pin_name].capture.close()
+        pin_info[pin_name].capture = None
@@ -23,6 +23,10 @@ except:
 
 from select import epoll, EPOLLIN, EPOLLET, EPOLLPRI
 from datetime import datetime
+import os
+
+from Hobot.GPIO import gpio_sysfs as sysfs
+from Hobot.GPIO import gpio_stats as stats
 
 try:
     InterruptedError = InterruptedError
@@ -47,12 +51,15 @@ class EventPro:
         self.init_flag = True
         self.gpio_value = None
         self.fd_gpio_value = None
+        self.fd_notify = None
         self.callbacks = []
 
     def __del__(self):
         del self.callbacks
         if self.fd_gpio_value:
             self.fd_gpio_value.close()
+        if self.fd_notify is not None:
+            os.close(self.fd_notify)
 
 
 def _is_event_added(pin_name):
@@ -80,10 +87,7 @@ def _add_event_detect(pin_info, pin_name, edge, bouncetime):
             _del_event(pin_info, pin_name)
             return -2
 
-    try:
-        event_info[pin_name].fd_epoll.register(event_info[pin_name].fd_gpio_value,
-            EPOLLIN | EPOLLET | EPOLLPRI)
-    except IOError:
+    if not _register(pin_info, pin_name):
         print("IOError occurs when gpio epoll blocks")
         _del_event(pin_info, pin_name)
         return -3
@@ -107,6 +111,9 @@ def _del_event(pin_info, pin_name):
             event_info[pin_name].fd_epoll.unregister(event_info[pin_name].fd_gpio_value)
         except Exception as exc:
             pass
+    if event_info[pin_name].fd_notify is not None:
+        os.close(event_info[pin_name].fd_notify)
+        event_info[pin_name].fd_notify = None
 
     _set_edge(pin_info[pin_name].gpio_edge, 'none')
 
@@ -135,15 +142,40 @@ def _is_event_occurred(pin_name):
     return retval
 
 
+def _register(pin_info, pin_name):
+    info = event_info[pin_name]
+    try:
+        info.fd_epoll.register(info.fd_gpio_value, EPOLLIN | EPOLLET | EPOLLPRI)
+        return True
+    except IOError:
+        pass
+    # a plain file, as in a simulated tree: wake up on writes to it, and
+    # take the current level as the reference since no initial event comes
+    info.fd_notify = sysfs.watch_writes(pin_info[pin_name].gpio_value)
+    if info.fd_notify is None:
+        return False
+    info.fd_epoll.register(info.fd_notify, EPOLLIN)
+    info.fd_gpio_value.seek(0)
+    info.gpio_value = info.fd_gpio_value.read().rstrip()
+    info.init_flag = False
+    return True
+
+
 def _set_edge(edge_path, edge):
     f_edge = open(edge_path, 'w')
     f_edge.write(edge.lower())
     f_edge.close()
 
 
-def _exe_callback(pin_name):
+def _exe_callback(pin_name, wake_ns=0):
+    if not wake_ns:
+        for callback in event_info[pin_name].callbacks:
+            callback()
+        return
+    start_ns = stats.now()
     for callback in event_info[pin_name].callbacks:
         callback()
+    stats.record(pin_name, None, wake_ns, start_ns, stats.now())
 
 
 def _poll_thread(pin_info, pin_name):
@@ -154,11 +186,14 @@ def _poll_thread(pin_info, pin_name):
     while thread_running:
         try:
             res = event_info[pin_name].fd_epoll.poll(maxevents=1)
+            wake_ns = stats.now() if stats.enabled else 0
 
             fileno = res[0][0]
             fd = event_info[pin_name].fd_gpio_value
             if fd is None or fd.closed:
                 continue
+            if event_info[pin_name].fd_notify is not None:
+                sysfs.drain(event_info[pin_name].fd_notify)
 
             fd = event_info[pin_name].fd_gpio_value
             fd.seek(0)
@@ -189,7 +224,14 @@ def _poll_thread(pin_info, pin_name):
                         event_info[pin_name].lastcall = time
                         event_info[pin_name].event_occurred = True
                         mutex.release()
-                        _exe_callback(pin_name)
+                        _exe_callback(pin_name, wake_ns)
+                    elif wake_ns:
+                        stats.debounced(pin_name)
+                elif wake_ns and event_info[pin_name].edge == "BOTH" and \
+                        gpio_value == event_info[pin_name].gpio_value:
+                    # woken up but back at the old level, the reread came
+                    # after at least one edge pair
+                    stats.missed(pin_name, 2)
 
                 mutex.acquire()
                 event_info[pin_name].gpio_value = gpio_value
@@ -227,19 +269,20 @@ def _add_event_block(pin_info, pin_name, edge, bouncetime, timeout):
             _del_event(pin_info, pin_name)
             return -2
 
-    try:
-        event_info[pin_name].fd_epoll.register(event_info[pin_name].fd_gpio_value,
-            EPOLLIN | EPOLLET | EPOLLPRI)
-    except IOError:
+    if not _register(pin_info, pin_name):
         print("IOError occurs when gpio epoll blocks")
         _del_event(pin_info, pin_name)
         return -3
+    if not event_info[pin_name].init_flag:
+        init_gpio_value = event_info[pin_name].gpio_value
 
     while not finished:
         try:
             res = event_info[pin_name].fd_epoll.poll(timeout, maxevents=1)
         except InterruptedError:
             continue
+        if event_info[pin_name].fd_notify is not None:
+            sysfs.drain(event_info[pin_name].fd_notify)
 
         fd = event_info[pin_name].fd_gpio_value
         fd.seek(0)
@@ -267,7 +310,7 @@ def _add_event_block(pin_info, pin_name, edge, bouncetime, timeout):
             init_gpio_value = gpio_value
     if res:
         fileno = res[0][0]
-        if fileno != fd.fileno():
+        if fileno != fd.fileno() and fileno != event_info[pin_name].fd_notify:
             _del_event(pin_info, pin_name)
             print("File handle not found")
             return -4
@@ -0,0 +1,101 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Lines behind open_output() and open_input(). Each one has write(value),
+# read() and close() and keeps whatever it needs to reach the line, so the
+# calls do not go through pin_info. The native line request is used when
+# the extension is built, the broker's slot when the broker holds the
+# lines, the sysfs value fd otherwise.
+
+import os
+
+from Hobot.GPIO.gpio_capture import _native
+from Hobot.GPIO import gpio_broker as broker
+
+_LEVELS = {0: b'0', 1: b'1'}
+
+
+def _invalid_value():
+    raise ValueError("The value setting of this channel is invalid")
+
+
+def _not_output():
+    raise RuntimeError("This line is not an output")
+
+
+class _SysfsLine(object):
+    def __init__(self, value_path, output):
+        self.fd = os.open(value_path, os.O_RDWR if output else os.O_RDONLY)
+        self.output = output
+
+    def write(self, value):
+        if not self.output:
+            _not_output()
+        data = _LEVELS.get(value)
+        if data is None:
+            _invalid_value()
+        os.lseek(self.fd, 0, os.SEEK_SET)
+        os.write(self.fd, data)
+
+    def read(self):
+        os.lseek(self.fd, 0, os.SEEK_SET)
+        return int(os.read(self.fd, 8).rstrip())
+
+    def close(self):
+        if self.fd >= 0:
+            os.close(self.fd)
+            self.fd = -1
+
+
+class _BrokerLine(object):
+    def __init__(self, pin_info, pin_name, output):
+        self.pin_name = pin_name
+        self.slot = pin_info[pin_name].broker_slot
+        self.output = output
+        # the SET entry of each level, built once
+        self.entries = {0: [broker._line(pin_info, pin_name, 0)],
+                        1: [broker._line(pin_info, pin_name, 1)]}
+
+    def write(self, value):
+        if not self.output:
+            _not_output()
+        entries = self.entries.get(value)
+        if entries is None:
+            _invalid_value()
+        broker._check(broker._command.call(broker.SET, entries)[0][0],
+                      self.pin_name)
+
+    def read(self):
+        return broker._read_line(self.slot)[3]
+
+    def close(self):
+        pass
+
+
+def _native_handles():
+    # the broker owns the lines when it runs, requesting them here would
+    # fail with EBUSY
+    return _native is not None and not broker.available()
+
+
+def _handle_open(pin_info, pin_name, output, initial):
+    if _native_handles():
+        return _native.Line(pin_info[pin_name].gpio_chip,
+                            pin_info[pin_name].gpio_offset, output,
+                            bool(initial))
+    if pin_info[pin_name].broker_slot is not None:
+        return _BrokerLine(pin_info, pin_name, output)
+    return _SysfsLine(pin_info[pin_name].gpio_value, output)
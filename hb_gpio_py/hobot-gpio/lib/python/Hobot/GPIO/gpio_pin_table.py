@@ -0,0 +1,323 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+# Row layout:
+# [0]- gpio_chip
+# [1]- gpio
+# [2]- board
+# [3]- bcm
+# [4]- cvm
+# [5]- soc_name
+# [6]- pwm_chip
+# [7]- pwm
+
+X3SDBV3_PINS = (
+    ('soc/a6003000.gpio', 11, 3, 2, 'I2C1_SDA', 'I2C1_SDA', None, None),
+    ('soc/a6003000.gpio', 10, 5, 3, 'I2C1_SCL', 'I2C1_SCL', None, None),
+    ('soc/a6003000.gpio', 38, 7, 4, 'GPIO38', 'GPIO38', None, None),
+    ('soc/a6003000.gpio', 6, 11, 17, 'GPIO6', 'JTG_TDI', None, None),
+    ('soc/a6003000.gpio', 5, 13, 27, 'GPIO5', 'JTG_TMS', None, None),
+    ('soc/a6003000.gpio', 30, 15, 22, 'GPIO30', 'BIFSPI_MISO', None, None),
+    ('soc/a6003000.gpio', 18, 19, 10, 'SPI0_MOSI', 'SPI0_MOSI', 'soc/a500e000.pwm', 2),
+    ('soc/a6003000.gpio', 19, 21, 9, 'SPI0_MISO', 'SPI0_MISO', 'soc/a500f000.pwm', 0),
+    ('soc/a6003000.gpio', 17, 23, 11, 'SPI0_SCLK', 'SPI0_SCLK', None, None),
+    ('soc/a6003000.gpio', 14, 29, 5, 'GPIO14', 'SPI2_SCLK', None, None),
+    ('soc/a6003000.gpio', 31, 31, 6, 'GPIO31', 'BIFSPI_RSTN', None, None),
+    ('soc/a6003000.gpio', 13, 33, 13, 'PWM8', 'SPI2_MISO', 'soc/a500f000.pwm', 2),
+    ('soc/a6003000.gpio', 103, 35, 19, 'I2S0_LRCK', 'I2S0_LRCK', None, None),
+    ('soc/a6003000.gpio', 29, 37, 26, 'GPIO29', 'BIFSPI_MOSI', None, None),
+    ('soc/a6003000.gpio', 95, 8, 14, 'UART0_TXD', 'UART0_TXD', None, None),
+    ('soc/a6003000.gpio', 96, 10, 15, 'UART0_RXD', 'UART0_RXD', None, None),
+    ('soc/a6003000.gpio', 102, 12, 18, 'I2S0_BCLK', 'I2S0_BCLK', None, None),
+    ('soc/a6003000.gpio', 27, 16, 23, 'GPIO27', 'BIFSPI_CSN', None, None),
+    ('soc/a6003000.gpio', 7, 18, 24, 'GPIO7', 'JTG_TDO', None, None),
+    ('soc/a6003000.gpio', 15, 22, 25, 'GPIO15', 'SPI2_CSN', None, None),
+    ('soc/a6003000.gpio', 16, 24, 8, 'SPI0_CSN', 'I2C4_SDA', None, None),
+    ('soc/a6003000.gpio', 120, 26, 7, 'SPI0_CSN1', 'QSPI_CSN1', None, None),
+    ('soc/a6003000.gpio', 12, 32, 12, 'PWM7', 'SPI2_MOSI', 'soc/a500f000.pwm', 1),
+    ('soc/a6003000.gpio', 28, 36, 16, 'GPIO28', 'BIFSPI_SCLK', None, None),
+    ('soc/a6003000.gpio', 104, 38, 20, 'I2S0_SDIO', 'I2S0_SDIO', None, None),
+    ('soc/a6003000.gpio', 108, 40, 21, 'I2S1_SDIO', 'I2S1_SDIO', None, None),
+)
+
+X3SDBV3_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 29: 9, 31: 10, 33: 11, 35: 12, 37: 13, 8: 14, 10: 15, 12: 16, 16: 17, 18: 18, 22: 19, 24: 20, 26: 21, 32: 22, 36: 23, 38: 24, 40: 25},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 5: 9, 6: 10, 13: 11, 19: 12, 26: 13, 14: 14, 15: 15, 18: 16, 23: 17, 24: 18, 25: 19, 8: 20, 7: 21, 12: 22, 16: 23, 20: 24, 21: 25},
+    'CVM': {'I2C1_SDA': 0, 'I2C1_SCL': 1, 'GPIO38': 2, 'GPIO6': 3, 'GPIO5': 4, 'GPIO30': 5, 'SPI0_MOSI': 6, 'SPI0_MISO': 7, 'SPI0_SCLK': 8, 'GPIO14': 9, 'GPIO31': 10, 'PWM8': 11, 'I2S0_LRCK': 12, 'GPIO29': 13, 'UART0_TXD': 14, 'UART0_RXD': 15, 'I2S0_BCLK': 16, 'GPIO27': 17, 'GPIO7': 18, 'GPIO15': 19, 'SPI0_CSN': 20, 'SPI0_CSN1': 21, 'PWM7': 22, 'GPIO28': 23, 'I2S0_SDIO': 24, 'I2S1_SDIO': 25},
+    'SOC': {11: 0, 10: 1, 38: 2, 6: 3, 5: 4, 30: 5, 18: 6, 19: 7, 17: 8, 14: 9, 31: 10, 13: 11, 103: 12, 29: 13, 95: 14, 96: 15, 102: 16, 27: 17, 7: 18, 15: 19, 16: 20, 120: 21, 12: 22, 28: 23, 104: 24, 108: 25},
+    'TEGRA_SOC': {'I2C1_SDA': 0, 'I2C1_SCL': 1, 'GPIO38': 2, 'JTG_TDI': 3, 'JTG_TMS': 4, 'BIFSPI_MISO': 5, 'SPI0_MOSI': 6, 'SPI0_MISO': 7, 'SPI0_SCLK': 8, 'SPI2_SCLK': 9, 'BIFSPI_RSTN': 10, 'SPI2_MISO': 11, 'I2S0_LRCK': 12, 'BIFSPI_MOSI': 13, 'UART0_TXD': 14, 'UART0_RXD': 15, 'I2S0_BCLK': 16, 'BIFSPI_CSN': 17, 'JTG_TDO': 18, 'SPI2_CSN': 19, 'I2C4_SDA': 20, 'QSPI_CSN1': 21, 'SPI2_MOSI': 22, 'BIFSPI_SCLK': 23, 'I2S0_SDIO': 24, 'I2S1_SDIO': 25},
+}
+
+X3SDB_PINS = (
+    ('soc/a6003000.gpio', 11, 3, 2, 'I2C1_SDA', 'I2C1_SDA', None, None),
+    ('soc/a6003000.gpio', 10, 5, 3, 'I2C1_SCL', 'I2C1_SCL', None, None),
+    ('soc/a6003000.gpio', 101, 7, 4, 'I2S0_MCLK', 'I2S0_MCLK', None, None),
+    ('soc/a6003000.gpio', 6, 11, 17, 'GPIO6', 'JTG_TDI', None, None),
+    ('soc/a6003000.gpio', 5, 13, 27, 'GPIO5', 'JTG_TMS', None, None),
+    ('soc/a6003000.gpio', 30, 15, 22, 'GPIO30', 'BIFSPI_MISO', None, None),
+    ('soc/a6003000.gpio', 18, 19, 10, 'SPI0_MOSI', 'SPI0_MOSI', 'soc/a500e000.pwm', 2),
+    ('soc/a6003000.gpio', 19, 21, 9, 'SPI0_MISO', 'SPI0_MISO', 'soc/a500f000.pwm', 0),
+    ('soc/a6003000.gpio', 17, 23, 11, 'SPI0_SCLK', 'SPI0_SCLK', None, None),
+    ('soc/a6003000.gpio', 106, 27, 0, 'I2S1_BLCK', 'I2S1_BLCK', None, None),
+    ('soc/a6003000.gpio', 14, 29, 5, 'GPIO14', 'SPI2_SCLK', None, None),
+    ('soc/a6003000.gpio', 31, 31, 6, 'GPIO31', 'BIFSPI_RSTN', None, None),
+    ('soc/a6003000.gpio', 4, 33, 13, 'PWM0', 'PWM0', 'soc/a500d000.pwm', 0),
+    ('soc/a6003000.gpio', 103, 35, 19, 'I2S0_LRCK', 'I2S0_LRCK', None, None),
+    ('soc/a6003000.gpio', 105, 37, 26, 'GPIO105', 'I2S1_MCLK', None, None),
+    ('soc/a6003000.gpio', 111, 8, 14, 'UART3_TXD', 'UART3_TXD', None, None),
+    ('soc/a6003000.gpio', 112, 10, 15, 'UART3_RXD', 'UART3_RXD', None, None),
+    ('soc/a6003000.gpio', 102, 12, 18, 'I2S0_BCLK', 'I2S0_BCLK', None, None),
+    ('soc/a6003000.gpio', 27, 16, 23, 'GPIO27', 'BIFSPI_CSN', None, None),
+    ('soc/a6003000.gpio', 7, 18, 24, 'GPIO7', 'JTG_TDO', None, None),
+    ('soc/a6003000.gpio', 15, 22, 25, 'GPIO15', 'SPI2_CSN', None, None),
+    ('soc/a6003000.gpio', 16, 24, 8, 'SPI0_CSN', 'I2C4_SDA', None, None),
+    ('soc/a6003000.gpio', 120, 26, 7, 'SPI0_CSN1', 'QSPI_CSN1', None, None),
+    ('soc/a6003000.gpio', 107, 28, 1, 'I2S1_LRCK', 'I2S1_LRCK', None, None),
+    ('soc/a6003000.gpio', 25, 32, 12, 'PWM4', 'PWM4', 'soc/a500e000.pwm', 1),
+    ('soc/a6003000.gpio', 3, 36, 16, 'GPIO3', 'JTG_TCK', None, None),
+    ('soc/a6003000.gpio', 104, 38, 20, 'I2S0_SDIO', 'I2S0_SDIO', None, None),
+    ('soc/a6003000.gpio', 108, 40, 21, 'I2S1_SDIO', 'I2S1_SDIO', None, None),
+)
+
+X3SDB_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 36: 25, 38: 26, 40: 27},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 16: 25, 20: 26, 21: 27},
+    'CVM': {'I2C1_SDA': 0, 'I2C1_SCL': 1, 'I2S0_MCLK': 2, 'GPIO6': 3, 'GPIO5': 4, 'GPIO30': 5, 'SPI0_MOSI': 6, 'SPI0_MISO': 7, 'SPI0_SCLK': 8, 'I2S1_BLCK': 9, 'GPIO14': 10, 'GPIO31': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'GPIO105': 14, 'UART3_TXD': 15, 'UART3_RXD': 16, 'I2S0_BCLK': 17, 'GPIO27': 18, 'GPIO7': 19, 'GPIO15': 20, 'SPI0_CSN': 21, 'SPI0_CSN1': 22, 'I2S1_LRCK': 23, 'PWM4': 24, 'GPIO3': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+    'SOC': {11: 0, 10: 1, 101: 2, 6: 3, 5: 4, 30: 5, 18: 6, 19: 7, 17: 8, 106: 9, 14: 10, 31: 11, 4: 12, 103: 13, 105: 14, 111: 15, 112: 16, 102: 17, 27: 18, 7: 19, 15: 20, 16: 21, 120: 22, 107: 23, 25: 24, 3: 25, 104: 26, 108: 27},
+    'TEGRA_SOC': {'I2C1_SDA': 0, 'I2C1_SCL': 1, 'I2S0_MCLK': 2, 'JTG_TDI': 3, 'JTG_TMS': 4, 'BIFSPI_MISO': 5, 'SPI0_MOSI': 6, 'SPI0_MISO': 7, 'SPI0_SCLK': 8, 'I2S1_BLCK': 9, 'SPI2_SCLK': 10, 'BIFSPI_RSTN': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'I2S1_MCLK': 14, 'UART3_TXD': 15, 'UART3_RXD': 16, 'I2S0_BCLK': 17, 'BIFSPI_CSN': 18, 'JTG_TDO': 19, 'SPI2_CSN': 20, 'I2C4_SDA': 21, 'QSPI_CSN1': 22, 'I2S1_LRCK': 23, 'PWM4': 24, 'JTG_TCK': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+}
+
+X3PI_PINS = (
+    ('soc/a6003000.gpio', 9, 3, 2, 'I2C0_SDA', 'I2C0_SDA', None, None),
+    ('soc/a6003000.gpio', 8, 5, 3, 'I2C0_SCL', 'I2C0_SCL', None, None),
+    ('soc/a6003000.gpio', 101, 7, 4, 'I2S0_MCLK', 'I2S0_MCLK', None, None),
+    ('soc/a6003000.gpio', 6, 11, 17, 'GPIO6', 'JTG_TDI', None, None),
+    ('soc/a6003000.gpio', 5, 13, 27, 'GPIO5', 'JTG_TMS', None, None),
+    ('soc/a6003000.gpio', 30, 15, 22, 'GPIO30', 'BIFSPI_MISO', None, None),
+    ('soc/a6003000.gpio', 12, 19, 10, 'SPI2_MOSI', 'SPI2_MOSI', 'soc/a500f000.pwm', 1),
+    ('soc/a6003000.gpio', 13, 21, 9, 'SPI2_MISO', 'SPI2_MISO', 'soc/a500f000.pwm', 2),
+    ('soc/a6003000.gpio', 14, 23, 11, 'SPI2_SCLK', 'SPI2_SCLK', None, None),
+    ('soc/a6003000.gpio', 106, 27, 0, 'I2S1_BCLK', 'I2S1_BCLK', None, None),
+    ('soc/a6003000.gpio', 119, 29, 5, 'GPIO119', 'GPIO119', None, None),
+    ('soc/a6003000.gpio', 118, 31, 6, 'GPIO118', 'GPIO118', None, None),
+    ('soc/a6003000.gpio', 4, 33, 13, 'PWM0', 'JTG_TRSTN', 'soc/a500d000.pwm', 0),
+    ('soc/a6003000.gpio', 103, 35, 19, 'I2S0_LRCK', 'I2S0_LRCK', None, None),
+    ('soc/a6003000.gpio', 105, 37, 26, 'GPIO105', 'I2S1_MCLK', None, None),
+    ('soc/a6003000.gpio', 111, 8, 14, 'UART_TXD', 'SENSOR2_MCLK', None, None),
+    ('soc/a6003000.gpio', 112, 10, 15, 'UART_RXD', 'SENSOR3_MCLK', None, None),
+    ('soc/a6003000.gpio', 102, 12, 18, 'I2S0_BCLK', 'I2S0_BCLK', None, None),
+    ('soc/a6003000.gpio', 27, 16, 23, 'GPIO27', 'BIFSPI_CSN', None, None),
+    ('soc/a6003000.gpio', 7, 18, 24, 'GPIO7', 'JTG_TDO', None, None),
+    ('soc/a6003000.gpio', 29, 22, 25, 'GPIO29', 'BIFSPI_MOSI', None, None),
+    ('soc/a6003000.gpio', 15, 24, 8, 'SPI2_CSN', 'SPI2_CSN', None, None),
+    ('soc/a6003000.gpio', 28, 26, 7, 'GPIO28', 'BIFSPI_SCLK', None, None),
+    ('soc/a6003000.gpio', 107, 28, 1, 'I2S1_LRCK', 'I2S1_LRCK', None, None),
+    ('soc/a6003000.gpio', 25, 32, 12, 'PWM4', 'PWM4', 'soc/a500e000.pwm', 1),
+    ('soc/a6003000.gpio', 3, 36, 16, 'GPIO3', 'JTG_TCK', None, None),
+    ('soc/a6003000.gpio', 104, 38, 20, 'I2S0_SDIO', 'I2S0_SDIO', None, None),
+    ('soc/a6003000.gpio', 108, 40, 21, 'I2S1_SDIO', 'I2S1_SDIO', None, None),
+)
+
+X3PI_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 36: 25, 38: 26, 40: 27},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 16: 25, 20: 26, 21: 27},
+    'CVM': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'GPIO6': 3, 'GPIO5': 4, 'GPIO30': 5, 'SPI2_MOSI': 6, 'SPI2_MISO': 7, 'SPI2_SCLK': 8, 'I2S1_BCLK': 9, 'GPIO119': 10, 'GPIO118': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'GPIO105': 14, 'UART_TXD': 15, 'UART_RXD': 16, 'I2S0_BCLK': 17, 'GPIO27': 18, 'GPIO7': 19, 'GPIO29': 20, 'SPI2_CSN': 21, 'GPIO28': 22, 'I2S1_LRCK': 23, 'PWM4': 24, 'GPIO3': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+    'SOC': {9: 0, 8: 1, 101: 2, 6: 3, 5: 4, 30: 5, 12: 6, 13: 7, 14: 8, 106: 9, 119: 10, 118: 11, 4: 12, 103: 13, 105: 14, 111: 15, 112: 16, 102: 17, 27: 18, 7: 19, 29: 20, 15: 21, 28: 22, 107: 23, 25: 24, 3: 25, 104: 26, 108: 27},
+    'TEGRA_SOC': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'JTG_TDI': 3, 'JTG_TMS': 4, 'BIFSPI_MISO': 5, 'SPI2_MOSI': 6, 'SPI2_MISO': 7, 'SPI2_SCLK': 8, 'I2S1_BCLK': 9, 'GPIO119': 10, 'GPIO118': 11, 'JTG_TRSTN': 12, 'I2S0_LRCK': 13, 'I2S1_MCLK': 14, 'SENSOR2_MCLK': 15, 'SENSOR3_MCLK': 16, 'I2S0_BCLK': 17, 'BIFSPI_CSN': 18, 'JTG_TDO': 19, 'BIFSPI_MOSI': 20, 'SPI2_CSN': 21, 'BIFSPI_SCLK': 22, 'I2S1_LRCK': 23, 'PWM4': 24, 'JTG_TCK': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+}
+
+X3CM_PINS = (
+    ('soc/a6003000.gpio', 9, 3, 2, 'I2C0_SDA', 'I2C0_SDA', None, None),
+    ('soc/a6003000.gpio', 8, 5, 3, 'I2C0_SCL', 'I2C0_SCL', None, None),
+    ('soc/a6003000.gpio', 101, 7, 4, 'I2S0_MCLK', 'I2S0_MCLK', None, None),
+    ('soc/a6003000.gpio', 12, 11, 17, 'GPIO17', 'SPI2_MOSI', 'soc/a500f000.pwm', 1),
+    ('soc/a6003000.gpio', 13, 13, 27, 'GPIO27', 'SPI2_MISO', 'soc/a500f000.pwm', 2),
+    ('soc/a6003000.gpio', 30, 15, 22, 'GPIO22', 'BIFSPI_MISO', None, None),
+    ('soc/a6003000.gpio', 6, 19, 10, 'SPI1_MOSI', 'SPI1_MOSI', None, None),
+    ('soc/a6003000.gpio', 7, 21, 9, 'SPI1_MISO', 'SPI1_MISO', None, None),
+    ('soc/a6003000.gpio', 3, 23, 11, 'SPI1_SCLK', 'SPI1_SCLK', None, None),
+    ('soc/a6003000.gpio', 15, 27, 0, 'I2C3_SDA', 'I2C3_SDA', None, None),
+    ('soc/a6003000.gpio', 119, 29, 5, 'GPIO5', 'LPWM3', None, None),
+    ('soc/a6003000.gpio', 118, 31, 6, 'GPIO6', 'LPWM4', None, None),
+    ('soc/a6003000.gpio', 4, 33, 13, 'PWM0', 'PWM0', 'soc/a500d000.pwm', 0),
+    ('soc/a6003000.gpio', 103, 35, 19, 'I2S0_LRCK', 'I2S0_LRCK', None, None),
+    ('soc/a6003000.gpio', 117, 37, 26, 'GPIO25', 'LPWM5', None, None),
+    ('soc/a6003000.gpio', 111, 8, 14, 'UART_TXD', 'UART3_TXD', None, None),
+    ('soc/a6003000.gpio', 112, 10, 15, 'UART_RXD', 'UART3_RXD', None, None),
+    ('soc/a6003000.gpio', 102, 12, 18, 'I2S0_BCLK', 'I2S0_BCLK', None, None),
+    ('soc/a6003000.gpio', 27, 16, 23, 'GPIO23', 'BIFSPI_CSN', None, None),
+    ('soc/a6003000.gpio', 22, 18, 24, 'GPIO24', 'PWM1', 'soc/a500d000.pwm', 1),
+    ('soc/a6003000.gpio', 29, 22, 25, 'GPIO25', 'BIFSPI_MOSI', None, None),
+    ('soc/a6003000.gpio', 5, 24, 8, 'SPI1_CSN', 'SPI1_CSN', None, None),
+    ('soc/a6003000.gpio', 28, 26, 7, 'GPIO7', 'BIFSPI_SCLK', None, None),
+    ('soc/a6003000.gpio', 14, 28, 1, 'I2C3_SCL', 'I2C3_SCL', None, None),
+    ('soc/a6003000.gpio', 25, 32, 12, 'PWM4', 'PWM4', 'soc/a500e000.pwm', 1),
+    ('soc/a6003000.gpio', 20, 36, 16, 'GPIO16', 'BIFSD_CLK', None, None),
+    ('soc/a6003000.gpio', 108, 38, 20, 'I2S1_SDIO', 'I2S1_SDIO', None, None),
+    ('soc/a6003000.gpio', 104, 40, 21, 'I2S0_SDIO', 'I2S0_SDIO', None, None),
+)
+
+X3CM_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 36: 25, 38: 26, 40: 27},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 16: 25, 20: 26, 21: 27},
+    'CVM': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'GPIO17': 3, 'GPIO27': 4, 'GPIO22': 5, 'SPI1_MOSI': 6, 'SPI1_MISO': 7, 'SPI1_SCLK': 8, 'I2C3_SDA': 9, 'GPIO5': 10, 'GPIO6': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'GPIO25': 20, 'UART_TXD': 15, 'UART_RXD': 16, 'I2S0_BCLK': 17, 'GPIO23': 18, 'GPIO24': 19, 'SPI1_CSN': 21, 'GPIO7': 22, 'I2C3_SCL': 23, 'PWM4': 24, 'GPIO16': 25, 'I2S1_SDIO': 26, 'I2S0_SDIO': 27},
+    'SOC': {9: 0, 8: 1, 101: 2, 12: 3, 13: 4, 30: 5, 6: 6, 7: 7, 3: 8, 15: 9, 119: 10, 118: 11, 4: 12, 103: 13, 117: 14, 111: 15, 112: 16, 102: 17, 27: 18, 22: 19, 29: 20, 5: 21, 28: 22, 14: 23, 25: 24, 20: 25, 108: 26, 104: 27},
+    'TEGRA_SOC': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'SPI2_MOSI': 3, 'SPI2_MISO': 4, 'BIFSPI_MISO': 5, 'SPI1_MOSI': 6, 'SPI1_MISO': 7, 'SPI1_SCLK': 8, 'I2C3_SDA': 9, 'LPWM3': 10, 'LPWM4': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'LPWM5': 14, 'UART3_TXD': 15, 'UART3_RXD': 16, 'I2S0_BCLK': 17, 'BIFSPI_CSN': 18, 'PWM1': 19, 'BIFSPI_MOSI': 20, 'SPI1_CSN': 21, 'BIFSPI_SCLK': 22, 'I2C3_SCL': 23, 'PWM4': 24, 'BIFSD_CLK': 25, 'I2S1_SDIO': 26, 'I2S0_SDIO': 27},
+}
+
+X3PI_V2_1_PINS = (
+    ('soc/a6003000.gpio', 9, 3, 2, 'I2C0_SDA', 'I2C0_SDA', None, None),
+    ('soc/a6003000.gpio', 8, 5, 3, 'I2C0_SCL', 'I2C0_SCL', None, None),
+    ('soc/a6003000.gpio', 101, 7, 4, 'I2S0_MCLK', 'I2S0_MCLK', None, None),
+    ('soc/a6003000.gpio', 12, 11, 17, 'GPIO17', 'SPI2_MOSI', 'soc/a500f000.pwm', 1),
+    ('soc/a6003000.gpio', 13, 13, 27, 'GPIO27', 'SPI2_MISO', 'soc/a500f000.pwm', 2),
+    ('soc/a6003000.gpio', 30, 15, 22, 'GPIO22', 'BIFSPI_MISO', None, None),
+    ('soc/a6003000.gpio', 6, 19, 10, 'SPI1_MOSI', 'SPI1_MOSI', None, None),
+    ('soc/a6003000.gpio', 7, 21, 9, 'SPI1_MISO', 'SPI1_MISO', None, None),
+    ('soc/a6003000.gpio', 3, 23, 11, 'SPI1_SCLK', 'SPI1_SCLK', None, None),
+    ('soc/a6003000.gpio', 15, 27, 0, 'I2C3_SDA', 'I2C3_SDA', None, None),
+    ('soc/a6003000.gpio', 119, 29, 5, 'GPIO5', 'LPWM3', None, None),
+    ('soc/a6003000.gpio', 118, 31, 6, 'GPIO6', 'LPWM4', None, None),
+    ('soc/a6003000.gpio', 4, 33, 13, 'PWM0', 'PWM0', 'soc/a500d000.pwm', 0),
+    ('soc/a6003000.gpio', 103, 35, 19, 'I2S0_LRCK', 'I2S0_LRCK', None, None),
+    ('soc/a6003000.gpio', 117, 37, 26, 'GPIO25', 'LPWM5', None, None),
+    ('soc/a6003000.gpio', 111, 8, 14, 'UART_TXD', 'UART3_TXD', None, None),
+    ('soc/a6003000.gpio', 112, 10, 15, 'UART_RXD', 'UART3_RXD', None, None),
+    ('soc/a6003000.gpio', 102, 12, 18, 'I2S0_BCLK', 'I2S0_BCLK', None, None),
+    ('soc/a6003000.gpio', 27, 16, 23, 'GPIO23', 'BIFSPI_CSN', None, None),
+    ('soc/a6003000.gpio', 22, 18, 24, 'GPIO24', 'PWM1', 'soc/a500d000.pwm', 1),
+    ('soc/a6003000.gpio', 29, 22, 25, 'GPIO25', 'BIFSPI_MOSI', None, None),
+    ('soc/a6003000.gpio', 5, 24, 8, 'SPI1_CSN', 'SPI1_CSN', None, None),
+    ('soc/a6003000.gpio', 28, 26, 7, 'GPIO7', 'BIFSPI_SCLK', None, None),
+    ('soc/a6003000.gpio', 14, 28, 1, 'I2C3_SCL', 'I2C3_SCL', None, None),
+    ('soc/a6003000.gpio', 25, 32, 12, 'PWM4', 'PWM4', 'soc/a500e000.pwm', 1),
+    ('soc/a6003000.gpio', 20, 36, 16, 'GPIO16', 'BIFSD_CLK', None, None),
+    ('soc/a6003000.gpio', 104, 38, 20, 'I2S0_SDIO', 'I2S0_SDIO', None, None),
+    ('soc/a6003000.gpio', 108, 40, 21, 'I2S1_SDIO', 'I2S1_SDIO', None, None),
+)
+
+X3PI_V2_1_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 36: 25, 38: 26, 40: 27},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 16: 25, 20: 26, 21: 27},
+    'CVM': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'GPIO17': 3, 'GPIO27': 4, 'GPIO22': 5, 'SPI1_MOSI': 6, 'SPI1_MISO': 7, 'SPI1_SCLK': 8, 'I2C3_SDA': 9, 'GPIO5': 10, 'GPIO6': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'GPIO25': 20, 'UART_TXD': 15, 'UART_RXD': 16, 'I2S0_BCLK': 17, 'GPIO23': 18, 'GPIO24': 19, 'SPI1_CSN': 21, 'GPIO7': 22, 'I2C3_SCL': 23, 'PWM4': 24, 'GPIO16': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+    'SOC': {9: 0, 8: 1, 101: 2, 12: 3, 13: 4, 30: 5, 6: 6, 7: 7, 3: 8, 15: 9, 119: 10, 118: 11, 4: 12, 103: 13, 117: 14, 111: 15, 112: 16, 102: 17, 27: 18, 22: 19, 29: 20, 5: 21, 28: 22, 14: 23, 25: 24, 20: 25, 104: 26, 108: 27},
+    'TEGRA_SOC': {'I2C0_SDA': 0, 'I2C0_SCL': 1, 'I2S0_MCLK': 2, 'SPI2_MOSI': 3, 'SPI2_MISO': 4, 'BIFSPI_MISO': 5, 'SPI1_MOSI': 6, 'SPI1_MISO': 7, 'SPI1_SCLK': 8, 'I2C3_SDA': 9, 'LPWM3': 10, 'LPWM4': 11, 'PWM0': 12, 'I2S0_LRCK': 13, 'LPWM5': 14, 'UART3_TXD': 15, 'UART3_RXD': 16, 'I2S0_BCLK': 17, 'BIFSPI_CSN': 18, 'PWM1': 19, 'BIFSPI_MOSI': 20, 'SPI1_CSN': 21, 'BIFSPI_SCLK': 22, 'I2C3_SCL': 23, 'PWM4': 24, 'BIFSD_CLK': 25, 'I2S0_SDIO': 26, 'I2S1_SDIO': 27},
+}
+
+RDK_X5_PINS = (
+    ('soc/34000000.a55_apb0/34120000.gpio', 390, 3, 2, 'SDA', 'I2C5_SDA', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 389, 5, 3, 'SCL', 'I2C5_SCL', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 420, 7, 4, 'GPCLK0', 'I2S1_MCLK', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 380, 11, 17, 'GPIO17', 'UART7_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 379, 13, 27, 'GPIO27', 'UART7_RXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 388, 15, 22, 'GPIO22', 'UART2_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 398, 19, 10, 'SPI_MOSI', 'SPI1_MOSI', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 397, 21, 9, 'SPI_MISO', 'SPI1_MISO', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 395, 23, 11, 'SPI_SCLK', 'SPI1_SCLK', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 355, 27, 0, 'ID_SD', 'I2C0_SDA', 'soc/34000000.a55_apb0/34160000.pwm', 1),
+    ('soc/34000000.a55_apb0/34120000.gpio', 399, 29, 5, 'GPIO5', 'SPI2_SCLK', 'soc/34000000.a55_apb0/34140000.pwm', 0),
+    ('soc/34000000.a55_apb0/34120000.gpio', 400, 31, 6, 'GPIO6', 'I2C1_SDA', 'soc/34000000.a55_apb0/34140000.pwm', 1),
+    ('soc/34000000.a55_apb0/34130000.gpio', 357, 33, 13, 'PWM', 'PWM7', 'soc/34000000.a55_apb0/34170000.pwm', 1),
+    ('soc/32080000.dsp_apb/32150000.gpio', 422, 35, 19, 'PCM_FS', 'I2S1_LRCK', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 401, 37, 26, 'GPIO26', 'SPI2_MISO', 'soc/34000000.a55_apb0/34150000.pwm', 0),
+    ('soc/34000000.a55_apb0/34120000.gpio', 383, 8, 14, 'TXD', 'UART1_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 384, 10, 15, 'RXD', 'UART1_RXD', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 421, 12, 18, 'PCM_CLK', 'I2S1_BCLK', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 382, 16, 23, 'GPIO23', 'UART6_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 402, 18, 24, 'GPIO24', 'SPI2_MOSI', 'soc/34000000.a55_apb0/34150000.pwm', 1),
+    ('soc/34000000.a55_apb0/34120000.gpio', 387, 22, 25, 'GPIO25', 'UART2_RXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 394, 24, 8, 'SPI_CSN0', 'SPI1_CSN1', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 396, 26, 7, 'SPI_CSN1', 'SPI1_CSN0', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 354, 28, 1, 'ID_SC', 'I2C0_SCL', 'soc/34000000.a55_apb0/34160000.pwm', 0),
+    ('soc/34000000.a55_apb0/34130000.gpio', 356, 32, 12, 'PWM', 'PWM6', 'soc/34000000.a55_apb0/34170000.pwm', 0),
+    ('soc/34000000.a55_apb0/34120000.gpio', 381, 36, 16, 'GPIO16', 'BIFSD_CLK', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 423, 38, 20, 'PCM_DIN', 'I2S1_SDIN', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 424, 40, 21, 'PCM_DOUT', 'I2S1_SDOUT', None, None),
+)
+
+RDK_X5_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 36: 25, 38: 26, 40: 27},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 16: 25, 20: 26, 21: 27},
+    'CVM': {'SDA': 0, 'SCL': 1, 'GPCLK0': 2, 'GPIO17': 3, 'GPIO27': 4, 'GPIO22': 5, 'SPI_MOSI': 6, 'SPI_MISO': 7, 'SPI_SCLK': 8, 'ID_SD': 9, 'GPIO5': 10, 'GPIO6': 11, 'PWM': 24, 'PCM_FS': 13, 'GPIO26': 14, 'TXD': 15, 'RXD': 16, 'PCM_CLK': 17, 'GPIO23': 18, 'GPIO24': 19, 'GPIO25': 20, 'SPI_CSN0': 21, 'SPI_CSN1': 22, 'ID_SC': 23, 'GPIO16': 25, 'PCM_DIN': 26, 'PCM_DOUT': 27},
+    'SOC': {390: 0, 389: 1, 420: 2, 380: 3, 379: 4, 388: 5, 398: 6, 397: 7, 395: 8, 355: 9, 399: 10, 400: 11, 357: 12, 422: 13, 401: 14, 383: 15, 384: 16, 421: 17, 382: 18, 402: 19, 387: 20, 394: 21, 396: 22, 354: 23, 356: 24, 381: 25, 423: 26, 424: 27},
+    'TEGRA_SOC': {'I2C5_SDA': 0, 'I2C5_SCL': 1, 'I2S1_MCLK': 2, 'UART7_TXD': 3, 'UART7_RXD': 4, 'UART2_TXD': 5, 'SPI1_MOSI': 6, 'SPI1_MISO': 7, 'SPI1_SCLK': 8, 'I2C0_SDA': 9, 'SPI2_SCLK': 10, 'I2C1_SDA': 11, 'PWM7': 12, 'I2S1_LRCK': 13, 'SPI2_MISO': 14, 'UART1_TXD': 15, 'UART1_RXD': 16, 'I2S1_BCLK': 17, 'UART6_TXD': 18, 'SPI2_MOSI': 19, 'UART2_RXD': 20, 'SPI1_CSN1': 21, 'SPI1_CSN0': 22, 'I2C0_SCL': 23, 'PWM6': 24, 'BIFSD_CLK': 25, 'I2S1_SDIN': 26, 'I2S1_SDOUT': 27},
+}
+
+EVB_X5_PINS = (
+    ('soc/34000000.a55_apb0/34120000.gpio', 390, 3, 2, 'SDA5', 'I2C5_SDA', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 389, 5, 3, 'SCL5', 'I2C5_SCL', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 420, 7, 4, 'I2S1_MCLK', 'DSP_MCLK1', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 382, 11, 17, 'GPIO17', 'UART7_RTS', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 381, 13, 27, 'GPIO27', 'UART7_CTS', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 385, 15, 22, 'GPIO22', 'UART1_CTS', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 402, 19, 10, 'SPI2_MOSI', 'SPI2_MOSI', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 401, 21, 9, 'SPI2_MISO', 'SPI2_MISO', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 399, 23, 11, 'SPI2_SCLK', 'SPI2_SCLK', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 357, 27, 0, 'SDA1', 'I2C1_SDA', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 379, 29, 5, 'GPIO5', 'UART7_RX', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 380, 31, 6, 'GPIO6', 'UART7_TX', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 354, 33, 13, 'PWM4', 'PWM4', 'soc/34000000.a55_apb0/34160000.pwm', 0),
+    ('soc/32080000.dsp_apb/32150000.gpio', 422, 35, 19, 'I2S1_WS', 'I2S1_WS', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 386, 37, 26, 'GPIO26', 'UART1_RTS', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 387, 8, 14, 'TXD', 'UART2_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 388, 10, 15, 'RXD', 'UART2_RXD', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 421, 12, 18, 'I2S1_BCLK', 'I2S1_BCLK', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 383, 16, 23, 'GPIO23', 'UART1_RXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 384, 18, 24, 'GPIO24', 'UART1_TXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 391, 22, 25, 'GPIO25', 'UART4_RXD', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 400, 24, 8, 'SPI2_CSN', 'SPI2_CSN', None, None),
+    ('soc/34000000.a55_apb0/34120000.gpio', 392, 26, 7, 'GPIO7', 'UART4_TXD', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 356, 28, 1, 'SCL1', 'I2C1_SCL', None, None),
+    ('soc/34000000.a55_apb0/34130000.gpio', 355, 32, 12, 'PWM', 'PWM5', 'soc/34000000.a55_apb0/34160000.pwm', 1),
+    ('soc/32080000.dsp_apb/32150000.gpio', 423, 38, 20, 'I2S1_DI', 'I2S1_SDIN', None, None),
+    ('soc/32080000.dsp_apb/32150000.gpio', 424, 40, 21, 'I2S1_DO', 'I2S1_SDOUT', None, None),
+)
+
+EVB_X5_INDEX = {
+    'BOARD': {3: 0, 5: 1, 7: 2, 11: 3, 13: 4, 15: 5, 19: 6, 21: 7, 23: 8, 27: 9, 29: 10, 31: 11, 33: 12, 35: 13, 37: 14, 8: 15, 10: 16, 12: 17, 16: 18, 18: 19, 22: 20, 24: 21, 26: 22, 28: 23, 32: 24, 38: 25, 40: 26},
+    'BCM': {2: 0, 3: 1, 4: 2, 17: 3, 27: 4, 22: 5, 10: 6, 9: 7, 11: 8, 0: 9, 5: 10, 6: 11, 13: 12, 19: 13, 26: 14, 14: 15, 15: 16, 18: 17, 23: 18, 24: 19, 25: 20, 8: 21, 7: 22, 1: 23, 12: 24, 20: 25, 21: 26},
+    'CVM': {'SDA5': 0, 'SCL5': 1, 'I2S1_MCLK': 2, 'GPIO17': 3, 'GPIO27': 4, 'GPIO22': 5, 'SPI2_MOSI': 6, 'SPI2_MISO': 7, 'SPI2_SCLK': 8, 'SDA1': 9, 'GPIO5': 10, 'GPIO6': 11, 'PWM4': 12, 'I2S1_WS': 13, 'GPIO26': 14, 'TXD': 15, 'RXD': 16, 'I2S1_BCLK': 17, 'GPIO23': 18, 'GPIO24': 19, 'GPIO25': 20, 'SPI2_CSN': 21, 'GPIO7': 22, 'SCL1': 23, 'PWM': 24, 'I2S1_DI': 25, 'I2S1_DO': 26},
+    'SOC': {390: 0, 389: 1, 420: 2, 382: 3, 381: 4, 385: 5, 402: 6, 401: 7, 399: 8, 357: 9, 379: 10, 380: 11, 354: 12, 422: 13, 386: 14, 387: 15, 388: 16, 421: 17, 383: 18, 384: 19, 391: 20, 400: 21, 392: 22, 356: 23, 355: 24, 423: 25, 424: 26},
+    'TEGRA_SOC': {'I2C5_SDA': 0, 'I2C5_SCL': 1, 'DSP_MCLK1': 2, 'UART7_RTS': 3, 'UART7_CTS': 4, 'UART1_CTS': 5, 'SPI2_MOSI': 6, 'SPI2_MISO': 7, 'SPI2_SCLK': 8, 'I2C1_SDA': 9, 'UART7_RX': 10, 'UART7_TX': 11, 'PWM4': 12, 'I2S1_WS': 13, 'UART1_RTS': 14, 'UART2_TXD': 15, 'UART2_RXD': 16, 'I2S1_BCLK': 17, 'UART1_RXD': 18, 'UART1_TXD': 19, 'UART4_RXD': 20, 'SPI2_CSN': 21, 'UART4_TXD': 22, 'I2C1_SCL': 23, 'PWM5': 24, 'I2S1_SDIN': 25, 'I2S1_SDOUT': 26},
+}
+
+# soc -> board id -> (board name, rows, index)
+BOARDS = {
+    'x3': {
+        0x304: ('X3SDBV3', X3SDBV3_PINS, X3SDBV3_INDEX),
+        0x404: ('X3SDB', X3SDB_PINS, X3SDB_INDEX),
+        0x504: ('X3PI', X3PI_PINS, X3PI_INDEX),
+        0x604: ('X3PI', X3PI_PINS, X3PI_INDEX),
+        0xb04: ('X3CM', X3CM_PINS, X3CM_INDEX),
+        0x804: ('X3PI_V2_1', X3PI_V2_1_PINS, X3PI_V2_1_INDEX),
+    },
+    'x5': {
+        0x301: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x302: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x501: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x502: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x503: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x504: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x505: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x506: ('RDK_X5', RDK_X5_PINS, RDK_X5_INDEX),
+        0x201: ('EVB_X5', EVB_X5_PINS, EVB_X5_INDEX),
+        0x202: ('EVB_X5', EVB_X5_PINS, EVB_X5_INDEX),
+        0x203: ('EVB_X5', EVB_X5_PINS, EVB_X5_INDEX),
+        0x204: ('EVB_X5', EVB_X5_PINS, EVB_X5_INDEX),
+    },
+}
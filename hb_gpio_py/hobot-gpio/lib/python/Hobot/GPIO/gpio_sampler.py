@@ -0,0 +1,38 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+from Hobot.GPIO.gpio_wave import _isolated_cpu
+
+
+def _sampler_open(pin_info, pin_names):
+    _check_native()
+    return _native.Sampler([(pin_info[x].gpio_chip, pin_info[x].gpio_offset)
+                            for x in pin_names])
+
+
+def _sampler_read(sampler, buffer, rate_hz, count, timestamps, cpu):
+    if cpu is None:
+        cpu = _isolated_cpu()
+    if count is None:
+        count = -1
+    return sampler.read(buffer, rate_hz, count, timestamps, cpu)
+
+
+def _sampler_close(pin_info, pin_name):
+    if pin_info[pin_name].sampler is not None:
+        pin_info[pin_name].sampler.close()
+        pin_info[pin_name].sampler = None
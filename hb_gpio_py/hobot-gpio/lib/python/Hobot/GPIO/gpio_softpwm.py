@@ -0,0 +1,41 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+
+
+def _softpwm_open(pin_info, pin_name):
+    _check_native()
+    pin_info[pin_name].soft_pwm = _native.SoftPWM(pin_info[pin_name].gpio_chip,
+                                                  pin_info[pin_name].gpio_offset)
+
+
+def _softpwm_update(pin_info, pin_name, period_ns, duty_cycle_ns):
+    pin_info[pin_name].soft_pwm.configure(period_ns, duty_cycle_ns)
+
+
+def _softpwm_enable(pin_info, pin_name):
+    pin_info[pin_name].soft_pwm.enable()
+
+
+def _softpwm_disable(pin_info, pin_name):
+    pin_info[pin_name].soft_pwm.disable()
+
+
+def _softpwm_close(pin_info, pin_name):
+    if pin_info[pin_name].soft_pwm is not None:
+        pin_info[pin_name].soft_pwm.close()
+        pin_info[pin_name].soft_pwm = None
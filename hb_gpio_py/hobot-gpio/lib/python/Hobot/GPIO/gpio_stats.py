@@ -0,0 +1,254 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Edge to callback latency of every pin with an event callback, split in
+# three stages, each kept in an HDR style histogram:
+#   wake      kernel timestamp of the edge -> event thread woken up
+#   dispatch  event thread woken up -> first callback called
+#   callback  first callback called -> last callback returned
+# sysfs edges carry no kernel timestamp, so "wake" is only filled for lines
+# served by hb_gpio_broker. Counters next to the histograms:
+#   missed        edges lost before the callbacks, from the gaps in the
+#                 edge numbers of the broker and of native line requests,
+#                 from two edges the same way in a row on sysfs
+#   debounced     edges dropped by bouncetime
+#   out_of_range  samples above the histogram range (HIGHEST_NS)
+# HOBOT_GPIO_STATS=1 or GPIO.set_edge_stats(True) turns it on. The figures
+# are also written, at most once per FLUSH_INTERVAL, to STATS_PATH, which
+# is removed when the process exits.
+
+import os
+import json
+import time
+import atexit
+import tempfile
+import threading
+
+from Hobot.GPIO.gpio_sysfs import root_path
+
+STATS_ENV = 'HOBOT_GPIO_STATS'
+# sticky and world writable, every process only replaces its own file
+STATS_DIR = root_path('/run/hobot-gpio/stats')
+STATS_PATH = os.path.join(STATS_DIR, 'edge-stats.%d.json')
+FLUSH_INTERVAL = 1.0
+STAGES = ('wake', 'dispatch', 'callback')
+PERCENTILES = (('p50', 50.0), ('p90', 90.0), ('p99', 99.0), ('p999', 99.9))
+
+# 2^7 sub-buckets per power of two keep every value within 1/64 (1.6%),
+# from 1ns up to HIGHEST_NS (about 68s) in 2048 counters
+SUB_BUCKET_BITS = 7
+SUB_BUCKET_HALF = 1 << (SUB_BUCKET_BITS - 1)
+HIGHEST_NS = 1 << 36
+
+try:
+    now = time.monotonic_ns
+except AttributeError:
+    def now():
+        return int(time.monotonic() * 1000000000)
+
+enabled = os.environ.get(STATS_ENV, '0') not in ('', '0')
+_pins = {}
+_mutex = threading.Lock()
+_flush_mutex = threading.Lock()
+_last_flush = [0.0]
+_closed = [False]
+
+
+def _index(value):
+    if value < 2 * SUB_BUCKET_HALF:
+        return value
+    shift = value.bit_length() - SUB_BUCKET_BITS
+    return shift * SUB_BUCKET_HALF + (value >> shift)
+
+
+def _value(index):
+    # middle of the range of values counted at index
+    if index < 2 * SUB_BUCKET_HALF:
+        return index
+    shift = index // SUB_BUCKET_HALF - 1
+    low = (index - shift * SUB_BUCKET_HALF) << shift
+    return low + (1 << (shift - 1))
+
+
+class Histogram(object):
+    def __init__(self):
+        self.counts = [0] * (_index(HIGHEST_NS - 1) + 1)
+        self.reset()
+
+    def reset(self):
+        for i in range(len(self.counts)):
+            self.counts[i] = 0
+        self.total = 0
+        self.sum = 0
+        self.min = None
+        self.max = None
+        self.out_of_range = 0
+
+    def record(self, value):
+        if value < 0:
+            # clocks of two cpus, never a real negative latency
+            value = 0
+        if value >= HIGHEST_NS:
+            self.out_of_range += 1
+            return
+        self.counts[_index(value)] += 1
+        self.total += 1
+        self.sum += value
+        if self.min is None or value < self.min:
+            self.min = value
+        if self.max is None or value > self.max:
+            self.max = value
+
+    def percentiles(self):
+        result = {}
+        wanted = [(key, max(1, int(self.total * q / 100.0 + 0.5)))
+                  for key, q in PERCENTILES]
+        seen = 0
+        for index, count in enumerate(self.counts):
+            if not count:
+                continue
+            seen += count
+            while wanted and seen >= wanted[0][1]:
+                result[wanted.pop(0)[0]] = min(_value(index), self.max)
+            if not wanted:
+                break
+        return result
+
+    def snapshot(self):
+        summary = {'count': self.total, 'out_of_range': self.out_of_range}
+        if self.total:
+            summary.update(min=self.min, max=self.max,
+                           mean=self.sum // self.total)
+            summary.update(self.percentiles())
+        return summary
+
+
+class PinStats(object):
+    def __init__(self):
+        self.stages = dict((name, Histogram()) for name in STAGES)
+        self.reset()
+
+    def reset(self):
+        for histogram in self.stages.values():
+            histogram.reset()
+        self.edges = 0
+        self.missed = 0
+        self.debounced = 0
+
+    def snapshot(self):
+        stages = dict((name, histogram.snapshot())
+                      for name, histogram in self.stages.items())
+        return {
+            'edges': self.edges,
+            'missed': self.missed,
+            'debounced': self.debounced,
+            'out_of_range': sum(x['out_of_range'] for x in stages.values()),
+            'stages_ns': stages,
+        }
+
+
+def _pin(pin_name):
+    stats = _pins.get(pin_name)
+    if stats is None:
+        with _mutex:
+            stats = _pins.setdefault(pin_name, PinStats())
+    return stats
+
+
+def set_enabled(state):
+    global enabled
+    enabled = bool(state)
+
+
+def record(pin_name, kernel_ns, wake_ns, start_ns, end_ns):
+    stats = _pin(pin_name)
+    stats.edges += 1
+    if kernel_ns:
+        stats.stages['wake'].record(wake_ns - kernel_ns)
+    stats.stages['dispatch'].record(start_ns - wake_ns)
+    stats.stages['callback'].record(end_ns - start_ns)
+    flush()
+
+
+def missed(pin_name, count=1):
+    _pin(pin_name).missed += count
+
+
+def debounced(pin_name):
+    _pin(pin_name).debounced += 1
+
+
+def snapshot(pin_name=None):
+    if pin_name is not None:
+        stats = _pins.get(pin_name)
+        return stats.snapshot() if stats is not None else None
+    with _mutex:
+        pins = list(_pins.items())
+    return dict((name, stats.snapshot()) for name, stats in pins)
+
+
+def reset(pin_name=None):
+    with _mutex:
+        pins = list(_pins.items())
+    for name, stats in pins:
+        if pin_name is None or name == pin_name:
+            stats.reset()
+
+
+def flush(force=False):
+    # called from the event threads, never let a slow /run stall them
+    if not force and time.time() - _last_flush[0] < FLUSH_INTERVAL:
+        return
+    if not _flush_mutex.acquire(False):
+        return
+    try:
+        _last_flush[0] = time.time()
+        pins = snapshot()
+        if not pins or _closed[0]:
+            return
+        path = STATS_PATH % os.getpid()
+        tmp_path = None
+        try:
+            fd, tmp_path = tempfile.mkstemp(prefix='edge-stats.',
+                                            dir=STATS_DIR)
+            os.fchmod(fd, 0o644)
+            with os.fdopen(fd, 'w') as f:
+                json.dump({'pid': os.getpid(), 'timestamp': _last_flush[0],
+                           'pins': dict((str(name), pin)
+                                        for name, pin in pins.items())},
+                          f, sort_keys=True)
+            os.rename(tmp_path, path)
+        except (IOError, OSError):
+            if tmp_path is not None:
+                try:
+                    os.remove(tmp_path)
+                except (IOError, OSError):
+                    pass
+    finally:
+        _flush_mutex.release()
+
+
+def _flush_at_exit():
+    # the figures die with the process, do not leave one file per pid
+    with _flush_mutex:
+        _closed[0] = True
+        try:
+            os.remove(STATS_PATH % os.getpid())
+        except (IOError, OSError):
+            pass
+
+
+atexit.register(_flush_at_exit)
@@ -0,0 +1,152 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import os
+import time
+import errno
+import select
+import ctypes
+import ctypes.util
+
+# Exporting a gpio or pwm creates its sysfs node synchronously, but the
+# permissions are fixed up afterwards by 99-gpio.rules. udev's chown/chmod
+# raises IN_ATTRIB on the node, so wait for that instead of polling.
+WAIT_TIMEOUT = 5.0
+# Re-check interval while the node itself does not exist yet, kernfs does
+# not report IN_CREATE for new nodes
+WAIT_RECHECK = 0.1
+POLL_INTERVAL = 0.01
+
+# HOBOT_IO_ROOT moves every kernel path used by the library, sysfs, /proc,
+# /dev and /run, under another directory, e.g. a tree run by hb_gpio_sim
+ROOT = os.environ.get('HOBOT_IO_ROOT', '').rstrip('/')
+
+IN_NONBLOCK = 0o4000
+IN_CLOEXEC = 0o2000000
+IN_MODIFY = 0x00000002
+IN_ATTRIB = 0x00000004
+IN_CREATE = 0x00000100
+IN_DELETE = 0x00000200
+IN_DELETE_SELF = 0x00000400
+
+_libc = None
+
+
+def _get_libc():
+    global _libc
+    if _libc is None:
+        try:
+            _libc = ctypes.CDLL(ctypes.util.find_library('c'), use_errno=True)
+            _libc.inotify_init1
+        except (OSError, AttributeError):
+            _libc = False
+    return _libc
+
+
+def root_path(path):
+    return ROOT + path
+
+
+def _inotify_open(path):
+    libc = _get_libc()
+    if not libc:
+        return None, False
+
+    fd = libc.inotify_init1(IN_NONBLOCK | IN_CLOEXEC)
+    if fd < 0:
+        return None, False
+
+    watch_node = os.path.exists(path)
+    if watch_node:
+        target = path
+        mask = IN_ATTRIB | IN_DELETE_SELF
+    else:
+        target = os.path.dirname(path)
+        mask = IN_CREATE | IN_DELETE | IN_ATTRIB
+    wd = libc.inotify_add_watch(fd, target.encode(), mask)
+    if wd < 0:
+        os.close(fd)
+        return None, False
+    return fd, watch_node
+
+
+def _wait(path, done, timeout):
+    if done():
+        return True
+
+    deadline = time.time() + timeout
+    fd, watch_node = _inotify_open(path)
+    try:
+        while not done():
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                return False
+            if fd is None:
+                time.sleep(min(remaining, POLL_INTERVAL))
+                continue
+            if not watch_node:
+                remaining = min(remaining, WAIT_RECHECK)
+            try:
+                readable = select.select([fd], [], [], remaining)[0]
+            except (OSError, select.error) as exc:
+                if exc.args[0] == errno.EINTR:
+                    continue
+                raise
+            if readable:
+                try:
+                    os.read(fd, 4096)
+                except OSError:
+                    pass
+            if not watch_node and os.path.exists(path):
+                # the node appeared, watch it directly from now on
+                os.close(fd)
+                fd, watch_node = _inotify_open(path)
+        return True
+    finally:
+        if fd is not None:
+            os.close(fd)
+
+
+def wait_for_access(path, mode, timeout=WAIT_TIMEOUT):
+    return _wait(path, lambda: os.access(path, mode), timeout)
+
+
+def wait_for_no_access(path, mode, timeout=WAIT_TIMEOUT):
+    return _wait(path, lambda: not os.access(path, mode), timeout)
+
+
+def watch_writes(path):
+    # Regular files, such as the value nodes of a simulated tree, cannot be
+    # polled for edges. Return a non-blocking inotify fd that becomes
+    # readable whenever the file is written, or None.
+    libc = _get_libc()
+    if not libc:
+        return None
+    fd = libc.inotify_init1(IN_NONBLOCK | IN_CLOEXEC)
+    if fd < 0:
+        return None
+    if libc.inotify_add_watch(fd, path.encode(), IN_MODIFY) < 0:
+        os.close(fd)
+        return None
+    return fd
+
+
+def drain(fd):
+    try:
+        while os.read(fd, 4096):
+            pass
+    except OSError:
+        pass
@@ -0,0 +1,146 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Edge trace files, the format is described in lib/c/hb_trace.h. The reader
+# maps the file and decodes the records in place, so a trace much larger
+# than memory can be walked, and a trace that is still being recorded can
+# be read up to the last batch the recorder committed.
+
+import collections
+import mmap
+import struct
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+
+TRACE_MAGIC = b"HBTR"
+TRACE_VERSION = 1
+TRACE_CLOSED = 1
+
+_HEADER = struct.Struct("<4sHHII6Q")
+_LINE = struct.Struct("<24sII32s")
+# data_size alone, the recorder updates it after every batch
+_DATA_SIZE = struct.Struct("<Q")
+_DATA_SIZE_OFFSET = 32
+
+TraceLine = collections.namedtuple('TraceLine', ['chip', 'offset', 'name'])
+TraceEvent = collections.namedtuple('TraceEvent',
+                                    ['timestamp_ns', 'line', 'level'])
+
+
+def _trace_open(pin_info, pin_names, path, debounce_us):
+    _check_native()
+    return _native.TraceRecorder([(pin_info[x].gpio_chip,
+                                   pin_info[x].gpio_offset)
+                                  for x in pin_names],
+                                 path, [str(x) for x in pin_names],
+                                 debounce_us)
+
+
+def _trace_close(pin_info, pin_name):
+    if pin_info[pin_name].trace is not None:
+        pin_info[pin_name].trace.close()
+        pin_info[pin_name].trace = None
+
+
+def _cstr(raw):
+    return raw.split(b"\0", 1)[0].decode("utf-8", "replace")
+
+
+class TraceReader(object):
+    # Iterating yields TraceEvent(timestamp_ns, line, level) in file order,
+    # line indexes self.lines and timestamps are CLOCK_MONOTONIC.
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            self._parse()
+        except Exception:
+            self._map.close()
+            raise
+
+    def _parse(self):
+        if len(self._map) < _HEADER.size:
+            raise ValueError("Not a GPIO trace file")
+        (magic, version, num_lines, self.header_size, _,
+         self.start_ns, self.start_realtime_ns, _, _, _,
+         levels) = _HEADER.unpack_from(self._map, 0)
+        if magic != TRACE_MAGIC:
+            raise ValueError("Not a GPIO trace file")
+        if version != TRACE_VERSION:
+            raise ValueError("Unsupported trace version " + str(version))
+        if self.header_size > len(self._map) or \
+                self.header_size < _HEADER.size + num_lines * _LINE.size:
+            raise ValueError("Truncated trace file")
+
+        self.lines = []
+        for i in range(num_lines):
+            chip, offset, _, name = _LINE.unpack_from(
+                self._map, _HEADER.size + i * _LINE.size)
+            self.lines.append(TraceLine(_cstr(chip), offset, _cstr(name)))
+        self.levels = [(levels >> i) & 1 for i in range(num_lines)]
+
+    def _header(self):
+        return _HEADER.unpack_from(self._map, 0)
+
+    @property
+    def closed(self):
+        # False while the recorder runs, or if it never finished the file
+        return bool(self._header()[4] & TRACE_CLOSED)
+
+    @property
+    def events(self):
+        return self._header()[8]
+
+    @property
+    def missed(self):
+        return self._header()[9]
+
+    def data_size(self):
+        # bytes past data_size are not committed yet, and the mapping only
+        # covers the file as it was when it was opened
+        size = _DATA_SIZE.unpack_from(self._map, _DATA_SIZE_OFFSET)[0]
+        return min(size, len(self._map) - self.header_size)
+
+    def __iter__(self):
+        data = self._map
+        pos = self.header_size
+        end = pos + self.data_size()
+        ts = self.start_ns
+        while pos < end:
+            value = 0
+            shift = 0
+            while True:
+                if pos == end:
+                    # cut by the end of the mapping of a live trace
+                    return
+                byte = data[pos]
+                pos += 1
+                value |= (byte & 0x7f) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            zz = value >> 7
+            ts += (zz >> 1) ^ -(zz & 1)
+            yield TraceEvent(ts, (value >> 1) & 0x3f, value & 1)
+
+    def close(self):
+        self._map.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
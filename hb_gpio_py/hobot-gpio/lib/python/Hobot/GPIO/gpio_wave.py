@@ -0,0 +1,49 @@
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+from Hobot.GPIO.gpio_capture import _native, _check_native
+
+SYSFS_CPU_ISOLATED = '/sys/devices/system/cpu/isolated'
+
+
+def _isolated_cpu():
+    # Play on the first core reserved with isolcpus=, if any
+    try:
+        with open(SYSFS_CPU_ISOLATED, 'r') as f:
+            isolated = f.read().strip()
+    except (IOError, OSError):
+        return -1
+    if not isolated:
+        return -1
+    return int(isolated.split(',')[0].split('-')[0])
+
+
+def _wave_open(pin_info, pin_names):
+    _check_native()
+    return _native.Wave([(pin_info[x].gpio_chip, pin_info[x].gpio_offset)
+                         for x in pin_names])
+
+
+def _wave_play(wave, repeat, cpu):
+    if cpu is None:
+        cpu = _isolated_cpu()
+    return wave.play(repeat, cpu)
+
+
+def _wave_close(pin_info, pin_name):
+    if pin_info[pin_name].wave is not None:
+        pin_info[pin_name].wave.close()
+        pin_info[pin_name].wave = None
@@ -14,7 +14,22 @@
 # limitations under the License.
 ################################################################################
 
-from setuptools import setup
+from setuptools import setup, Extension
+
+# Native libgpiod backend, optional so that the sysfs API still installs
+# on systems without libgpiod v2
+native_module = Extension('Hobot.GPIO._native',
+                          sources = ['lib/c/hb_native.c',
+                                     'lib/c/hb_capture.c',
+                                     'lib/c/hb_wave.c',
+                                     'lib/c/hb_softpwm.c',
+                                     'lib/c/hb_bitbang.c',
+                                     'lib/c/hb_edges.c',
+                                     'lib/c/hb_sampler.c',
+                                     'lib/c/hb_trace.c',
+                                     'lib/c/hb_line.c'],
+                          libraries = ['gpiod', 'pthread', 'm'],
+                          optional = True)
 
 classifiers = ['Operating System :: POSIX :: Linux',
                'License :: OSI Approved :: MIT License',
@@ -38,5 +53,6 @@ setup(name                          = 'Hobot.GPIO',
       package_dir                   = {'': 'lib/python/'},
       packages                      = ['Hobot', 'Hobot.GPIO', 'RPi', 'RPi.GPIO'],
       package_data                  = {'Hobot.GPIO': []},
+      ext_modules                   = [native_module],
       include_package_data          = True,
 )
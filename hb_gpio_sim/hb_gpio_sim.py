@@ -0,0 +1,358 @@
+#!/usr/bin/env python3
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# User-space stand-in for the kernel side of a board, for running the tools
+# of this repo on machines without RDK hardware.
+#
+# The simulator fabricates, under a root directory, the nodes the tools read:
+# /sys/class/socinfo, /sys/class/gpio, the gpio and pwm controllers under
+# /sys/devices/platform, /sys/kernel/debug/gpio and the iomuxc files under
+# /sys/kernel/debug/pinctrl. It then plays the kernel: writes to the gpio
+# and pwm export/unexport files create and remove the matching nodes, and
+# input lines can be toggled on a schedule.
+#
+# Point the tools at the tree with HOBOT_IO_ROOT=<root>. The layout comes
+# from hb_pin_db/pins.json. Controller bases are derived from the pins of
+# the board, so line offsets do not match the silicon. Character devices
+# are not simulated, use the kernel's gpio-sim for those.
+
+import os
+import sys
+import time
+import uuid
+import json
+import errno
+import select
+import shutil
+import ctypes
+import ctypes.util
+import argparse
+import threading
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+DATABASE = os.path.join(HERE, '..', 'hb_pin_db', 'pins.json')
+
+IN_NONBLOCK = 0o4000
+IN_CLOEXEC = 0o2000000
+IN_CLOSE_WRITE = 0x00000008
+
+GPIO_ATTRS = (('value', '0\n'), ('direction', 'in\n'), ('edge', 'none\n'),
+              ('active_low', '0\n'))
+PWM_ATTRS = (('period', '0\n'), ('duty_cycle', '0\n'), ('enable', '0\n'),
+             ('polarity', 'normal\n'))
+
+
+def _write(path, data=''):
+    d = os.path.dirname(path)
+    if not os.path.isdir(d):
+        os.makedirs(d)
+    with open(path, 'w') as f:
+        f.write(data)
+
+
+def load_board(database, name=None, board_id=None):
+    with open(database, 'r') as f:
+        db = json.load(f)
+    for board in db['boards']:
+        ids = [int(x, 16) for x in board['board_ids']]
+        if (board_id is not None and board_id in ids) or \
+                (board_id is None and (name is None or name == board['name'])):
+            controllers = [c for c in db['controllers']
+                           if c['soc'] == board['soc']]
+            return board, ids[0] if board_id is None else board_id, controllers
+    raise ValueError('no board %s in %s' % (name or hex(board_id), database))
+
+
+class Simulator(object):
+    def __init__(self, root, board=None, board_id=None, database=DATABASE):
+        self.root = os.path.abspath(root)
+        self.board, self.board_id, self.controllers = \
+            load_board(database, board, board_id)
+        self.chips = self._layout_chips()
+        self.pwm_chips = sorted(set(p['pwm_chip'] for p in self.board['pins']
+                                    if p['pwm_chip']))
+        self.edges = []
+        self.lock = threading.Lock()
+        self.thread = None
+        self.running = False
+        self.libc = None
+        self.notify = None
+        self.watches = {}
+
+    def _layout_chips(self):
+        # (name, base, ngpio, chardev number) of each gpio controller
+        ids = {}
+        for pin in self.board['pins']:
+            ids.setdefault(pin['gpio_chip'], []).append(pin['gpio'])
+        chips = []
+        for number, name in enumerate(sorted(ids, key=lambda x: min(ids[x]))):
+            base = min(ids[name])
+            chips.append((name, base, max(ids[name]) - base + 1, number))
+        return chips
+
+    def path(self, path):
+        return self.root + path
+
+    def gpio_node(self, gpio):
+        return self.path('/sys/class/gpio/gpio%d' % gpio)
+
+    def pwm_chip_dir(self, pwm_chip):
+        return self.path('/sys/devices/platform/%s/pwm/pwmchip0' % pwm_chip)
+
+    # tree
+    def build(self):
+        if os.path.isdir(self.root):
+            shutil.rmtree(self.path('/sys'), ignore_errors=True)
+        _write(self.path('/sys/class/socinfo/board_id'), '%x\n' % self.board_id)
+        _write(self.path('/sys/class/socinfo/soc_name'), self.board['soc'] + '\n')
+        _write(self.path('/proc/sys/kernel/random/boot_id'),
+               str(uuid.uuid4()) + '\n')
+        for d in ('/run/hobot-gpio', '/dev'):
+            if not os.path.isdir(self.path(d)):
+                os.makedirs(self.path(d))
+        if os.path.exists(self.path('/run/hobot-gpio/pinmap.json')):
+            os.remove(self.path('/run/hobot-gpio/pinmap.json'))
+
+        _write(self.path('/sys/class/gpio/export'))
+        _write(self.path('/sys/class/gpio/unexport'))
+        debug_gpio = []
+        for name, base, ngpio, number in self.chips:
+            chip_dir = self.path('/sys/devices/platform/' + name)
+            node = '%s/gpio/gpiochip%d/' % (chip_dir, base)
+            _write(node + 'base', '%d\n' % base)
+            _write(node + 'ngpio', '%d\n' % ngpio)
+            _write(node + 'label', os.path.basename(name) + '\n')
+            _write('%s/gpiochip%d/dev' % (chip_dir, number), '254:%d\n' % number)
+            debug_gpio.append('gpiochip%d: GPIOs %d-%d, parent: platform/%s, '
+                              '%s:\n\n' % (number, base, base + ngpio - 1,
+                                           os.path.basename(name),
+                                           os.path.basename(name)))
+        _write(self.path('/sys/kernel/debug/gpio'), ''.join(debug_gpio))
+
+        for pwm_chip in self.pwm_chips:
+            chip_dir = self.pwm_chip_dir(pwm_chip)
+            npwm = max(p['pwm'] for p in self.board['pins']
+                       if p['pwm_chip'] == pwm_chip) + 1
+            _write(chip_dir + '/export')
+            _write(chip_dir + '/unexport')
+            _write(chip_dir + '/npwm', '%d\n' % max(npwm, 2))
+
+        self._build_pinctrl()
+
+    def _build_pinctrl(self):
+        # one pins and pinmux-pins file per iomuxc, listing the lines of the
+        # simulated controllers it muxes
+        chips = dict((os.path.basename(c[0]), c) for c in self.chips)
+        files = {}
+        for ctrl in self.controllers:
+            if ctrl['gpio'] not in chips:
+                continue
+            pins, pinmux = files.setdefault(ctrl['iomuxc'], ([], []))
+            for line in range(chips[ctrl['gpio']][2]):
+                index = len(pins)
+                name = '%s_pin%d' % (ctrl['bank'], line)
+                pins.append('pin %d (%s) %d:%s 0x0 0x0\n' %
+                            (index, name, line, ctrl['gpio']))
+                pinmux.append('pin %d (%s): UNCLAIMED\n' % (index, name))
+        for iomuxc, (pins, pinmux) in files.items():
+            pinctrl = self.path('/sys/kernel/debug/pinctrl/' + iomuxc)
+            _write(pinctrl + '/pins', 'registered pins: %d\n' % len(pins) +
+                   ''.join(pins))
+            _write(pinctrl + '/pinmux-pins', 'Pinmux settings per pin\n'
+                   'Format: pin (name): mux_owner gpio_owner hog?\n' +
+                   ''.join(pinmux))
+
+    # lines
+    def set_level(self, gpio, level):
+        # written in place, never truncated, so a concurrent reader always
+        # sees a whole value
+        try:
+            fd = os.open(self.gpio_node(gpio) + '/value', os.O_WRONLY)
+        except OSError:
+            return False
+        try:
+            os.write(fd, b'1\n' if level else b'0\n')
+        finally:
+            os.close(fd)
+        return True
+
+    def get_level(self, gpio):
+        with open(self.gpio_node(gpio) + '/value', 'r') as f:
+            return int(f.read().strip() or 0)
+
+    def add_edges(self, gpio, frequency):
+        # square wave of the given frequency on an exported input line
+        half_period = 0.5 / frequency
+        with self.lock:
+            self.edges.append([gpio, half_period, time.time() + half_period])
+
+    # kernel side of export/unexport
+    def _export_gpio(self, data):
+        for gpio in data.split():
+            node = self.gpio_node(int(gpio))
+            if not os.path.isdir(node):
+                for attr, value in GPIO_ATTRS:
+                    _write(node + '/' + attr, value)
+
+    def _unexport_gpio(self, data):
+        for gpio in data.split():
+            shutil.rmtree(self.gpio_node(int(gpio)), ignore_errors=True)
+
+    def _export_pwm(self, chip_dir, data):
+        for pwm in data.split():
+            node = '%s/pwm%d' % (chip_dir, int(pwm))
+            if not os.path.isdir(node):
+                for attr, value in PWM_ATTRS:
+                    _write(node + '/' + attr, value)
+
+    def _unexport_pwm(self, chip_dir, data):
+        for pwm in data.split():
+            shutil.rmtree('%s/pwm%d' % (chip_dir, int(pwm)), ignore_errors=True)
+
+    def _watch(self, path, handler):
+        wd = self.libc.inotify_add_watch(self.notify, path.encode(),
+                                         IN_CLOSE_WRITE)
+        if wd < 0:
+            raise OSError(ctypes.get_errno(), 'inotify_add_watch ' + path)
+        self.watches[wd] = (path, handler)
+
+    def _open_watches(self):
+        self.libc = ctypes.CDLL(ctypes.util.find_library('c'), use_errno=True)
+        self.notify = self.libc.inotify_init1(IN_NONBLOCK | IN_CLOEXEC)
+        if self.notify < 0:
+            raise OSError(ctypes.get_errno(), 'inotify_init1')
+        self._watch(self.path('/sys/class/gpio/export'), self._export_gpio)
+        self._watch(self.path('/sys/class/gpio/unexport'), self._unexport_gpio)
+        for pwm_chip in self.pwm_chips:
+            chip_dir = self.pwm_chip_dir(pwm_chip)
+            self._watch(chip_dir + '/export',
+                        lambda data, d=chip_dir: self._export_pwm(d, data))
+            self._watch(chip_dir + '/unexport',
+                        lambda data, d=chip_dir: self._unexport_pwm(d, data))
+
+    def _dispatch(self):
+        try:
+            buf = os.read(self.notify, 4096)
+        except OSError as exc:
+            if exc.errno == errno.EAGAIN:
+                return
+            raise
+        offset = 0
+        while offset + 16 <= len(buf):
+            wd = ctypes.c_int.from_buffer_copy(buf, offset).value
+            name_len = ctypes.c_uint.from_buffer_copy(buf, offset + 12).value
+            offset += 16 + name_len
+            if wd not in self.watches:
+                continue
+            path, handler = self.watches[wd]
+            # writers open with O_TRUNC, so the file holds the last write.
+            # Truncating it here would race with the next writer, and the
+            # close would queue an event of our own; export and unexport
+            # are idempotent, handling a value twice is harmless.
+            with open(path, 'r') as f:
+                data = f.read()
+            if data.strip():
+                try:
+                    handler(data)
+                except ValueError:
+                    pass
+
+    def _toggle_due(self, now):
+        timeout = 0.5
+        with self.lock:
+            for edge in self.edges:
+                gpio, half_period, due = edge
+                if due <= now:
+                    if os.path.exists(self.gpio_node(gpio)):
+                        self.set_level(gpio, not self.get_level(gpio))
+                    edge[2] = max(due + half_period, now)
+                timeout = min(timeout, edge[2] - now)
+        return max(timeout, 0)
+
+    def run(self):
+        if self.notify is None:
+            self._open_watches()
+        self.running = True
+        while self.running:
+            timeout = self._toggle_due(time.time())
+            try:
+                readable = select.select([self.notify], [], [], timeout)[0]
+            except (OSError, select.error) as exc:
+                if exc.args[0] == errno.EINTR:
+                    continue
+                raise
+            if readable:
+                self._dispatch()
+
+    def start(self):
+        self._open_watches()
+        self.thread = threading.Thread(target=self.run)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def stop(self):
+        self.running = False
+        if self.thread is not None:
+            self.thread.join()
+            self.thread = None
+        if self.notify is not None:
+            os.close(self.notify)
+            self.notify = None
+            self.watches = {}
+
+
+def parse_edge(text):
+    gpio, frequency = text.split(':')
+    return int(gpio), float(frequency)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Simulate the sysfs and debugfs nodes of an RDK board')
+    parser.add_argument('root', help='directory to build the tree in')
+    parser.add_argument('-b', '--board', help='board name, e.g. RDK_X5')
+    parser.add_argument('-i', '--board-id', type=lambda x: int(x, 16),
+                        help='board id in hex, e.g. 0x301')
+    parser.add_argument('-e', '--edge', action='append', type=parse_edge,
+                        default=[], metavar='GPIO:HZ',
+                        help='toggle sysfs gpio GPIO at HZ once exported')
+    parser.add_argument('--database', default=DATABASE)
+    parser.add_argument('--build-only', action='store_true',
+                        help='fabricate the tree and exit')
+    args = parser.parse_args()
+
+    try:
+        sim = Simulator(args.root, args.board, args.board_id, args.database)
+    except (IOError, ValueError) as exc:
+        sys.stderr.write('%s\n' % exc)
+        return 1
+    sim.build()
+    sys.stderr.write('%s (0x%x) in %s, use HOBOT_IO_ROOT=%s\n' %
+                     (sim.board['name'], sim.board_id, sim.root, sim.root))
+    if args.build_only:
+        return 0
+    for gpio, frequency in args.edge:
+        sim.add_edges(gpio, frequency)
+    try:
+        sim.run()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,277 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hb_trace.h"
+
+/*
+ * Prints the edge trace files written by Hobot.GPIO's TraceRecorder. The
+ * file is mapped and decoded in place, a trace that is still being
+ * recorded is printed up to the last batch the recorder committed.
+ */
+
+#define NSEC_PER_SEC	((uint64_t)1000000000)
+
+struct line_summary {
+	uint64_t rising;
+	uint64_t falling;
+	uint64_t last_ns;
+	uint64_t min_high_ns;
+	uint64_t min_low_ns;
+	int level;
+};
+
+static const char *progname = "hb_gpio_trace";
+
+static void die(const char *fmt, ...)
+{
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "%s: ", progname);
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, "\n");
+	va_end(va);
+
+	exit(EXIT_FAILURE);
+}
+
+static void die_perror(const char *fmt, ...)
+{
+	int err = errno;
+	va_list va;
+
+	va_start(va, fmt);
+	fprintf(stderr, "%s: ", progname);
+	vfprintf(stderr, fmt, va);
+	fprintf(stderr, ": %s\n", strerror(err));
+	va_end(va);
+
+	exit(EXIT_FAILURE);
+}
+
+static void print_help(void)
+{
+	printf("Usage: %s [OPTIONS] <file>\n", progname);
+	printf("\n");
+	printf("Print a GPIO edge trace recorded by Hobot.GPIO.\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  -s, --summary\t\tprint edge counts and shortest pulses per line\n");
+	printf("  -r, --realtime\tprint wall clock times instead of seconds since\n");
+	printf("\t\t\tthe start of the trace\n");
+	printf("  -h, --help\t\tdisplay this help and exit\n");
+}
+
+static void print_time(uint64_t ns, const struct hb_trace_header *header,
+		       bool realtime)
+{
+	char buf[32];
+	struct tm tm;
+	time_t sec;
+
+	if (!realtime) {
+		ns -= header->start_ns;
+		printf("%" PRIu64 ".%09" PRIu64, ns / NSEC_PER_SEC,
+		       ns % NSEC_PER_SEC);
+		return;
+	}
+
+	ns += header->start_realtime_ns - header->start_ns;
+	sec = ns / NSEC_PER_SEC;
+	localtime_r(&sec, &tm);
+	strftime(buf, sizeof(buf), "%F %T", &tm);
+	printf("%s.%09" PRIu64, buf, ns % NSEC_PER_SEC);
+}
+
+static void print_pulse(uint64_t ns)
+{
+	if (ns == UINT64_MAX)
+		printf("%14s", "-");
+	else
+		printf("%11" PRIu64 " ns", ns);
+}
+
+static void summary_edge(struct line_summary *sum, uint64_t ts, int rising)
+{
+	uint64_t width = ts - sum->last_ns;
+
+	/* the first pulse started before the trace, its width is unknown */
+	if (sum->rising + sum->falling) {
+		if (!rising && sum->level && width < sum->min_high_ns)
+			sum->min_high_ns = width;
+		if (rising && !sum->level && width < sum->min_low_ns)
+			sum->min_low_ns = width;
+	}
+
+	if (rising)
+		sum->rising++;
+	else
+		sum->falling++;
+	sum->last_ns = ts;
+	sum->level = rising;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct option longopts[] = {
+		{ "summary",	no_argument,	NULL,	's' },
+		{ "realtime",	no_argument,	NULL,	'r' },
+		{ "help",	no_argument,	NULL,	'h' },
+		{ NULL,		0,		NULL,	0 },
+	};
+	struct line_summary sums[HB_TRACE_MAX_LINES];
+	const struct hb_trace_header *header;
+	const struct hb_trace_line *table;
+	bool summary = false, realtime = false;
+	const uint8_t *map, *p, *end;
+	unsigned int line, i;
+	uint64_t data_size;
+	int64_t delta;
+	struct stat st;
+	int optc, fd, rising;
+	uint64_t ts;
+	size_t len;
+
+	for (;;) {
+		optc = getopt_long(argc, argv, "srh", longopts, NULL);
+		if (optc < 0)
+			break;
+
+		switch (optc) {
+		case 's':
+			summary = true;
+			break;
+		case 'r':
+			realtime = true;
+			break;
+		case 'h':
+			print_help();
+			exit(EXIT_SUCCESS);
+		default:
+			fprintf(stderr, "try %s --help\n", progname);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if (optind != argc - 1)
+		die("exactly one trace file expected");
+
+	fd = open(argv[optind], O_RDONLY);
+	if (fd < 0)
+		die_perror("unable to open '%s'", argv[optind]);
+	if (fstat(fd, &st))
+		die_perror("unable to stat '%s'", argv[optind]);
+	if ((size_t)st.st_size < sizeof(*header))
+		die("'%s' is not a GPIO trace", argv[optind]);
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		die_perror("unable to map '%s'", argv[optind]);
+	close(fd);
+
+	header = (const struct hb_trace_header *)map;
+	table = (const struct hb_trace_line *)(header + 1);
+	if (memcmp(header->magic, HB_TRACE_MAGIC, sizeof(header->magic)))
+		die("'%s' is not a GPIO trace", argv[optind]);
+	if (header->version != HB_TRACE_VERSION)
+		die("unsupported trace version %u", header->version);
+	if (header->num_lines > HB_TRACE_MAX_LINES ||
+	    header->header_size < sizeof(*header) +
+				  header->num_lines * sizeof(*table) ||
+	    header->header_size > (size_t)st.st_size)
+		die("'%s' is truncated", argv[optind]);
+
+	/* bytes past data_size are not committed, the file may be live */
+	data_size = __atomic_load_n(&header->data_size, __ATOMIC_ACQUIRE);
+	len = st.st_size - header->header_size;
+	if (data_size < len)
+		len = data_size;
+
+	printf("started   ");
+	print_time(header->start_ns, header, true);
+	printf("\n");
+	printf("state     %s\n", header->flags & HB_TRACE_CLOSED ?
+	       "closed" : "recording or interrupted");
+	printf("edges     %" PRIu64 ", %" PRIu64 " dropped by the kernel\n",
+	       header->events, header->missed);
+	for (line = 0; line < header->num_lines; line++) {
+		printf("line %-4u %-.24s:%u %-.32s, starts %s\n", line,
+		       table[line].chip, table[line].offset, table[line].name,
+		       (header->levels >> line) & 1 ? "high" : "low");
+		memset(&sums[line], 0, sizeof(sums[line]));
+		sums[line].last_ns = header->start_ns;
+		sums[line].min_high_ns = UINT64_MAX;
+		sums[line].min_low_ns = UINT64_MAX;
+		sums[line].level = (header->levels >> line) & 1;
+	}
+	printf("\n");
+
+	ts = header->start_ns;
+	p = map + header->header_size;
+	end = p + len;
+	while (p < end) {
+		i = hb_trace_decode(p, end, &delta, &line, &rising);
+		if (!i) {
+			if (len == data_size)
+				fprintf(stderr, "%s: bad record at offset %zu\n",
+					progname, (size_t)(p - map));
+			break;
+		}
+		p += i;
+		ts += delta;
+		if (line >= header->num_lines) {
+			fprintf(stderr, "%s: bad line %u at offset %zu\n",
+				progname, line, (size_t)(p - map));
+			break;
+		}
+
+		if (summary) {
+			summary_edge(&sums[line], ts, rising);
+			continue;
+		}
+		print_time(ts, header, realtime);
+		printf("  %-4u %-12.32s %s\n", line, table[line].name,
+		       rising ? "rising" : "falling");
+	}
+
+	if (summary) {
+		printf("%-4s %-12s %12s %12s %14s %14s\n", "line", "name",
+		       "rising", "falling", "shortest high", "shortest low");
+		for (line = 0; line < header->num_lines; line++) {
+			printf("%-4u %-12.32s %12" PRIu64 " %12" PRIu64 " ",
+			       line, table[line].name, sums[line].rising,
+			       sums[line].falling);
+			print_pulse(sums[line].min_high_ns);
+			printf(" ");
+			print_pulse(sums[line].min_low_ns);
+			printf("\n");
+		}
+	}
+
+	munmap((void *)map, st.st_size);
+
+	return 0;
+}
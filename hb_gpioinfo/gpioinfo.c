@@ -17,6 +17,7 @@
 // SPDX-FileCopyrightText: 2022 Kent Gibson <warthog618@gmail.com>
 
 #include <getopt.h>
+#include <limits.h>
 #include <gpiod.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -24,37 +25,30 @@
 #include <string.h>
 
 #include "tools-common.h"
+#include "pin_db.h"
+#include "pininfo.h"
 
 struct config {
+	bool audit;
+	const char *snapshot;
+	const char *diff;
 	bool by_name;
 	bool strict;
 	bool unquoted_strings;
 	const char *chip_id;
 };
 
-#define PLATEFORM_HOBOTX5_GPIOPARSE
 #ifdef PLATEFORM_HOBOTX5_GPIOPARSE
-typedef struct {
-	char pinname[50];       // eg: lsio_gpio_pin0
-	char controlname[20];   // eg: 34130000.gpio
-	int pinnum;             // eg: 347 //pinfistnum + linenumber
-	int linenumber;         // eg: 0
-	char currentfunc[32];   // eg: Defalut
-} PinInfo;
-
-typedef struct {
-	PinInfo pininfo[64];
-	char controlname[20];    // eg: 34130000.gpio
-	char chipname[24];       // eg: gpiochip5
-	int pinfistnum;          // eg: 347
-	char pininterval[16];    // eg: 347-363
-	int pincount;            // eg: total 17 pin
-} Chipinfo_t;
-
-#define MAX_CHIPS 10
-#define MAX_PINS 64
 Chipinfo_t chipinfo[MAX_CHIPS];
 
+// HOBOT_IO_ROOT moves the debugfs paths under another directory, e.g. a
+// tree run by hb_gpio_sim
+static const char *io_root(void) {
+	const char *root = getenv("HOBOT_IO_ROOT");
+
+	return root ? root : "";
+}
+
 // 将 pinname 转换为大写
 void convert_to_uppercase(char *str) {
 	while (*str) {
@@ -70,6 +64,50 @@ int each_convert_to_uppercase(Chipinfo_t *chipinfo,int pinCount){
 	return 0;
 }
 
+// One owner of a pinmux-pins line, "(MUX UNCLAIMED)" and the like leave it
+// empty. Returns where the next field starts.
+static const char *parse_pinmux_owner(const char *p, char *owner) {
+	const char *end;
+	int n = 0;
+
+	owner[0] = '\0';
+	while (*p == ' ')
+		p++;
+	if (*p == '(') {
+		end = strchr(p, ')');
+		return end ? end + 1 : p + strlen(p);
+	}
+	if (sscanf(p, "%31s%n", owner, &n) < 1)
+		return p + strlen(p);
+	return p + n;
+}
+
+// Mux and gpio owner, function and group of a pinmux-pins line:
+//   pin 5 (name): 34180000.i2c (GPIO UNCLAIMED) function i2c5 group i2c5_grp
+// strict controllers print "device <owner>", "GPIO <owner>" or "UNCLAIMED"
+static void parse_pinmux_owners(const char *line, PinInfo *pinInfo) {
+	const char *p = strstr(line, "): ");
+	const char *setting;
+
+	pinInfo->muxowner[0] = pinInfo->gpioowner[0] = '\0';
+	pinInfo->function[0] = pinInfo->group[0] = '\0';
+	if (!p)
+		return;
+	p += 3;
+	if (strncmp(p, "device ", 7) == 0) {
+		parse_pinmux_owner(p + 7, pinInfo->muxowner);
+	} else if (strncmp(p, "GPIO ", 5) == 0) {
+		parse_pinmux_owner(p + 5, pinInfo->gpioowner);
+	} else if (strncmp(p, "UNCLAIMED", 9) != 0) {
+		p = parse_pinmux_owner(p, pinInfo->muxowner);
+		parse_pinmux_owner(p, pinInfo->gpioowner);
+	}
+	setting = strstr(line, " function ");
+	if (setting)
+		sscanf(setting, " function %31s group %31s",
+		       pinInfo->function, pinInfo->group);
+}
+
 // Parse a single line and fill PinInfo
 int parse_pinmux_line(const char *line, PinInfo *pinInfo) {
 	char pinname[50] = {0}, controlname[50] = {0}, currentfunc[50] = {0};
@@ -101,6 +139,7 @@ int parse_pinmux_line(const char *line, PinInfo *pinInfo) {
 		return 0;
 	}
 	strcpy(pinInfo->currentfunc, currentfunc);
+	parse_pinmux_owners(line, pinInfo);
 
 	return 1;
 }
@@ -252,6 +291,11 @@ static void print_help(void)
 	printf("If no lines are specified then all lines are displayed.\n");
 	printf("\n");
 	printf("Options:\n");
+	printf("      --audit\t\treport the pinmux owner, gpio consumer and devicetree\n");
+	printf("\t\t\tstatus of every claimed pin, exit 1 on a conflict\n");
+	printf("      --snapshot <file>\tsave the muxing of every pin, - for stdout\n");
+	printf("      --diff <file>\tprint the pins muxed differently from a snapshot,\n");
+	printf("\t\t\texit 1 if there are any\n");
 	printf("      --by-name\t\ttreat lines as names even if they would parse as an offset\n");
 	printf("  -c, --chip <chip>\trestrict scope to a particular chip\n");
 	printf("  -h, --help\t\tdisplay this help and exit\n");
@@ -264,6 +308,9 @@ static void print_help(void)
 static int parse_config(int argc, char **argv, struct config *cfg)
 {
 	static const struct option longopts[] = {
+		{ "audit",	no_argument,	NULL,		'A' },
+		{ "snapshot",	required_argument, NULL,	'S' },
+		{ "diff",	required_argument, NULL,	'D' },
 		{ "by-name",	no_argument,	NULL,		'B' },
 		{ "chip",	required_argument, NULL,	'c' },
 		{ "help",	no_argument,	NULL,		'h' },
@@ -286,6 +333,15 @@ static int parse_config(int argc, char **argv, struct config *cfg)
 			break;
 
 		switch (optc) {
+			case 'A':
+				cfg->audit = true;
+				break;
+			case 'S':
+				cfg->snapshot = optarg;
+				break;
+			case 'D':
+				cfg->diff = optarg;
+				break;
 			case 'B':
 				cfg->by_name = true;
 				break;
@@ -488,104 +544,40 @@ int main(int argc, char **argv)
 	int j = 0;
 
 	// Parse the GPIO file and fill chipinfo array
-	int chipCount = parse_gpio_file("/sys/kernel/debug/gpio", chipinfo, MAX_CHIPS);
+	char gpio_path[PATH_MAX];
+
+	snprintf(gpio_path, sizeof(gpio_path), "%s/sys/kernel/debug/gpio", io_root());
+	int chipCount = parse_gpio_file(gpio_path, chipinfo, MAX_CHIPS);
 	if (chipCount < 0) {
 		return EXIT_FAILURE;
 	}
 
-	// File paths for various iomux controllers
-	const char *hsio_iomuxcfilepath = "/sys/kernel/debug/pinctrl/35050000.hsio_iomuxc/pins";
-	const char *lsio_iomuxcfilepath = "/sys/kernel/debug/pinctrl/34180000.lsio_iomuxc/pins";
-	const char *aon_iomuxcfilepath = "/sys/kernel/debug/pinctrl/31040000.aon_iomuxc/pins";
-	const char *dsp_iomuxcfilepath = "/sys/kernel/debug/pinctrl/31040014.dsp_iomuxc/pins";
-
-	// File paths for the pinmux settings of various controllers
-	const char *hsio_iomuxccpinmuxfilename = "/sys/kernel/debug/pinctrl/35050000.hsio_iomuxc/pinmux-pins";
-	const char *lsio_iomuxcpinmuxfilename = "/sys/kernel/debug/pinctrl/34180000.lsio_iomuxc/pinmux-pins";
-	const char *aon_iomuxcpinmuxfilename = "/sys/kernel/debug/pinctrl/31040000.aon_iomuxc/pinmux-pins";
-	const char *dsp_iomuxcpinmuxfilename = "/sys/kernel/debug/pinctrl/31040014.dsp_iomuxc/pinmux-pins";
-
-	// Loop over the parsed chip information and check for control names
+	// Walk the controllers known to the pin database, each one is muxed by
+	// an iomuxc whose pins and pinmux-pins live under debugfs
 	for (j = 0; j < chipCount; j++) {
+		const struct pin_db_controller *ctrl;
+		char pins_path[PATH_MAX], pinmux_path[PATH_MAX];
+		int pinCount;
 
-		if (strcmp(chipinfo[j].controlname, "35070000.gpio") == 0) {
-			int pinCount = parse_pins(hsio_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // hsio_gpio1
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(hsio_iomuxccpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
-		}
-
-		if (strcmp(chipinfo[j].controlname, "35060000.gpio") == 0) {
-			int pinCount = parse_pins(hsio_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // hsio_gpio0
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(hsio_iomuxccpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
-		}
-
-		if (strcmp(chipinfo[j].controlname, "34120000.gpio") == 0) {
-			int pinCount = parse_pins(lsio_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // lsio_gpio0
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(lsio_iomuxcpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
-		}
+		ctrl = pin_db_find_controller(chipinfo[j].controlname);
+		if (!ctrl)
+			continue;
 
-		if (strcmp(chipinfo[j].controlname, "34130000.gpio") == 0) {
-			int pinCount = parse_pins(lsio_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // lsio_gpio1
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(lsio_iomuxcpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
-		}
+		snprintf(pins_path, sizeof(pins_path), "%s" PIN_DB_PINCTRL_PATH "%s/pins",
+			 io_root(), ctrl->iomuxc);
+		snprintf(pinmux_path, sizeof(pinmux_path), "%s" PIN_DB_PINCTRL_PATH "%s/pinmux-pins",
+			 io_root(), ctrl->iomuxc);
 
-		if (strcmp(chipinfo[j].controlname, "31000000.gpio") == 0) {
-			int pinCount = parse_pins(aon_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // aon_gpio_0
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(aon_iomuxcpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
+		pinCount = parse_pins(pins_path, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
+		if (pinCount < 0) {
+			return EXIT_FAILURE;
 		}
-
-		if (strcmp(chipinfo[j].controlname, "32150000.gpio") == 0) {
-			int pinCount = parse_pins(dsp_iomuxcfilepath, chipinfo[j].pininfo, 64, &chipinfo[j]); // dsp_gpio0
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			pinCount = parse_pinmux_file(dsp_iomuxcpinmuxfilename, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
-			if (pinCount < 0) {
-				return EXIT_FAILURE;
-			}
-			sort_pin_info(chipinfo[j].pininfo, pinCount);
-			each_convert_to_uppercase(&chipinfo[j],pinCount);
+		pinCount = parse_pinmux_file(pinmux_path, chipinfo[j].pininfo, MAX_PINS, &chipinfo[j]);
+		if (pinCount < 0) {
+			return EXIT_FAILURE;
 		}
-
+		sort_pin_info(chipinfo[j].pininfo, pinCount);
+		each_convert_to_uppercase(&chipinfo[j],pinCount);
 	}
 #endif //PLATEFORM_HOBOTX5_GPIOPARSE
 
@@ -593,6 +585,16 @@ int main(int argc, char **argv)
 	argc -= i;
 	argv += i;
 
+#ifdef PLATEFORM_HOBOTX5_GPIOPARSE
+	// debugfs only, no gpio chip is opened
+	if (cfg.snapshot)
+		return pin_snapshot(chipinfo, chipCount, cfg.snapshot) < 0 ?
+			EXIT_FAILURE : EXIT_SUCCESS;
+	if (cfg.diff)
+		return pin_diff(chipinfo, chipCount, cfg.diff) != 0 ?
+			EXIT_FAILURE : EXIT_SUCCESS;
+#endif //PLATEFORM_HOBOTX5_GPIOPARSE
+
 	if (!cfg.chip_id)
 		cfg.by_name = true;
 
@@ -600,6 +602,17 @@ int main(int argc, char **argv)
 	if (cfg.chip_id && (num_chips == 0))
 		die("cannot find GPIO chip character device '%s'", cfg.chip_id);
 
+#ifdef PLATEFORM_HOBOTX5_GPIOPARSE
+	if (cfg.audit) {
+		ret = pin_audit(chipinfo, chipCount, paths, num_chips) ?
+			EXIT_FAILURE : EXIT_SUCCESS;
+		for (i = 0; i < num_chips; i++)
+			free(paths[i]);
+		free(paths);
+		return ret;
+	}
+#endif //PLATEFORM_HOBOTX5_GPIOPARSE
+
 	resolver = resolver_init(argc, argv, num_chips, cfg.strict,
 			cfg.by_name);
 
@@ -0,0 +1,277 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// hb_gpioinfo --audit: who owns each pin. Three sources are joined on the
+// pins parsed from pinmux-pins:
+//   - the gpiod consumer of the line, keyed by "gpiochipN:offset"
+//   - the devicetree status of the mux owner, keyed by its device name,
+//     "34180000.i2c" for the node i2c@34180000
+// Both are loaded into hash tables first, then every pin is looked up once.
+
+#include <dirent.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "tools-common.h"
+#include "pin_db.h"
+#include "pininfo.h"
+
+#define AUDIT_DT_PATH	"/proc/device-tree"
+
+struct audit_entry {
+	char *key;
+	char *value;
+};
+
+struct audit_map {
+	struct audit_entry *slots;
+	uint32_t mask;
+	uint32_t count;
+};
+
+static const char *io_root(void)
+{
+	const char *root = getenv("HOBOT_IO_ROOT");
+
+	return root ? root : "";
+}
+
+static void map_init(struct audit_map *map, uint32_t size)
+{
+	map->slots = calloc(size, sizeof(*map->slots));
+	if (!map->slots)
+		die("out of memory");
+	map->mask = size - 1;
+	map->count = 0;
+}
+
+static struct audit_entry *map_slot(const struct audit_map *map, const char *key)
+{
+	uint32_t i = pin_db_hash(key) & map->mask;
+
+	// linear probing, the table is never more than half full
+	while (map->slots[i].key && strcmp(map->slots[i].key, key) != 0)
+		i = (i + 1) & map->mask;
+	return &map->slots[i];
+}
+
+static void map_grow(struct audit_map *map)
+{
+	struct audit_map bigger;
+	uint32_t i;
+
+	map_init(&bigger, (map->mask + 1) * 2);
+	for (i = 0; i <= map->mask; i++) {
+		if (map->slots[i].key)
+			*map_slot(&bigger, map->slots[i].key) = map->slots[i];
+	}
+	bigger.count = map->count;
+	free(map->slots);
+	*map = bigger;
+}
+
+static void map_put(struct audit_map *map, const char *key, const char *value)
+{
+	struct audit_entry *entry;
+
+	if ((map->count + 1) * 2 > map->mask + 1)
+		map_grow(map);
+	entry = map_slot(map, key);
+	if (entry->key)
+		return;	// the first one wins, as in the kernel's device lookup
+	entry->key = strdup(key);
+	entry->value = strdup(value);
+	if (!entry->key || !entry->value)
+		die("out of memory");
+	map->count++;
+}
+
+static const char *map_get(const struct audit_map *map, const char *key)
+{
+	return map_slot(map, key)->value;
+}
+
+static void map_free(struct audit_map *map)
+{
+	uint32_t i;
+
+	for (i = 0; i <= map->mask; i++) {
+		free(map->slots[i].key);
+		free(map->slots[i].value);
+	}
+	free(map->slots);
+}
+
+static void read_status(const char *node, char *status, size_t len)
+{
+	char path[PATH_MAX];
+	size_t n = 0;
+	FILE *fp;
+
+	// no status property means okay
+	snprintf(status, len, "okay");
+	snprintf(path, sizeof(path), "%s/status", node);
+	fp = fopen(path, "r");
+	if (!fp)
+		return;
+	n = fread(status, 1, len - 1, fp);
+	fclose(fp);
+	status[n] = '\0';
+}
+
+// Device names of platform devices: "<unit address>.<node name>", or
+// "<parent>:<node name>" for a node without a unit address
+static void scan_dt(struct audit_map *map, const char *dir, const char *parent)
+{
+	char path[PATH_MAX], key[NAME_MAX * 2 + 2], status[16];
+	struct dirent *entry;
+	struct stat st;
+	const char *unit;
+	DIR *dp;
+
+	dp = opendir(dir);
+	if (!dp)
+		return;
+	while ((entry = readdir(dp)) != NULL) {
+		if (entry->d_name[0] == '.')
+			continue;
+		snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+		if (stat(path, &st) < 0 || !S_ISDIR(st.st_mode))
+			continue;
+
+		read_status(path, status, sizeof(status));
+		unit = strchr(entry->d_name, '@');
+		if (unit) {
+			snprintf(key, sizeof(key), "%s.%.*s", unit + 1,
+				 (int)(unit - entry->d_name), entry->d_name);
+			map_put(map, key, status);
+		} else {
+			map_put(map, entry->d_name, status);
+			snprintf(key, sizeof(key), "%s:%s", parent, entry->d_name);
+			map_put(map, key, status);
+		}
+		scan_dt(map, path, entry->d_name);
+	}
+	closedir(dp);
+}
+
+static void scan_consumers(struct audit_map *map, char **paths, int num_paths)
+{
+	struct gpiod_chip_info *chip_info;
+	struct gpiod_line_info *info;
+	struct gpiod_chip *chip;
+	unsigned int offset, num_lines;
+	const char *consumer;
+	char key[64];
+	int i;
+
+	for (i = 0; i < num_paths; i++) {
+		chip = gpiod_chip_open(paths[i]);
+		if (!chip) {
+			print_perror("unable to open chip '%s'", paths[i]);
+			continue;
+		}
+		chip_info = gpiod_chip_get_info(chip);
+		if (!chip_info) {
+			gpiod_chip_close(chip);
+			continue;
+		}
+		num_lines = gpiod_chip_info_get_num_lines(chip_info);
+		for (offset = 0; offset < num_lines; offset++) {
+			info = gpiod_chip_get_line_info(chip, offset);
+			if (!info)
+				continue;
+			if (gpiod_line_info_is_used(info)) {
+				consumer = gpiod_line_info_get_consumer(info);
+				snprintf(key, sizeof(key), "%s:%u",
+					 gpiod_chip_info_get_name(chip_info), offset);
+				map_put(map, key, consumer ? consumer : "used");
+			}
+			gpiod_line_info_free(info);
+		}
+		gpiod_chip_info_free(chip_info);
+		gpiod_chip_close(chip);
+	}
+}
+
+int pin_audit(Chipinfo_t *chips, int chip_count, char **paths, int num_paths)
+{
+	struct audit_map dt, consumers;
+	char dt_path[PATH_MAX], key[64], func[72];
+	const char *consumer, *status, *verdict;
+	int i, j, claimed = 0, conflicts = 0, warnings = 0;
+	bool device_mux;
+	PinInfo *pin;
+
+	map_init(&dt, 1024);
+	map_init(&consumers, 256);
+	snprintf(dt_path, sizeof(dt_path), "%s" AUDIT_DT_PATH, io_root());
+	scan_dt(&dt, dt_path, "");
+	scan_consumers(&consumers, paths, num_paths);
+
+	printf("%-22s %-5s %-18s %-24s %-18s %-18s %-10s %s\n", "[PinName]",
+	       "[Num]", "[MuxOwner]", "[Function/Group]", "[GpioOwner]",
+	       "[Consumer]", "[DtStatus]", "[Verdict]");
+	for (i = 0; i < chip_count; i++) {
+		for (j = 0; j < chips[i].pincount; j++) {
+			pin = &chips[i].pininfo[j];
+			snprintf(key, sizeof(key), "%s:%d", chips[i].chipname,
+				 pin->linenumber);
+			consumer = map_get(&consumers, key);
+			if (!pin->muxowner[0] && !pin->gpioowner[0] && !consumer)
+				continue;
+			claimed++;
+
+			status = pin->muxowner[0] ? map_get(&dt, pin->muxowner) : NULL;
+			// the gpio controller owning the mux is the gpio function
+			device_mux = pin->muxowner[0] &&
+				     strcmp(pin->muxowner, chips[i].controlname) != 0;
+			if (device_mux && (consumer || pin->gpioowner[0])) {
+				verdict = "STOLEN";
+				conflicts++;
+			} else if (status && strcmp(status, "okay") != 0 &&
+				   strcmp(status, "ok") != 0) {
+				verdict = "OWNER-DISABLED";
+				conflicts++;
+			} else if (pin->muxowner[0] && !status && dt.count) {
+				verdict = "NO-DT-NODE";
+				warnings++;
+			} else {
+				verdict = "ok";
+			}
+
+			if (pin->function[0])
+				snprintf(func, sizeof(func), "%s/%s", pin->function,
+					 pin->group);
+			else
+				snprintf(func, sizeof(func), "-");
+			printf("%-22s %-5d %-18s %-24s %-18s %-18s %-10s %s\n",
+			       pin->pinname, pin->pinnum,
+			       pin->muxowner[0] ? pin->muxowner : "-", func,
+			       pin->gpioowner[0] ? pin->gpioowner : "-",
+			       consumer ? consumer : "-", status ? status : "-",
+			       verdict);
+		}
+	}
+	printf("%d pins claimed, %d conflicts, %d warnings\n", claimed,
+	       conflicts, warnings);
+
+	map_free(&dt);
+	map_free(&consumers);
+	return conflicts;
+}
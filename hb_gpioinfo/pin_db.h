@@ -0,0 +1,72 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+#ifndef __PIN_DB_H__
+#define __PIN_DB_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#define PIN_DB_PINCTRL_PATH	"/sys/kernel/debug/pinctrl/"
+
+struct pin_db_controller {
+	const char *soc;
+	const char *gpio;	/* gpio controller, as named in debugfs */
+	const char *iomuxc;	/* pinctrl device muxing its pins */
+	const char *bank;
+};
+
+static const struct pin_db_controller pin_db_controllers[] = {
+	{ "x5", "35060000.gpio", "35050000.hsio_iomuxc", "hsio_gpio0" },
+	{ "x5", "35070000.gpio", "35050000.hsio_iomuxc", "hsio_gpio1" },
+	{ "x5", "34120000.gpio", "34180000.lsio_iomuxc", "lsio_gpio0" },
+	{ "x5", "34130000.gpio", "34180000.lsio_iomuxc", "lsio_gpio1" },
+	{ "x5", "31000000.gpio", "31040000.aon_iomuxc", "aon_gpio_0" },
+	{ "x5", "32150000.gpio", "31040014.dsp_iomuxc", "dsp_gpio0" },
+};
+
+/*
+ * Seeded FNV-1a, the seed is chosen by the generator so that every
+ * controller name lands in its own slot of pin_db_controller_slots.
+ */
+#define PIN_DB_HASH_SEED	0x811c9dc6u
+#define PIN_DB_HASH_MASK	7u
+
+static const int8_t pin_db_controller_slots[PIN_DB_HASH_MASK + 1] = {
+	1, -1, 3, 4, -1, 0, 5, 2
+};
+
+static inline uint32_t pin_db_hash(const char *s)
+{
+	uint32_t h = PIN_DB_HASH_SEED;
+
+	while (*s) {
+		h ^= (uint8_t)*s++;
+		h *= 0x01000193u;
+	}
+	return h;
+}
+
+static inline const struct pin_db_controller *pin_db_find_controller(const char *gpio)
+{
+	int slot = pin_db_controller_slots[pin_db_hash(gpio) & PIN_DB_HASH_MASK];
+
+	if (slot < 0 || strcmp(pin_db_controllers[slot].gpio, gpio) != 0)
+		return NULL;
+	return &pin_db_controllers[slot];
+}
+
+#endif /* __PIN_DB_H__ */
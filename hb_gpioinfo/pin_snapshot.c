@@ -0,0 +1,369 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// hb_gpioinfo --snapshot / --diff: the muxing of every pin, saved on a
+// golden board and compared on others. Only the mux side is kept, pin
+// name, mux owner, function and group; gpio owners and consumers change
+// with the applications running and are not drift.
+//
+// File layout, integers little endian, strings as a length byte and the
+// bytes:
+//   "HBPS" u8 version u8 nchips u16 npins u64 digest
+//   nchips x string          gpio controller names, e.g. 34120000.gpio
+//   npins x { u8 chip, u8 line, string pinname, muxowner, function, group }
+// Pins are sorted by controller name and line, so a diff is one merge pass
+// over the file and the live pins. The digest is FNV-1a 64 over the fields
+// of every pin in that order, it does not depend on the encoding and can
+// be compared across a fleet without the files.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools-common.h"
+#include "pininfo.h"
+
+#define SNAPSHOT_MAGIC		"HBPS"
+#define SNAPSHOT_VERSION	1
+#define SNAPSHOT_STR_MAX	255
+
+#define FNV64_OFFSET	0xcbf29ce484222325ull
+#define FNV64_PRIME	0x00000100000001b3ull
+
+struct snap_pin {
+	char chip[20];
+	int line;
+	char pinname[50];
+	char muxowner[32];
+	char function[32];
+	char group[32];
+};
+
+struct snap_reader {
+	FILE *fp;
+	int chip_count;
+	char chips[MAX_CHIPS][20];
+	int left;
+	uint64_t digest;
+};
+
+static uint64_t digest_bytes(uint64_t h, const char *s, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h ^= (uint8_t)s[i];
+		h *= FNV64_PRIME;
+	}
+	// and a NUL byte to end the field, h ^= 0 is a no-op
+	return h * FNV64_PRIME;
+}
+
+static uint64_t digest_pin(uint64_t h, const struct snap_pin *pin)
+{
+	char line[8];
+
+	h = digest_bytes(h, pin->chip, strlen(pin->chip));
+	h = digest_bytes(h, line, snprintf(line, sizeof(line), "%d", pin->line));
+	h = digest_bytes(h, pin->pinname, strlen(pin->pinname));
+	h = digest_bytes(h, pin->muxowner, strlen(pin->muxowner));
+	h = digest_bytes(h, pin->function, strlen(pin->function));
+	return digest_bytes(h, pin->group, strlen(pin->group));
+}
+
+static int compare_pins(const void *a, const void *b)
+{
+	const struct snap_pin *pa = a, *pb = b;
+	int ret = strcmp(pa->chip, pb->chip);
+
+	return ret ? ret : pa->line - pb->line;
+}
+
+// The live pins in snapshot order
+static struct snap_pin *live_pins(Chipinfo_t *chips, int chip_count, int *count)
+{
+	struct snap_pin *pins, *pin;
+	PinInfo *info;
+	int i, j, n = 0;
+
+	for (i = 0; i < chip_count; i++)
+		n += chips[i].pincount;
+	pins = calloc(n ? n : 1, sizeof(*pins));
+	if (!pins)
+		die("out of memory");
+	for (i = 0, n = 0; i < chip_count; i++) {
+		for (j = 0; j < chips[i].pincount; j++) {
+			info = &chips[i].pininfo[j];
+			pin = &pins[n++];
+			snprintf(pin->chip, sizeof(pin->chip), "%s", chips[i].controlname);
+			pin->line = info->linenumber;
+			snprintf(pin->pinname, sizeof(pin->pinname), "%s", info->pinname);
+			snprintf(pin->muxowner, sizeof(pin->muxowner), "%s", info->muxowner);
+			snprintf(pin->function, sizeof(pin->function), "%s", info->function);
+			snprintf(pin->group, sizeof(pin->group), "%s", info->group);
+		}
+	}
+	qsort(pins, n, sizeof(*pins), compare_pins);
+	*count = n;
+	return pins;
+}
+
+static void put_u8(FILE *fp, unsigned int v)
+{
+	fputc(v & 0xff, fp);
+}
+
+static void put_u16(FILE *fp, unsigned int v)
+{
+	put_u8(fp, v);
+	put_u8(fp, v >> 8);
+}
+
+static void put_u64(FILE *fp, uint64_t v)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		put_u8(fp, (unsigned int)(v >> (i * 8)));
+}
+
+static void put_str(FILE *fp, const char *s)
+{
+	size_t len = strlen(s);
+
+	if (len > SNAPSHOT_STR_MAX)
+		len = SNAPSHOT_STR_MAX;
+	put_u8(fp, len);
+	fwrite(s, 1, len, fp);
+}
+
+static int get_u8(FILE *fp, unsigned int *v)
+{
+	int c = fgetc(fp);
+
+	if (c == EOF)
+		return -1;
+	*v = c;
+	return 0;
+}
+
+static int get_u16(FILE *fp, unsigned int *v)
+{
+	unsigned int lo, hi;
+
+	if (get_u8(fp, &lo) < 0 || get_u8(fp, &hi) < 0)
+		return -1;
+	*v = lo | hi << 8;
+	return 0;
+}
+
+static int get_u64(FILE *fp, uint64_t *v)
+{
+	unsigned int b;
+	int i;
+
+	*v = 0;
+	for (i = 0; i < 8; i++) {
+		if (get_u8(fp, &b) < 0)
+			return -1;
+		*v |= (uint64_t)b << (i * 8);
+	}
+	return 0;
+}
+
+// Strings longer than the field are cut, as they were when parsed
+static int get_str(FILE *fp, char *s, size_t size)
+{
+	char buf[SNAPSHOT_STR_MAX + 1];
+	unsigned int len;
+
+	if (get_u8(fp, &len) < 0 || fread(buf, 1, len, fp) != len)
+		return -1;
+	buf[len] = '\0';
+	snprintf(s, size, "%s", buf);
+	return 0;
+}
+
+int pin_snapshot(Chipinfo_t *chips, int chip_count, const char *file)
+{
+	char names[MAX_CHIPS][20];
+	struct snap_pin *pins;
+	uint64_t digest = FNV64_OFFSET;
+	int i, j, count, nchips = 0;
+	FILE *fp;
+
+	pins = live_pins(chips, chip_count, &count);
+	for (i = 0; i < count; i++) {
+		digest = digest_pin(digest, &pins[i]);
+		if (!nchips || strcmp(names[nchips - 1], pins[i].chip) != 0)
+			snprintf(names[nchips++], sizeof(names[0]), "%s", pins[i].chip);
+	}
+
+	fp = strcmp(file, "-") == 0 ? stdout : fopen(file, "wb");
+	if (!fp) {
+		print_perror("unable to create '%s'", file);
+		free(pins);
+		return -1;
+	}
+	fwrite(SNAPSHOT_MAGIC, 1, 4, fp);
+	put_u8(fp, SNAPSHOT_VERSION);
+	put_u8(fp, nchips);
+	put_u16(fp, count);
+	put_u64(fp, digest);
+	for (i = 0; i < nchips; i++)
+		put_str(fp, names[i]);
+	for (i = 0, j = 0; i < count; i++) {
+		while (strcmp(names[j], pins[i].chip) != 0)
+			j++;
+		put_u8(fp, j);
+		put_u8(fp, pins[i].line);
+		put_str(fp, pins[i].pinname);
+		put_str(fp, pins[i].muxowner);
+		put_str(fp, pins[i].function);
+		put_str(fp, pins[i].group);
+	}
+	free(pins);
+	if (ferror(fp) || (fp != stdout && fclose(fp) != 0)) {
+		print_perror("unable to write '%s'", file);
+		return -1;
+	}
+	if (fp != stdout)
+		printf("%d pins, digest %016llx\n", count, (unsigned long long)digest);
+	return 0;
+}
+
+static int reader_open(struct snap_reader *rd, const char *file, uint64_t *digest)
+{
+	char magic[4];
+	unsigned int version, nchips, npins;
+	int i;
+
+	memset(rd, 0, sizeof(*rd));
+	rd->fp = fopen(file, "rb");
+	if (!rd->fp) {
+		print_perror("unable to open '%s'", file);
+		return -1;
+	}
+	if (fread(magic, 1, 4, rd->fp) != 4 || memcmp(magic, SNAPSHOT_MAGIC, 4) != 0 ||
+	    get_u8(rd->fp, &version) < 0) {
+		print_error("%s is not a pinmux snapshot", file);
+		return -1;
+	}
+	if (version != SNAPSHOT_VERSION) {
+		print_error("%s: snapshot version %u, expected %d", file, version,
+			    SNAPSHOT_VERSION);
+		return -1;
+	}
+	if (get_u8(rd->fp, &nchips) < 0 || get_u16(rd->fp, &npins) < 0 ||
+	    get_u64(rd->fp, digest) < 0 || nchips > MAX_CHIPS)
+		goto truncated;
+	for (i = 0; i < (int)nchips; i++) {
+		if (get_str(rd->fp, rd->chips[i], sizeof(rd->chips[i])) < 0)
+			goto truncated;
+	}
+	rd->chip_count = nchips;
+	rd->left = npins;
+	rd->digest = FNV64_OFFSET;
+	return 0;
+
+truncated:
+	print_error("%s is truncated", file);
+	return -1;
+}
+
+// Next pin of the file: 1, 0 at the end, -1 on a broken file
+static int reader_next(struct snap_reader *rd, struct snap_pin *pin)
+{
+	unsigned int chip, line;
+
+	if (rd->left == 0)
+		return 0;
+	if (get_u8(rd->fp, &chip) < 0 || get_u8(rd->fp, &line) < 0 ||
+	    (int)chip >= rd->chip_count ||
+	    get_str(rd->fp, pin->pinname, sizeof(pin->pinname)) < 0 ||
+	    get_str(rd->fp, pin->muxowner, sizeof(pin->muxowner)) < 0 ||
+	    get_str(rd->fp, pin->function, sizeof(pin->function)) < 0 ||
+	    get_str(rd->fp, pin->group, sizeof(pin->group)) < 0)
+		return -1;
+	snprintf(pin->chip, sizeof(pin->chip), "%s", rd->chips[chip]);
+	pin->line = line;
+	rd->left--;
+	rd->digest = digest_pin(rd->digest, pin);
+	return 1;
+}
+
+static void print_pin(char sign, const struct snap_pin *pin)
+{
+	printf("%c %-22s %s:%-3d %-18s %s%s%s\n", sign, pin->pinname, pin->chip,
+	       pin->line, pin->muxowner[0] ? pin->muxowner : "-",
+	       pin->function[0] ? pin->function : "-",
+	       pin->function[0] ? "/" : "", pin->group);
+}
+
+static int same_mux(const struct snap_pin *a, const struct snap_pin *b)
+{
+	return strcmp(a->pinname, b->pinname) == 0 &&
+	       strcmp(a->muxowner, b->muxowner) == 0 &&
+	       strcmp(a->function, b->function) == 0 &&
+	       strcmp(a->group, b->group) == 0;
+}
+
+int pin_diff(Chipinfo_t *chips, int chip_count, const char *file)
+{
+	struct snap_reader rd;
+	struct snap_pin golden, *pins;
+	uint64_t golden_digest, digest = FNV64_OFFSET;
+	int i = 0, count, cmp, have, diffs = 0, ret = -1;
+
+	if (reader_open(&rd, file, &golden_digest) < 0) {
+		if (rd.fp)
+			fclose(rd.fp);
+		return -1;
+	}
+	pins = live_pins(chips, chip_count, &count);
+
+	// "-" only in the snapshot, "+" only on this board, "<" ">" changed
+	have = reader_next(&rd, &golden);
+	while (have > 0 || i < count) {
+		if (have < 0)
+			break;
+		cmp = have == 0 ? 1 : i == count ? -1 : compare_pins(&golden, &pins[i]);
+		if (cmp < 0) {
+			print_pin('-', &golden);
+			diffs++;
+		} else if (cmp > 0) {
+			print_pin('+', &pins[i]);
+			diffs++;
+		} else if (!same_mux(&golden, &pins[i])) {
+			print_pin('<', &golden);
+			print_pin('>', &pins[i]);
+			diffs++;
+		}
+		if (cmp >= 0)
+			digest = digest_pin(digest, &pins[i++]);
+		if (cmp <= 0)
+			have = reader_next(&rd, &golden);
+	}
+	if (have < 0 || rd.digest != golden_digest) {
+		print_error("%s is corrupt", file);
+	} else {
+		printf("%d pins differ, digest %016llx, snapshot %016llx\n", diffs,
+		       (unsigned long long)digest, (unsigned long long)golden_digest);
+		ret = diffs;
+	}
+	fclose(rd.fp);
+	free(pins);
+	return ret;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef __PININFO_H__
+#define __PININFO_H__
+
+// Pin state parsed from debugfs: /sys/kernel/debug/gpio for the chips,
+// and the pins and pinmux-pins files of their iomuxc for the pins.
+
+#define PLATEFORM_HOBOTX5_GPIOPARSE
+
+typedef struct {
+	char pinname[50];       // eg: lsio_gpio_pin0
+	char controlname[20];   // eg: 34130000.gpio
+	int pinnum;             // eg: 347 //pinfistnum + linenumber
+	int linenumber;         // eg: 0
+	char currentfunc[32];   // eg: Defalut
+	char muxowner[32];      // eg: 34180000.i2c, empty when unclaimed
+	char gpioowner[32];     // eg: 34120000.gpio:390, empty when unclaimed
+	char function[32];      // eg: i2c5, empty without a mux setting
+	char group[32];         // eg: i2c5_grp
+} PinInfo;
+
+typedef struct {
+	PinInfo pininfo[64];
+	char controlname[20];    // eg: 34130000.gpio
+	char chipname[24];       // eg: gpiochip5
+	int pinfistnum;          // eg: 347
+	char pininterval[16];    // eg: 347-363
+	int pincount;            // eg: total 17 pin
+} Chipinfo_t;
+
+#define MAX_CHIPS 10
+#define MAX_PINS 64
+
+/*
+ * Joins the pinmux owners of every pin with the gpiod consumer of its line
+ * and the devicetree status of the owner, prints the result and returns
+ * the number of conflicts found.
+ */
+int pin_audit(Chipinfo_t *chips, int chip_count, char **paths, int num_paths);
+
+/*
+ * Writes the muxing of every pin to file ("-" for stdout), or compares it
+ * with the one saved in file and prints the pins that differ. pin_diff
+ * returns the number of such pins, both return -1 on an error.
+ */
+int pin_snapshot(Chipinfo_t *chips, int chip_count, const char *file);
+int pin_diff(Chipinfo_t *chips, int chip_count, const char *file);
+
+#endif /* __PININFO_H__ */
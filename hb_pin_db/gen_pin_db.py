@@ -0,0 +1,496 @@
+#!/usr/bin/env python3
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Generate the pin tables of every consumer from pins.json:
+#
+#   Hobot.GPIO       lib/python/Hobot/GPIO/gpio_pin_table.py
+#   hb_gpio_cpp      include/hobot/gpio_pins.hpp
+#   hb_gpioinfo      pin_db.h
+#   hb_board_id      board_db.h
+#   hb_dtb_tool      peri_db.h
+#
+# The generated files are committed, run this after editing pins.json.
+# With --check nothing is written and the exit status tells whether any
+# generated file is out of date.
+
+import os
+import re
+import sys
+import json
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+DATABASE = os.path.join(HERE, 'pins.json')
+
+PY_OUTPUT = os.path.join(ROOT, 'hb_gpio_py', 'hobot-gpio', 'lib', 'python',
+                         'Hobot', 'GPIO', 'gpio_pin_table.py')
+CPP_OUTPUT = os.path.join(ROOT, 'hb_gpio_cpp', 'include', 'hobot',
+                          'gpio_pins.hpp')
+C_OUTPUT = os.path.join(ROOT, 'hb_gpioinfo', 'pin_db.h')
+BOARD_OUTPUT = os.path.join(ROOT, 'hb_board_id', 'board_db.h')
+PERI_OUTPUT = os.path.join(ROOT, 'hb_dtb_tool', 'peri_db.h')
+
+# Hobot.GPIO row layout, also the order PinData.MODE_COLUMNS refers to
+ROW_FIELDS = ('gpio_chip', 'gpio', 'board', 'bcm', 'cvm', 'soc_name',
+              'pwm_chip', 'pwm')
+PY_MODES = (('BOARD', 'board'), ('BCM', 'bcm'), ('CVM', 'cvm'),
+            ('SOC', 'gpio'), ('TEGRA_SOC', 'soc_name'))
+
+FNV_OFFSET = 0x811c9dc5
+FNV_PRIME = 0x01000193
+
+PY_LICENSE = '''\
+################################################################################
+# Copyright (c) 2024,D-Robotics.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+# Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+'''
+
+C_LICENSE = '''\
+// Copyright (c) 2024，D-Robotics.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generated by hb_pin_db/gen_pin_db.py from pins.json, do not edit.
+
+'''
+
+CPP_HEADER = C_LICENSE + '''\
+#ifndef __HOBOT_GPIO_PINS_HPP__
+#define __HOBOT_GPIO_PINS_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hobot {
+namespace gpio {
+
+enum class Board : uint8_t {
+%(boards)s
+};
+
+struct PinDesc {
+	Board board;
+	uint8_t board_pin;	/* BOARD mode number */
+	uint8_t bcm;		/* BCM mode number */
+	uint16_t soc;		/* SOC mode number, the sysfs gpio id */
+	uint8_t chip;		/* index of gpio_chip in the board's chip list */
+	int8_t pwm_id;		/* -1 when the pin has no PWM channel */
+	const char *gpio_chip;	/* controller under /sys/devices/platform */
+	const char *pwm_chip;
+	const char *cvm_name;
+	const char *soc_name;
+};
+
+struct BoardDesc {
+	Board board;
+	const char *name;
+	const char *soc;	/* matched against /sys/class/socinfo/soc_name */
+	const uint16_t *board_ids;
+	std::size_t num_board_ids;
+};
+
+'''
+
+CPP_FOOTER = '''\
+inline constexpr const BoardDesc *boards[] = {
+%(boards)s
+};
+
+constexpr const BoardDesc &describe(Board board)
+{
+	return *boards[static_cast<std::size_t>(board)];
+}
+
+} /* namespace gpio */
+} /* namespace hobot */
+
+#endif /* __HOBOT_GPIO_PINS_HPP__ */
+'''
+
+C_HEADER = C_LICENSE + '''\
+#ifndef __PIN_DB_H__
+#define __PIN_DB_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#define PIN_DB_PINCTRL_PATH	"/sys/kernel/debug/pinctrl/"
+
+struct pin_db_controller {
+	const char *soc;
+	const char *gpio;	/* gpio controller, as named in debugfs */
+	const char *iomuxc;	/* pinctrl device muxing its pins */
+	const char *bank;
+};
+
+static const struct pin_db_controller pin_db_controllers[] = {
+%(controllers)s
+};
+
+/*
+ * Seeded FNV-1a, the seed is chosen by the generator so that every
+ * controller name lands in its own slot of pin_db_controller_slots.
+ */
+#define PIN_DB_HASH_SEED	0x%(seed)08xu
+#define PIN_DB_HASH_MASK	%(mask)du
+
+static const int8_t pin_db_controller_slots[PIN_DB_HASH_MASK + 1] = {
+	%(slots)s
+};
+
+static inline uint32_t pin_db_hash(const char *s)
+{
+	uint32_t h = PIN_DB_HASH_SEED;
+
+	while (*s) {
+		h ^= (uint8_t)*s++;
+		h *= 0x%(prime)08xu;
+	}
+	return h;
+}
+
+static inline const struct pin_db_controller *pin_db_find_controller(const char *gpio)
+{
+	int slot = pin_db_controller_slots[pin_db_hash(gpio) & PIN_DB_HASH_MASK];
+
+	if (slot < 0 || strcmp(pin_db_controllers[slot].gpio, gpio) != 0)
+		return NULL;
+	return &pin_db_controllers[slot];
+}
+
+#endif /* __PIN_DB_H__ */
+'''
+
+
+BOARD_HEADER = C_LICENSE + '''\
+#ifndef __BOARD_DB_H__
+#define __BOARD_DB_H__
+
+#include <stddef.h>
+#include <string.h>
+
+struct board_db_entry {
+	unsigned int board_id;	/* socinfo board_id & 0xfff */
+	const char *soc;	/* matched against socinfo soc_name */
+	const char *pin_table;	/* board name in pins.json */
+	const char *type;	/* srpi-config board type, NULL if unsupported */
+	const char *dtb;
+	const char *config;	/* peripheral list for srpi-config */
+};
+
+static const struct board_db_entry board_db[] = {
+%(entries)s
+};
+
+#define BOARD_DB_NUM (sizeof(board_db) / sizeof(board_db[0]))
+
+/* board ids are only unique within a soc, e.g. 0x504 is both X3PI and RDK_X5 */
+static inline const struct board_db_entry *board_db_find(const char *soc,
+							   unsigned int board_id)
+{
+	size_t i;
+
+	for (i = 0; i < BOARD_DB_NUM; i++) {
+		if (board_db[i].board_id == board_id &&
+		    strcmp(board_db[i].soc, soc) == 0)
+			return &board_db[i];
+	}
+	return NULL;
+}
+
+#endif /* __BOARD_DB_H__ */
+'''
+
+
+PERI_HEADER = C_LICENSE + '''\
+#ifndef __PERI_DB_H__
+#define __PERI_DB_H__
+
+/*
+ * Every peripheral a header pin can be muxed to, from the "functions" of
+ * the pins in pins.json. Peripherals are named by their dtb alias, two of
+ * them listed on the same pin cannot be enabled together.
+ */
+struct peri_db_entry {
+	const char *pin_table;	/* board name in pins.json */
+	unsigned char pin;	/* BOARD mode number */
+	const char *peri;	/* dtb alias, e.g. "serial3" */
+};
+
+static const struct peri_db_entry peri_db[] = {
+%(entries)s
+};
+
+#define PERI_DB_NUM (sizeof(peri_db) / sizeof(peri_db[0]))
+
+#endif /* __PERI_DB_H__ */
+'''
+
+
+def load_database():
+    with open(DATABASE, 'r') as f:
+        db = json.load(f)
+    for board in db['boards']:
+        board['board_ids'] = [int(x, 16) for x in board['board_ids']]
+    return db
+
+
+def fnv1a(seed, text):
+    h = seed
+    for c in text.encode():
+        h = ((h ^ c) * FNV_PRIME) & 0xffffffff
+    return h
+
+
+def perfect_hash(keys):
+    # smallest power of two table, then the first seed without collisions
+    size = 1
+    while size < len(keys):
+        size <<= 1
+    while True:
+        for seed in range(FNV_OFFSET, FNV_OFFSET + 0x10000):
+            slots = [-1] * size
+            for i, key in enumerate(keys):
+                slot = fnv1a(seed, key) & (size - 1)
+                if slots[slot] >= 0:
+                    break
+                slots[slot] = i
+            else:
+                return seed, slots
+        size <<= 1
+
+
+def c_str(value):
+    return 'nullptr' if value is None else '"%s"' % value
+
+
+def py_ident(name):
+    return name.upper()
+
+
+def gen_python(db):
+    out = [PY_LICENSE]
+    out.append('# Row layout:\n')
+    for i, field in enumerate(ROW_FIELDS):
+        out.append('# [%d]- %s\n' % (i, field))
+    out.append('\n')
+
+    for board in db['boards']:
+        name = py_ident(board['name'])
+        out.append('%s_PINS = (\n' % name)
+        for pin in board['pins']:
+            out.append('    (%s),\n' % ', '.join(repr(pin[x])
+                                                  for x in ROW_FIELDS))
+        out.append(')\n\n')
+
+        # mode key -> row; on a duplicated key the later row wins, as it did
+        # when the maps were built with a dict comprehension
+        out.append('%s_INDEX = {\n' % name)
+        for mode, field in PY_MODES:
+            index = {}
+            for i, pin in enumerate(board['pins']):
+                index[pin[field]] = i
+            out.append("    '%s': {%s},\n" % (mode, ', '.join(
+                '%r: %d' % (k, v) for k, v in index.items())))
+        out.append('}\n\n')
+
+    out.append('# soc -> board id -> (board name, rows, index)\n')
+    out.append('BOARDS = {\n')
+    for soc in sorted(set(b['soc'] for b in db['boards'])):
+        out.append("    '%s': {\n" % soc)
+        for board in db['boards']:
+            if board['soc'] != soc:
+                continue
+            name = py_ident(board['name'])
+            for board_id in board['board_ids']:
+                out.append("        0x%x: ('%s', %s_PINS, %s_INDEX),\n" %
+                           (board_id, board['name'], name, name))
+        out.append('    },\n')
+    out.append('}\n')
+    return ''.join(out)
+
+
+def emit_cpp_board(out, board):
+    name = board['name']
+    chips = []
+    for pin in board['pins']:
+        if pin['gpio_chip'] not in chips:
+            chips.append(pin['gpio_chip'])
+
+    out.append('namespace %s {\n\n' % name.lower())
+    out.append('inline constexpr uint16_t board_ids[] = { %s };\n\n' %
+               ', '.join('0x%x' % x for x in board['board_ids']))
+    out.append('inline constexpr BoardDesc board = {\n')
+    out.append('\tBoard::%s, "%s", "%s", board_ids, %d,\n};\n\n' %
+               (name, name, board['soc'], len(board['board_ids'])))
+
+    out.append('inline constexpr PinDesc pins[] = {\n')
+    for pin in board['pins']:
+        out.append('\t{ Board::%s, %d, %d, %d, %d, %d, %s, %s, %s, %s },\n' %
+                   (name, pin['board'], pin['bcm'], pin['gpio'],
+                    chips.index(pin['gpio_chip']),
+                    -1 if pin['pwm'] is None else pin['pwm'],
+                    c_str(pin['gpio_chip']), c_str(pin['pwm_chip']),
+                    c_str(pin['cvm']), c_str(pin['soc_name'])))
+    out.append('};\n\n')
+
+    # enumerators are indexes into pins[], so a lookup is a plain array access
+    for mode, field, prefix in (('BOARD', 'board', 'P'), ('BCM', 'bcm', 'GPIO'),
+                                ('SOC', 'gpio', 'GPIO')):
+        out.append('enum class %s : uint8_t {\n' % mode)
+        for index, pin in sorted(enumerate(board['pins']),
+                                 key=lambda x: x[1][field]):
+            out.append('\t%s%d = %d,\n' % (prefix, pin[field], index))
+        out.append('};\n\n')
+
+    for mode in ('BOARD', 'BCM', 'SOC'):
+        out.append('constexpr const PinDesc &describe(%s pin)\n{\n'
+                   '\treturn pins[static_cast<std::size_t>(pin)];\n}\n\n' %
+                   mode)
+
+    out.append('} /* namespace %s */\n\n' % name.lower())
+
+
+def gen_cpp(db):
+    boards = db['boards']
+    out = [CPP_HEADER % {'boards': '\n'.join('\t%s,' % b['name']
+                                             for b in boards)}]
+    for board in boards:
+        emit_cpp_board(out, board)
+    out.append(CPP_FOOTER % {'boards': '\n'.join(
+        '\t&%s::board,' % b['name'].lower() for b in boards)})
+    return ''.join(out)
+
+
+def gen_c(db):
+    controllers = db['controllers']
+    seed, slots = perfect_hash([c['gpio'] for c in controllers])
+    return C_HEADER % {
+        'controllers': '\n'.join('\t{ "%s", "%s", "%s", "%s" },' %
+                                 (c['soc'], c['gpio'], c['iomuxc'], c['bank'])
+                                 for c in controllers),
+        'seed': seed,
+        'mask': len(slots) - 1,
+        'slots': ', '.join(str(x) for x in slots),
+        'prime': FNV_PRIME,
+    }
+
+
+def c_ptr(value):
+    return 'NULL' if value is None else '"%s"' % value
+
+
+def gen_board(db):
+    entries = []
+    for board in db['boards']:
+        info = board.get('board_id_info', {})
+        for board_id in board['board_ids']:
+            extra = info.get('0x%x' % board_id, {})
+            entries.append((board['soc'], board_id, board['name'],
+                            extra.get('type'), extra.get('dtb'),
+                            extra.get('config')))
+    entries.sort(key=lambda x: (x[0], x[1]))
+    return BOARD_HEADER % {
+        'entries': '\n'.join('\t{ 0x%x, "%s", "%s", %s, %s, %s },' %
+                             (board_id, soc, name, c_ptr(btype), c_ptr(dtb),
+                              c_ptr(config))
+                             for soc, board_id, name, btype, dtb, config
+                             in entries),
+    }
+
+
+def pin_peripherals(rules, pin):
+    # "I2C5_SDA/UART3_TXD" -> ['i2c5', 'serial3']. Signals without a rule,
+    # e.g. JTG_TDO, belong to no configurable peripheral, and optional ones,
+    # e.g. UART7_RTS, are not needed for the peripheral to work.
+    peris = []
+    for signal in pin.get('functions', '').split('/'):
+        for rule in rules:
+            if not signal.startswith(rule['prefix']):
+                continue
+            unit = re.match(r'(\d+)(_|$)', signal[len(rule['prefix']):])
+            if not unit or signal.rsplit('_', 1)[-1] in rule.get('optional', ()):
+                continue
+            peri = '%s%d' % (rule['alias'],
+                             int(unit.group(1)) // rule.get('channels', 1))
+            if peri not in peris:
+                peris.append(peri)
+            break
+    return peris
+
+
+def gen_peri(db):
+    entries = []
+    for board in db['boards']:
+        rules = [r for r in db.get('peripheral_functions', [])
+                 if r['soc'] == board['soc']]
+        for pin in sorted(board['pins'], key=lambda x: x['board']):
+            for peri in pin_peripherals(rules, pin):
+                entries.append('\t{ "%s", %d, "%s" },' %
+                               (board['name'], pin['board'], peri))
+    return PERI_HEADER % {'entries': '\n'.join(entries)}
+
+
+def main():
+    check = '--check' in sys.argv[1:]
+    db = load_database()
+    stale = []
+    for path, text in ((PY_OUTPUT, gen_python(db)), (CPP_OUTPUT, gen_cpp(db)),
+                       (C_OUTPUT, gen_c(db)), (BOARD_OUTPUT, gen_board(db)),
+                       (PERI_OUTPUT, gen_peri(db))):
+        try:
+            with open(path, 'r') as f:
+                if f.read() == text:
+                    continue
+        except (IOError, OSError):
+            pass
+        stale.append(os.path.relpath(path, ROOT))
+        if not check:
+            with open(path, 'w') as f:
+                f.write(text)
+    for path in stale:
+        print('%s %s' % ('out of date:' if check else 'generated', path))
+    return 1 if check and stale else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())